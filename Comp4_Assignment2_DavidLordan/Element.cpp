@@ -44,15 +44,18 @@ Element::Element(const Element& orig) {
  * @param strElementName - The unedited tag to be used for strElementName
  * @param nLineNo - The number on which the tag was found
  */
-Element::Element(string strElementName, int nLineNo) {
+Element::Element(const string &strElementName, int nLineNo) {
 
-    //Creates a substring from the passed string up until the '>' character
-    //is found, isolating the opening tag. A 2nd substring is created from the
-    // 1st up to when any white space is found, removing any attributes which
-    // may exist in the tag and leaving only the element name. 
-    strElementName = strElementName.substr(1, strElementName.find('>') - 1);
-    strElementName = strElementName.substr(0, strElementName.find(' '));
-    strTagName = strElementName;
+    //Finds where the opening tag ends, either at the '>' character or at the
+    // first white space, whichever comes first, removing any attributes which
+    // may exist in the tag and leaving only the element name. The name is
+    // then copied straight out of the passed string. 
+    string::size_type nameEnd = strElementName.find('>');
+    string::size_type space = strElementName.find(' ');
+    if (space < nameEnd) {
+        nameEnd = space;
+    }
+    strTagName.assign(strElementName, 1, nameEnd - 1);
 
     lineNumber = nLineNo;
 
@@ -67,7 +70,7 @@ Element::~Element() {
 //The remaining functions are standard getters for each of the class's 
 //private variables, as a well as a setter for numOfAppearances.
 
-string Element::getStrElementName() const {
+const string& Element::getStrElementName() const {
     return strTagName;
 }
 
@@ -44,14 +44,14 @@ public:
      * @param strElementName - The unedited tag to be used for strElementName
      * @param nLineNo - The number on which the tag was found
      */
-    Element(string strElementName, int nLineNo);
+    Element(const string &strElementName, int nLineNo);
 
 
     //The remaining functions are standard getters for each of the class's 
     //private variables, as a well as a setter for numOfAppearances.
     int getLineNo() const;
 
-    string getStrElementName() const;
+    const string& getStrElementName() const;
 
     int getAppearances() const;
 
@@ -47,20 +47,16 @@ string trim(string str) {
  * duplicates function only worked properly if the elements had already been 
  * alphabetized. I decided to merge them to reduce interdependence and avoid
  * possible problems with using these functions in the future.  
- * @param vect - Element pointer vector. 
- * @return New vector of element-pointers with unique, alphabetized element 
- * names.
+ * The vector is sorted in place rather than copied and returned. 
+ * @param vect - Element pointer vector. Passed by ref.
  */
-vector <Element*> alphabetize_remDuplicates(vector<Element*> vect) {
-
-    string str1;
-    string str2;
+void alphabetize_remDuplicates(vector<Element*> &vect) {
 
     // This loop was the original alphabetize function.
     for (int i = 0; i < vect.size() - 1; i++) {
 
-        str1 = vect[i]->getStrElementName();
-        str2 = vect[i + 1]->getStrElementName();
+        const string &str1 = vect[i]->getStrElementName();
+        const string &str2 = vect[i + 1]->getStrElementName();
 
         if (str1.compare(str2) > 0) {
             swap(vect[i], vect[i + 1]);
@@ -73,8 +69,8 @@ vector <Element*> alphabetize_remDuplicates(vector<Element*> vect) {
     // This loop was was the original "remove duplicates" function.
     for (int i = 0; i < vect.size() - 1; i++) {
 
-        str1 = vect[i]->getStrElementName();
-        str2 = vect[i + 1]->getStrElementName();
+        const string &str1 = vect[i]->getStrElementName();
+        const string &str2 = vect[i + 1]->getStrElementName();
 
         if (str1.compare(str2) == 0) {
 
@@ -83,9 +79,6 @@ vector <Element*> alphabetize_remDuplicates(vector<Element*> vect) {
             i = -1;
         }
     }
-
-    return vect; // Returns a new vector with the element names 
-    // alphabetized and the duplicates removed. 
 }
 
 /**
@@ -146,9 +139,9 @@ int openfile(string strPath, vector<Element*> &elementVect) {
  * Displays the element names along with the line that the FIRST OCCURENCE 
  * was found on, along with the number of occurrences.
  * @param elementVect - The vector of Element object pointers whose content is
- * displayed.
+ * displayed. Passed by const ref.
  */
-void displayElements(vector<Element*> elementVect) {
+void displayElements(const vector<Element*> &elementVect) {
 
     for (int i = 0; i < elementVect.size(); i++) {
         cout << "Element \"" << elementVect[i]->getStrElementName()
@@ -187,7 +180,7 @@ int main(int argc, char** argv) {
     //Alphabetizes and removes the duplicates of element names with elementVect.
     //This was originally two separate functions, but as one was dependent on 
     //the other, they were merged.
-    elementVect = alphabetize_remDuplicates(elementVect);
+    alphabetize_remDuplicates(elementVect);
 
     //Displays the elements names along with their line numbers and number of
     //occurrences. Each object is then deleted from the vector.
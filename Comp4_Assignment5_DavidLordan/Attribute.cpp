@@ -11,6 +11,7 @@
  * getter methods to set or retrieve those variables. 
  */
 
+#include <utility>
 #include "Attribute.h"
 
 /**
@@ -37,28 +38,28 @@ Attribute::~Attribute() {
 
 /**
  * Custom constructor. Sets the attribute name and value to the passed parameters.
- * Called whenever a new attribute object is created. 
+ * Called whenever a new attribute object is created. The strings are moved
+ * into the object rather than copied. 
  * @param newName - The name extracted from an XML element opening tag. 
  * @param newValue - The value extracted from an XML element opening tag. 
  */
-Attribute::Attribute(string newName, string newValue) {
-    name = newName;
-    value = newValue;
+Attribute::Attribute(string newName, string newValue)
+: name(move(newName)), value(move(newValue)) {
 }
 
 /**
  * Standard getter for the attribute name. Used when displaying the element tree. 
- * @return 
+ * @return name - The attribute object's name, returned by const reference. 
  */
-string Attribute::getAttName() {
+const string& Attribute::getAttName() const {
     return name;
 }
 
 /**
  * Standard getter for the attribute value. Used when displaying the element tree.
- * @return value - The attribute object's value. 
+ * @return value - The attribute object's value, returned by const reference. 
  */
-string Attribute::getAttValue() {
+const string& Attribute::getAttValue() const {
     return value;
 }
 
@@ -67,7 +68,7 @@ string Attribute::getAttValue() {
  * @param newName - Extracted attribute name from an XML element opening tag. 
  */
 void Attribute::setAttName(string newName) {
-    name = newName;
+    name = move(newName);
 }
 
 /**
@@ -75,5 +76,5 @@ void Attribute::setAttName(string newName) {
  * @param newValue - Extracted attribute value from an XML element opening tag. 
  */
 void Attribute::setAttValue(string newValue) {
-    value = newValue;
+    value = move(newValue);
 }
\ No newline at end of file
@@ -39,7 +39,8 @@ public:
 
     /**
      * Custom constructor. Sets the attribute name and value to the passed parameters.
-     * Called whenever a new attribute object is created. 
+     * Called whenever a new attribute object is created. The strings are moved
+     * into the object rather than copied. 
      * @param newName - The name extracted from an XML element opening tag. 
      * @param newValue - The value extracted from an XML element opening tag. 
      */
@@ -59,15 +60,15 @@ public:
 
     /**
      * Standard getter for the attribute name. Used when displaying the element tree. 
-     * @return 
+     * @return name - The attribute object's name, returned by const reference. 
      */
-    string getAttName();
+    const string& getAttName() const;
 
     /**
      * Standard getter for the attribute value. Used when displaying the element tree.
-     * @return value - The attribute object's value. 
+     * @return value - The attribute object's value, returned by const reference. 
      */
-    string getAttValue();
+    const string& getAttValue() const;
 
 private:
 
@@ -0,0 +1,345 @@
+/* File:   BlockReader.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the BlockReader class, which is used to read an
+ * XML file line by line in place of 'getline' on an ifstream. The file is read
+ * in large blocks by a background thread into two buffers. While the parser is
+ * working through the lines of one buffer, the next block is already being read
+ * into the other, so that reading from the disk and parsing happen at the same time.
+ * Compressed files are decompressed by the background thread as they are read.
+ */
+
+#include <cstring>
+#include "BlockReader.h"
+
+/** The number of compressed bytes read from the file at a time. */
+static const size_t PACKED_BLOCK_SIZE = 1 << 18;
+
+/** The first bytes of a gzip file. */
+static const unsigned char GZIP_MAGIC[] = {0x1f, 0x8b};
+
+/** The first bytes of a zstd file. */
+static const unsigned char ZSTD_MAGIC[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+/**
+ * Custom constructor. Opens the passed file and starts the background thread
+ * which reads the file ahead of the parser.
+ * @param strPath - The name of the file to be read.
+ * @param nBlockSize - The number of bytes read into a buffer at a time. Defaults to 1 MB.
+ */
+BlockReader::BlockReader(const string &strPath, size_t nBlockSize) {
+    blockSize = nBlockSize;
+    lengths[0] = lengths[1] = 0;
+    full[0] = full[1] = false;
+    done = false;
+    stopping = false;
+    current = 0;
+    pos = 0;
+    started = false;
+    compression = PLAIN;
+    frameEnded = true;
+    failed = false;
+#ifdef HAVE_ZSTD
+    zstd = NULL;
+#endif
+
+    infile.open(strPath, ios::binary);
+
+    // The first bytes of the file tell if it is compressed. They are read
+    // again as part of the first block.
+    if (infile.is_open()) {
+        unsigned char magic[4] = {0, 0, 0, 0};
+        infile.read((char*) magic, sizeof (magic));
+        infile.clear();
+        infile.seekg(0);
+
+        if (memcmp(magic, GZIP_MAGIC, sizeof (GZIP_MAGIC)) == 0) {
+            compression = GZIP;
+        } else if (memcmp(magic, ZSTD_MAGIC, sizeof (ZSTD_MAGIC)) == 0) {
+            compression = ZSTD;
+        }
+    }
+
+    if (compression == GZIP) {
+        memset(&gzip, 0, sizeof (gzip));
+
+        // Adding 32 to the window size has zlib read and check the gzip header.
+        if (inflateInit2(&gzip, 15 + 32) != Z_OK) {
+            failed = true;
+        }
+    } else if (compression == ZSTD) {
+#ifdef HAVE_ZSTD
+        zstd = ZSTD_createDStream();
+        if (zstd == NULL || ZSTD_isError(ZSTD_initDStream(zstd))) {
+            failed = true;
+        }
+        zstdInput.src = NULL;
+        zstdInput.size = 0;
+        zstdInput.pos = 0;
+#else
+        failed = true;
+#endif
+    }
+
+    if (infile.is_open() && !failed) {
+        buffers[0].resize(blockSize);
+        buffers[1].resize(blockSize);
+        if (compression != PLAIN) {
+            packed.resize(PACKED_BLOCK_SIZE);
+        }
+        reader = thread(&BlockReader::readAhead, this);
+    } else {
+        done = true;
+    }
+}
+
+/**
+ * Standard destructor. Stops the background thread and closes the file.
+ */
+BlockReader::~BlockReader() {
+    {
+        lock_guard<mutex> lock(bufferMutex);
+        stopping = true;
+    }
+    bufferReady.notify_all();
+
+    if (reader.joinable()) {
+        reader.join();
+    }
+    infile.close();
+
+    if (compression == GZIP) {
+        inflateEnd(&gzip);
+    }
+#ifdef HAVE_ZSTD
+    ZSTD_freeDStream(zstd);
+#endif
+}
+
+/**
+ * Checks if the file was opened successfully.
+ * @return - True if the file is open.
+ */
+bool BlockReader::isOpen() const {
+    return infile.is_open();
+}
+
+/**
+ * Checks if the file could not be read to the end, either because it was
+ * compressed in a way this build cannot read or because the compressed data
+ * was damaged or cut short. Only meaningful once 'getLine' has returned false.
+ * @return - True if the file was not read in full.
+ */
+bool BlockReader::hasFailed() const {
+    return failed;
+}
+
+/**
+ * Function run by the background thread. Fills the two buffers in turn,
+ * waiting whenever the parser has not yet finished with the next buffer.
+ */
+void BlockReader::readAhead() {
+    int next = 0;
+
+    while (true) {
+
+        // Waits until the parser has handed this buffer back.
+        {
+            unique_lock<mutex> lock(bufferMutex);
+            while (full[next] && !stopping) {
+                bufferReady.wait(lock);
+            }
+            if (stopping) {
+                return;
+            }
+        }
+
+        // The read itself is done without holding the lock so the parser can
+        // keep working through the other buffer.
+        size_t count = fill(&buffers[next][0], blockSize);
+
+        {
+            lock_guard<mutex> lock(bufferMutex);
+            if (count == 0) {
+                done = true;
+            } else {
+                lengths[next] = count;
+                full[next] = true;
+            }
+        }
+        bufferReady.notify_all();
+
+        if (count == 0) {
+            return;
+        }
+        next = 1 - next;
+    }
+}
+
+/**
+ * Function run by the background thread to fill a buffer with the next part
+ * of the file, decompressing it if needed.
+ * @param out - The buffer to fill.
+ * @param capacity - The size of the buffer.
+ * @return - The number of bytes stored, 0 at the end of the file or on an error.
+ */
+size_t BlockReader::fill(char* out, size_t capacity) {
+    switch (compression) {
+        case GZIP:
+            return inflateBlock(out, capacity);
+#ifdef HAVE_ZSTD
+        case ZSTD:
+            return decompressZstdBlock(out, capacity);
+#endif
+        default:
+            infile.read(out, capacity);
+            return infile.gcount();
+    }
+}
+
+/**
+ * Function which fills a buffer with the next part of a gzip file. Files made
+ * of several gzip members one after another are read as one file.
+ * @param out - The buffer to fill.
+ * @param capacity - The size of the buffer.
+ * @return - The number of bytes stored.
+ */
+size_t BlockReader::inflateBlock(char* out, size_t capacity) {
+    gzip.next_out = (Bytef*) out;
+    gzip.avail_out = capacity;
+
+    while (gzip.avail_out > 0 && !failed) {
+        if (gzip.avail_in == 0) {
+            size_t count = readPacked();
+
+            // A file which ends part way through a member has been cut short.
+            if (count == 0) {
+                failed = !frameEnded;
+                break;
+            }
+            gzip.next_in = (Bytef*) & packed[0];
+            gzip.avail_in = count;
+        }
+
+        int status = inflate(&gzip, Z_NO_FLUSH);
+        if (status == Z_STREAM_END) {
+
+            // Another member may follow, which is started with a fresh decompressor.
+            frameEnded = true;
+            inflateReset(&gzip);
+        } else if (status == Z_OK) {
+            frameEnded = false;
+        } else if (status != Z_BUF_ERROR) {
+            failed = true;
+        }
+    }
+    return capacity - gzip.avail_out;
+}
+
+#ifdef HAVE_ZSTD
+
+/**
+ * Function which fills a buffer with the next part of a zstd file. Files made
+ * of several zstd frames one after another are read as one file.
+ * @param out - The buffer to fill.
+ * @param capacity - The size of the buffer.
+ * @return - The number of bytes stored.
+ */
+size_t BlockReader::decompressZstdBlock(char* out, size_t capacity) {
+    ZSTD_outBuffer output = {out, capacity, 0};
+
+    while (output.pos < output.size && !failed) {
+        if (zstdInput.pos == zstdInput.size) {
+            size_t count = readPacked();
+
+            // A file which ends part way through a frame has been cut short.
+            if (count == 0) {
+                failed = !frameEnded;
+                break;
+            }
+            zstdInput.src = &packed[0];
+            zstdInput.size = count;
+            zstdInput.pos = 0;
+        }
+
+        // The decompressor returns 0 once a frame is complete, and the next
+        // frame is started on the following call.
+        size_t status = ZSTD_decompressStream(zstd, &output, &zstdInput);
+        if (ZSTD_isError(status)) {
+            failed = true;
+        } else {
+            frameEnded = (status == 0);
+        }
+    }
+    return output.pos;
+}
+#endif
+
+/**
+ * Function which reads the next block of compressed bytes from the file.
+ * @return - The number of bytes read, 0 at the end of the file.
+ */
+size_t BlockReader::readPacked() {
+    infile.read(&packed[0], packed.size());
+    return infile.gcount();
+}
+
+/**
+ * Function which hands the current buffer back to the background thread
+ * and waits for the next buffer to be filled.
+ * @return - False if there are no more blocks in the file.
+ */
+bool BlockReader::nextBuffer() {
+    unique_lock<mutex> lock(bufferMutex);
+
+    if (started) {
+        full[current] = false;
+        current = 1 - current;
+        bufferReady.notify_all();
+    }
+    started = true;
+    pos = 0;
+
+    // Blocks are filled in the same order they are read, so if the next buffer
+    // is not full once the background thread is done, the file has ended.
+    while (!full[current] && !done) {
+        bufferReady.wait(lock);
+    }
+    return full[current];
+}
+
+/**
+ * Reads the next line of the file into the passed string. Behaves the same
+ * as 'getline', the newline character is removed and the string is left
+ * empty once the end of the file has been reached.
+ * @param line - The string in which the line is stored. Passed by ref.
+ * @return - True if a line was read, false at the end of the file.
+ */
+bool BlockReader::getLine(string &line) {
+    line.clear();
+
+    while (true) {
+        if (!started || pos == lengths[current]) {
+            if (!nextBuffer()) {
+                return !line.empty();
+            }
+        }
+
+        const char* start = &buffers[current][pos];
+        size_t remaining = lengths[current] - pos;
+        const char* newline = (const char*) memchr(start, '\n', remaining);
+
+        // If the newline is in this buffer the line is complete, otherwise the
+        // rest of the buffer is kept and the line continues in the next block.
+        if (newline != NULL) {
+            line.append(start, newline - start);
+            pos += (newline - start) + 1;
+            return true;
+        }
+        line.append(start, remaining);
+        pos = lengths[current];
+    }
+}
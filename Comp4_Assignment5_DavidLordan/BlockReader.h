@@ -0,0 +1,196 @@
+/* File:   BlockReader.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the BlockReader class, which is used to read an
+ * XML file line by line in place of 'getline' on an ifstream. The file is read
+ * in large blocks by a background thread into two buffers. While the parser is
+ * working through the lines of one buffer, the next block is already being read
+ * into the other, so that reading from the disk and parsing happen at the same time.
+ *
+ * Files compressed with gzip are recognized by their first bytes and decompressed
+ * by the same background thread, so the buffers always hold the XML text and no
+ * decompressed copy is ever written to the disk. Files compressed with zstd are
+ * read the same way when the program is built with HAVE_ZSTD defined and linked
+ * with libzstd.
+ */
+
+#ifndef BLOCKREADER_H
+#define	BLOCKREADER_H
+
+#include <string>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+class BlockReader {
+public:
+
+    /**
+     * Custom constructor. Opens the passed file and starts the background thread
+     * which reads the file ahead of the parser.
+     * @param strPath - The name of the file to be read.
+     * @param nBlockSize - The number of bytes read into a buffer at a time. Defaults to 1 MB.
+     */
+    BlockReader(const string &strPath, size_t nBlockSize = 1 << 20);
+
+    /**
+     * Standard destructor. Stops the background thread and closes the file.
+     */
+    virtual ~BlockReader();
+
+    /**
+     * Reads the next line of the file into the passed string. Behaves the same
+     * as 'getline', the newline character is removed and the string is left
+     * empty once the end of the file has been reached.
+     * @param line - The string in which the line is stored. Passed by ref.
+     * @return - True if a line was read, false at the end of the file.
+     */
+    bool getLine(string &line);
+
+    /**
+     * Checks if the file was opened successfully.
+     * @return - True if the file is open.
+     */
+    bool isOpen() const;
+
+    /**
+     * Checks if the file could not be read to the end, either because it was
+     * compressed in a way this build cannot read or because the compressed data
+     * was damaged or cut short. Only meaningful once 'getLine' has returned false.
+     * @return - True if the file was not read in full.
+     */
+    bool hasFailed() const;
+
+private:
+
+    /** Copying a reader would copy the running thread, so it is not allowed. */
+    BlockReader(const BlockReader& orig);
+    BlockReader& operator=(const BlockReader& orig);
+
+    /**
+     * Function run by the background thread. Fills the two buffers in turn,
+     * waiting whenever the parser has not yet finished with the next buffer.
+     */
+    void readAhead();
+
+    /**
+     * Function which hands the current buffer back to the background thread
+     * and waits for the next buffer to be filled.
+     * @return - False if there are no more blocks in the file.
+     */
+    bool nextBuffer();
+
+    /**
+     * Function run by the background thread to fill a buffer with the next part
+     * of the file, decompressing it if needed.
+     * @param out - The buffer to fill.
+     * @param capacity - The size of the buffer.
+     * @return - The number of bytes stored, 0 at the end of the file or on an error.
+     */
+    size_t fill(char* out, size_t capacity);
+
+    /**
+     * Function which fills a buffer with the next part of a gzip file. Files made
+     * of several gzip members one after another are read as one file.
+     * @param out - The buffer to fill.
+     * @param capacity - The size of the buffer.
+     * @return - The number of bytes stored.
+     */
+    size_t inflateBlock(char* out, size_t capacity);
+
+#ifdef HAVE_ZSTD
+    /**
+     * Function which fills a buffer with the next part of a zstd file. Files made
+     * of several zstd frames one after another are read as one file.
+     * @param out - The buffer to fill.
+     * @param capacity - The size of the buffer.
+     * @return - The number of bytes stored.
+     */
+    size_t decompressZstdBlock(char* out, size_t capacity);
+#endif
+
+    /**
+     * Function which reads the next block of compressed bytes from the file.
+     * @return - The number of bytes read, 0 at the end of the file.
+     */
+    size_t readPacked();
+
+    /** The ways the file can be stored. */
+    enum Compression {
+        PLAIN, GZIP, ZSTD
+    };
+
+    /** The way the file is stored, found from its first bytes. */
+    Compression compression;
+
+    /** Buffer holding compressed bytes read from the file, before they are decompressed. */
+    vector<char> packed;
+
+    /** Set once the last gzip member or zstd frame started has been read to its end. */
+    bool frameEnded;
+
+    /** Set by the background thread if the file could not be read in full. */
+    bool failed;
+
+    /** The state of the gzip decompressor. */
+    z_stream gzip;
+
+#ifdef HAVE_ZSTD
+    /** The state of the zstd decompressor. */
+    ZSTD_DStream* zstd;
+
+    /** The part of 'packed' not yet given to the zstd decompressor. */
+    ZSTD_inBuffer zstdInput;
+#endif
+
+    /** The file being read. Only used by the background thread once it is started. */
+    ifstream infile;
+
+    /** The number of bytes read into a buffer at a time. */
+    size_t blockSize;
+
+    /** The two buffers that the file is read into. */
+    vector<char> buffers[2];
+
+    /** The number of bytes stored in each buffer. */
+    size_t lengths[2];
+
+    /** Set while a buffer holds a block that the parser has not finished with. */
+    bool full[2];
+
+    /** Set by the background thread once the end of the file has been read. */
+    bool done;
+
+    /** Set by the destructor to stop the background thread early. */
+    bool stopping;
+
+    /** The buffer that the parser is currently reading lines from. */
+    int current;
+
+    /** The position within the current buffer of the next line. */
+    size_t pos;
+
+    /** Set once the parser has been handed its first buffer. */
+    bool started;
+
+    /** Mutex and condition variable shared by the parser and the background thread. */
+    mutex bufferMutex;
+    condition_variable bufferReady;
+
+    /** The background thread which reads the file. */
+    thread reader;
+};
+
+#endif	/* BLOCKREADER_H */
+
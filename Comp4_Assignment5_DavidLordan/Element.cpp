@@ -13,16 +13,49 @@
  * Jesse Heines of UMass Lowell for the Fall 2014 91.204-Computing IV class.
  */
 
+#include <utility>
 #include "Element.h"
 
+/** The starting value of the 64-bit FNV-1a hash. */
+static const unsigned long long FNV_OFFSET = 14695981039346656037ULL;
+
+/** The multiplier of the 64-bit FNV-1a hash. */
+static const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+/**
+ * Helper function to add bytes to a 64-bit FNV-1a hash.
+ * @param hash - The hash so far. Passed by reference.
+ * @param bytes - The bytes to add.
+ * @param length - The number of bytes.
+ */
+static void addToHash(unsigned long long &hash, const void* bytes, size_t length) {
+    const unsigned char* it = (const unsigned char*) bytes;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= it[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+/**
+ * Helper function to add a string to a 64-bit FNV-1a hash. The length is added
+ * first, so that moving text from one string to the next changes the hash.
+ * @param hash - The hash so far. Passed by reference.
+ * @param text - The string to add.
+ */
+static void addToHash(unsigned long long &hash, const string &text) {
+    size_t length = text.size();
+    addToHash(hash, &length, sizeof (length));
+    addToHash(hash, text.data(), length);
+}
+
 /**
  * Default constructor. Sets strTagName and strContent to be an 
- * empty string, sets lineNumber to 0.
+ * empty string, sets lineNumber and level to 0 and the parent to NULL.
  */
-Element::Element() {
-    strTagName = "";
+Element::Element() : data(new Content) {
     lineNumber = 0;
-    strContent = "";
+    level = 0;
+    parent = NULL;
 }
 
 /**
@@ -31,51 +64,66 @@ Element::Element() {
  * object it is copied from.
  * @param orig  -   Original element object which is copied. 
  */
-Element::Element(const Element& orig) {
-    strTagName = orig.getTagName();
+Element::Element(const Element& orig) : data(new Content) {
+    data->strTagName = orig.getTagName();
     lineNumber = orig.getLineNo();
-    strContent = orig.getStrContent();
+    data->strContent = orig.getStrContent();
+    data->strRawAttributes = orig.getRawAttributes();
 }
 
 /**
  * Custom constructor. Assigns the passed parameters to the newly created element's
- * member variables. Used in the program whenever a new element is created. Also
- * calls the 'findAttributes' function which will scan the line on which the element
- * was found for attributes and populate a vector of found attributes. Also sets the
+ * member variables. Used in the program whenever a new element is created. The
+ * attributes are not parsed here, instead the opening tag is scanned with
+ * 'findAttributeSpan' and the raw attribute text is kept so that 'findAttributes'
+ * can be run the first time the attributes are actually needed. Also sets the
  * to element's level to 0 as the 'setLevel' function is called after the new element
- * is created. This should be re-factored in future versions. 
+ * is created. This should be re-factored in future versions. The tag name and
+ * content are moved into the element rather than copied. 
  * @param tagName - A string which is used to store the element's tag name.
  * @param nLineNo - The line number of the XML file on which the element was found. 
  * @param content - A string which is used to store the element's content. 
  * @param currentLine - The entire line of an XML file on which the element was found,
- *                      used when 'findAttributes' is called. 
+ *                      used when 'findAttributeSpan' is called. 
  */
-Element::Element(string tagName, int nLineNo, string content, string currentLine) {
+Element::Element(string tagName, int nLineNo, string content, const string &currentLine)
+: data(new Content) {
 
-    strContent = content;
+    data->strContent = move(content);
 
-    strTagName = tagName;
+    data->strTagName = move(tagName);
 
     lineNumber = nLineNo;
 
     level = 0;
 
-    findAttributes(currentLine);
+    data->strRawAttributes = findAttributeSpan(currentLine);
 }
 
 /**
- * Standard destructor.
+ * Standard destructor. The element's content is deleted along with it, unless
+ * it is shared with another element.
  */
 Element::~Element() {
+    release();
+}
+
+/**
+ * Standard destructor. Deletes any attribute objects that were created by 'findAttributes'.
+ */
+Element::Content::~Content() {
+    for (vector<Attribute*>::iterator it = vecAttribute.begin(); it != vecAttribute.end(); ++it) {
+        delete *it;
+    }
 }
 
 /**
  * Standard getter for the element's tag name, used throughout the program
  * for output and for building the tree. 
- * @return strTagName - The string stored as the elements tag name. 
+ * @return strTagName - The string stored as the elements tag name, returned by const reference. 
  */
-string Element::getTagName() const {
-    return strTagName;
+const string& Element::getTagName() const {
+    return data->strTagName;
 }
 
 /**
@@ -87,13 +135,42 @@ int Element::getLineNo() const {
     return lineNumber;
 }
 
+/**
+ * Standard setter for the line number that a element is found on. Used when
+ * line numbers are shifted after part of a cached tree has been re-parsed. 
+ * @param nLineNo - The line in an XML file on which the element was found. 
+ */
+void Element::setLineNo(int nLineNo) {
+    lineNumber = nLineNo;
+}
+
+/**
+ * Standard getter for the line number of the element's closing tag. For complete
+ * and self-closing elements this is the same as the opening line. Together with
+ * 'getLineNo' this gives the span of lines that the element covers in the file.
+ * @return endLineNumber - The line in an XML file on which the element was closed. 
+ */
+int Element::getEndLineNo() const {
+    return endLineNumber;
+}
+
+/**
+ * Standard setter for the line number of the element's closing tag. Called when
+ * the closing tag is processed. 
+ * @param nLineNo - The line in an XML file on which the element was closed. 
+ */
+void Element::setEndLineNo(int nLineNo) {
+    endLineNumber = nLineNo;
+}
+
 /**
  * Standard getter for the content of an element. If the element has no content
  * this will simply return "Empty". Used when displaying the tree structure. 
- * @return strContent - The content of the current element. Defaults to "Empty".
+ * @return strContent - The content of the current element, returned by const reference. 
+ *                      Defaults to "Empty".
  */
-string Element::getStrContent() const {
-    return strContent;
+const string& Element::getStrContent() const {
+    return data->strContent;
 }
 
 /**
@@ -101,7 +178,8 @@ string Element::getStrContent() const {
  * @param tagName - A string which is to be stored as the element's tag name.
  */
 void Element::setTagName(string tagName) {
-    strTagName = tagName;
+    unshare();
+    data->strTagName = move(tagName);
 }
 
 /**
@@ -109,7 +187,8 @@ void Element::setTagName(string tagName) {
  * @param content - A string which is to be stored as the element's content.
  */
 void Element::setStrContent(string content) {
-    strContent = content;
+    unshare();
+    data->strContent = move(content);
 }
 
 /**
@@ -118,24 +197,88 @@ void Element::setStrContent(string content) {
  * this function is called before the element's level has been set. The function
  * uses this default level to determine if the tree is currently being built. 
  * This behavior is not reliable and should be updated in future versions.
+ * @param os - The output stream the attributes are written to. Defaults to cout.
  */
-void Element::displayAttributes() {
+void Element::displayAttributes(ostream &os) {
+
+    vector<Attribute*> &vecAttribute = getAttributes();
 
     if (!vecAttribute.empty()) {
 
         for (int i = 0; i < vecAttribute.size(); i++) {
             if (this->getLevel() != 0) {
                 for (int j = 1; j < this->getLevel(); j++) {
-                    cout << ".";
+                    os << ".";
                 }
             } else {
-                cout << "*** ";
+                os << "*** ";
             }
 
-            cout << "Attribute name: " << vecAttribute[i]->getAttName();
-            cout << ", Attribute value: " << vecAttribute[i]->getAttValue() << endl;
+            os << "Attribute name: " << vecAttribute[i]->getAttName();
+            os << ", Attribute value: " << vecAttribute[i]->getAttValue() << '\n';
+        }
+    }
+}
+
+/**
+ * Function that finds the opening tag within an XML line and returns it if it
+ * contains any attributes. The returned text is later passed to 'findAttributes'.
+ * The end of the opening tag is the first '>' that is not inside a quoted value.
+ * @param currentLine - A complete XML line in which the opening tag is found. 
+ * @return - The opening tag text, or an empty string if there are no attributes. 
+ */
+string Element::findAttributeSpan(const string &currentLine) {
+    char quote = '\0';
+    string::size_type tagEnd = 0;
+
+    while (tagEnd < currentLine.size()) {
+        char c = currentLine[tagEnd];
+
+        if (quote != '\0') {
+            if (c == quote)
+                quote = '\0';
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == '>') {
+            break;
+        }
+        tagEnd++;
+    }
+
+    string::size_type dquote = currentLine.find("=\"");
+    string::size_type squote = currentLine.find("=\'");
+
+    // Most elements have no attributes, in which case nothing is stored.
+    if ((dquote == string::npos || dquote >= tagEnd)
+            && (squote == string::npos || squote >= tagEnd)) {
+        return "";
+    }
+    return currentLine.substr(0, tagEnd);
+}
+
+/**
+ * Getter for the element's attributes. The first time this is called the raw
+ * attribute text is parsed by 'findAttributes', after that the cached vector
+ * is returned. Used when displaying the tree and writing the output files. 
+ * @return vecAttribute - The vector of pointers to the element's attribute objects. 
+ */
+vector<Attribute*>& Element::getAttributes() {
+    if (!data->attributesParsed) {
+        data->attributesParsed = true;
+        if (!data->strRawAttributes.empty()) {
+            findAttributes(data->strRawAttributes);
         }
     }
+    return data->vecAttribute;
+}
+
+/**
+ * Getter for the raw attribute text of the element's opening tag. Used when
+ * the tree is saved to a cache file so the attributes can be parsed later. 
+ * @return strRawAttributes - The raw attribute text. Empty if there are no attributes. 
+ */
+const string& Element::getRawAttributes() const {
+    return data->strRawAttributes;
 }
 
 /**
@@ -144,9 +287,9 @@ void Element::displayAttributes() {
  * and pushed onto the current element's attribute vector, "vecAttribute". Also,
  * the function's algorithm is executed twice, searching for double quotes and single
  * quotes respectively. 
- * @param currentLine - A complete XML line which in which attributes are searched for. 
+ * @param currentLine - The raw attribute text in which attributes are searched for. 
  */
-void Element::findAttributes(string currentLine) {
+void Element::findAttributes(const string &currentLine) {
     string name;
     string value;
 
@@ -164,9 +307,9 @@ void Element::findAttributes(string currentLine) {
 
         value = currentLine.substr(valStart, valEnd - valStart);
 
-        Attribute* AttributePtr = new Attribute(name, value);
+        Attribute* AttributePtr = new Attribute(move(name), move(value));
 
-        vecAttribute.push_back(AttributePtr);
+        data->vecAttribute.push_back(AttributePtr);
 
         searchStart = currentLine.find("\" ", searchStart + 1);
 
@@ -184,9 +327,9 @@ void Element::findAttributes(string currentLine) {
 
         value = currentLine.substr(valStart, valEnd - valStart);
 
-        Attribute* AttributePtr = new Attribute(name, value);
+        Attribute* AttributePtr = new Attribute(move(name), move(value));
 
-        vecAttribute.push_back(AttributePtr);
+        data->vecAttribute.push_back(AttributePtr);
 
         searchStart = currentLine.find("\' ", searchStart + 1);
 
@@ -206,6 +349,17 @@ void Element::addChild(Element* newChild) {
     vecChildren.push_back(newChild);
 }
 
+/**
+ * Function to remove a range of children from the element. The children
+ * themselves are not deleted. Used when a part of a cached tree is re-parsed. 
+ * @param first - The index of the first child to remove.
+ * @param last - The index after the last child to remove.
+ */
+void Element::removeChildren(int first, int last) {
+    vecChildren.erase(vecChildren.begin() + first, vecChildren.begin() + last);
+    noOfChildren -= (last - first);
+}
+
 /**
  * Function to store a pointer to the current element's parent. This is called
  * in the program just after a new element is created. In future versions
@@ -256,13 +410,135 @@ void Element::setLevel(int newLevel) {
 
 /**
  * A simple boolean function that determines if the element object contains
- * attributes or not. This is done by checking if the 'vecAttribute' vector is empty.
+ * attributes or not. This is done by checking if any raw attribute text was
+ * found in the opening tag, so the attributes do not need to be parsed.
  * This is called as the tree is being displayed. 
  * @return - Boolean value referencing the presence or lack of attributes for the element. 
  */
 bool Element::hasAttributes() {
-    if (vecAttribute.empty())
+    if (data->strRawAttributes.empty())
         return false;
     else
         return true;
-}
\ No newline at end of file
+}
+
+/**
+ * Checks if the element has the same tag name, content and raw attribute
+ * text as another element. Children are not compared.
+ * @param other - The element to compare with.
+ * @return - True if the two elements hold the same text.
+ */
+bool Element::sameContent(const Element &other) const {
+    return data == other.data
+            || (data->strTagName == other.data->strTagName
+            && data->strContent == other.data->strContent
+            && data->strRawAttributes == other.data->strRawAttributes);
+}
+
+/**
+ * Checks if the element shares its tag name, content and attributes with
+ * another element, which 'SubtreePool' only does for identical subtrees.
+ * @param other - The element to compare with.
+ * @return - True if both elements use the same copy of their content.
+ */
+bool Element::sharesContentWith(const Element &other) const {
+    return data == other.data;
+}
+
+/**
+ * Gets a value which is the same for two elements only if they share their
+ * content. Used to hash a subtree by the content of its children.
+ * @return - The address of the shared content.
+ */
+const void* Element::getContentId() const {
+    return data;
+}
+
+/**
+ * Makes the element use the same copy of its tag name, content and attributes
+ * as another element with the same content, dropping its own copy. The line
+ * numbers, level, parent and children stay the element's own. 
+ * @param other - The element whose content is shared.
+ * @return - The number of bytes freed by dropping the element's own copy.
+ */
+size_t Element::shareContent(const Element &other) {
+    if (data == other.data) {
+        return 0;
+    }
+
+    // The copy is only freed if no other element was using it. Strings short
+    // enough to be kept inside the string object have no memory of their own.
+    size_t freed = 0;
+    if (data->references == 1) {
+        const Content &own = *data;
+        freed = sizeof (Content);
+        const string* strings[] = {&own.strTagName, &own.strContent, &own.strRawAttributes};
+        for (int i = 0; i < 3; i++) {
+            const char* text = strings[i]->data();
+            if (text < (const char*) strings[i] || text >= (const char*) (strings[i] + 1)) {
+                freed += strings[i]->capacity() + 1;
+            }
+        }
+        freed += own.vecAttribute.size() * sizeof (Attribute);
+    }
+    release();
+    data = other.data;
+    data->references++;
+    return freed;
+}
+
+/**
+ * Function which gives the element its own copy of its content before it is
+ * changed, if the content is shared with other elements.
+ */
+void Element::unshare() {
+    if (data->references > 1) {
+        Content* own = new Content;
+        own->strTagName = data->strTagName;
+        own->strContent = data->strContent;
+        own->strRawAttributes = data->strRawAttributes;
+        release();
+        data = own;
+    }
+}
+
+/**
+ * Function which stops using the element's content, deleting it if no other
+ * element uses it.
+ */
+void Element::release() {
+    data->references--;
+    if (data->references == 0) {
+        delete data;
+    }
+    data = NULL;
+}
+
+/**
+ * Standard getter for the hash of the element's subtree, which covers the tag
+ * name, content and raw attribute text of the element and everything below it,
+ * but not line numbers. Identical subtrees have the same hash wherever they are.
+ * @return subtreeHash - The hash, or 0 if 'updateHash' has not been called.
+ */
+unsigned long long Element::getHash() const {
+    return subtreeHash;
+}
+
+/**
+ * Works out the hash of the element's subtree from its own text and the hashes
+ * of its children, which must already be up to date. Called once the element's
+ * closing tag has been processed, and again for each element above a part of
+ * the tree that has changed.
+ */
+void Element::updateHash() {
+    unsigned long long hash = FNV_OFFSET;
+    addToHash(hash, data->strTagName);
+    addToHash(hash, data->strContent);
+    addToHash(hash, data->strRawAttributes);
+
+    for (vector<Element*>::iterator it = vecChildren.begin(); it != vecChildren.end(); ++it) {
+        unsigned long long childHash = (*it)->subtreeHash;
+        addToHash(hash, &childHash, sizeof (childHash));
+    }
+    subtreeHash = hash;
+}
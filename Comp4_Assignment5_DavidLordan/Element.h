@@ -29,7 +29,7 @@ public:
 
     /**
      * Default constructor. Sets strTagName and strContent to be an 
-     * empty string, sets lineNumber to 0.
+     * empty string, sets lineNumber and level to 0 and the parent to NULL.
      */
     Element();
 
@@ -48,18 +48,20 @@ public:
 
     /**
      * Custom constructor. Assigns the passed parameters to the newly created element's
-     * member variables. Used in the program whenever a new element is created. Also
-     * calls the 'findAttributes' function which will scan the line on which the element
-     * was found for attributes and populate a vector of found attributes. Also sets the
+     * member variables. Used in the program whenever a new element is created. The
+     * attributes are not parsed here, instead the opening tag is scanned with
+     * 'findAttributeSpan' and the raw attribute text is kept so that 'findAttributes'
+     * can be run the first time the attributes are actually needed. Also sets the
      * to element's level to 0 as the 'setLevel' function is called after the new element
-     * is created. This should be re-factored in future versions. 
+     * is created. This should be re-factored in future versions. The tag name and
+     * content are moved into the element rather than copied. 
      * @param tagName - A string which is used to store the element's tag name.
      * @param nLineNo - The line number of the XML file on which the element was found. 
      * @param content - A string which is used to store the element's content. 
      * @param currentLine - The entire line of an XML file on which the element was found,
-     *                      used when 'findAttributes' is called. 
+     *                      used when 'findAttributeSpan' is called. 
      */
-    Element(string strElementName, int nLineNo, string content, string currentLine);
+    Element(string strElementName, int nLineNo, string content, const string &currentLine);
 
     /**
      * Standard getter for the line number that a element is found on in an XML file.
@@ -68,19 +70,42 @@ public:
      */
     int getLineNo() const;
 
+    /**
+     * Standard setter for the line number that a element is found on. Used when
+     * line numbers are shifted after part of a cached tree has been re-parsed. 
+     * @param nLineNo - The line in an XML file on which the element was found. 
+     */
+    void setLineNo(int nLineNo);
+
+    /**
+     * Standard getter for the line number of the element's closing tag. For complete
+     * and self-closing elements this is the same as the opening line. Together with
+     * 'getLineNo' this gives the span of lines that the element covers in the file.
+     * @return endLineNumber - The line in an XML file on which the element was closed. 
+     */
+    int getEndLineNo() const;
+
+    /**
+     * Standard setter for the line number of the element's closing tag. Called when
+     * the closing tag is processed. 
+     * @param nLineNo - The line in an XML file on which the element was closed. 
+     */
+    void setEndLineNo(int nLineNo);
+
     /**
      * Standard getter for the element's tag name, used throughout the program
      * for output and for building the tree. 
-     * @return strTagName - The string stored as the elements tag name. 
+     * @return strTagName - The string stored as the elements tag name, returned by const reference. 
      */
-    string getTagName() const;
+    const string& getTagName() const;
 
     /**
      * Standard getter for the content of an element. If the element has no content
      * this will simply return "Empty". Used when displaying the tree structure. 
-     * @return strContent - The content of the current element. Defaults to "Empty".
+     * @return strContent - The content of the current element, returned by const reference. 
+     *                      Defaults to "Empty".
      */
-    string getStrContent() const;
+    const string& getStrContent() const;
 
     /**
      * Standard setter for the element's content. Called when a new element is created.
@@ -100,8 +125,9 @@ public:
      * this function is called before the element's level has been set. The function
      * uses this default level to determine if the tree is currently being built. 
      * This behavior is not reliable and should be updated in future versions.
+     * @param os - The output stream the attributes are written to. Defaults to cout.
      */
-    void displayAttributes();
+    void displayAttributes(ostream &os = cout);
 
     /**
      * Function to store pointers to children of the element. Pointers are pushed
@@ -152,29 +178,129 @@ public:
 
     /**
      * A simple boolean function that determines if the element object contains
-     * attributes or not. This is done by checking if the 'vecAttribute' vector is empty.
+     * attributes or not. This is done by checking if any raw attribute text was
+     * found in the opening tag, so the attributes do not need to be parsed.
      * This is called as the tree is being displayed. 
      * @return - Boolean value referencing the presence or lack of attributes for the element. 
      */
     bool hasAttributes();
 
-    /** A vector which is used to store pointers to attribute objects that belong to the
-     current element object. */
-    vector<Attribute*> vecAttribute;
+    /**
+     * Getter for the element's attributes. The first time this is called the raw
+     * attribute text is parsed by 'findAttributes', after that the cached vector
+     * is returned. Used when displaying the tree and writing the output files. 
+     * @return vecAttribute - The vector of pointers to the element's attribute objects. 
+     */
+    vector<Attribute*>& getAttributes();
+
+    /**
+     * Getter for the raw attribute text of the element's opening tag. Used when
+     * the tree is saved to a cache file so the attributes can be parsed later. 
+     * @return strRawAttributes - The raw attribute text. Empty if there are no attributes. 
+     */
+    const string& getRawAttributes() const;
+
+    /**
+     * Function to remove a range of children from the element. The children
+     * themselves are not deleted. Used when a part of a cached tree is re-parsed. 
+     * @param first - The index of the first child to remove.
+     * @param last - The index after the last child to remove.
+     */
+    void removeChildren(int first, int last);
+
+    /**
+     * Checks if the element has the same tag name, content and raw attribute
+     * text as another element. Children are not compared.
+     * @param other - The element to compare with.
+     * @return - True if the two elements hold the same text.
+     */
+    bool sameContent(const Element &other) const;
+
+    /**
+     * Checks if the element shares its tag name, content and attributes with
+     * another element, which 'SubtreePool' only does for identical subtrees.
+     * @param other - The element to compare with.
+     * @return - True if both elements use the same copy of their content.
+     */
+    bool sharesContentWith(const Element &other) const;
+
+    /**
+     * Gets a value which is the same for two elements only if they share their
+     * content. Used to hash a subtree by the content of its children.
+     * @return - The address of the shared content.
+     */
+    const void* getContentId() const;
+
+    /**
+     * Makes the element use the same copy of its tag name, content and attributes
+     * as another element with the same content, dropping its own copy. The line
+     * numbers, level, parent and children stay the element's own. 
+     * @param other - The element whose content is shared.
+     * @return - The number of bytes freed by dropping the element's own copy.
+     */
+    size_t shareContent(const Element &other);
+
+    /**
+     * Standard getter for the hash of the element's subtree, which covers the tag
+     * name, content and raw attribute text of the element and everything below it,
+     * but not line numbers. Identical subtrees have the same hash wherever they are.
+     * @return subtreeHash - The hash, or 0 if 'updateHash' has not been called.
+     */
+    unsigned long long getHash() const;
+
+    /**
+     * Works out the hash of the element's subtree from its own text and the hashes
+     * of its children, which must already be up to date. Called once the element's
+     * closing tag has been processed, and again for each element above a part of
+     * the tree that has changed.
+     */
+    void updateHash();
 
     /** A vector which is used to store pointers to other element objects that are
      children of the current element object.*/
     vector<Element*> vecChildren;
 
 private:
-    /** Name of an element extracted from an opening XML tag. */
-    string strTagName;
+
+    /**
+     * The parts of an element which do not depend on where it is in the tree.
+     * Each element has its own until 'shareContent' is used, after which identical
+     * elements point to one copy, which is never changed again.
+     */
+    struct Content {
+        /** Name of an element extracted from an opening XML tag. */
+        string strTagName;
+
+        /** The content of an element extracted from the XML file.*/
+        string strContent;
+
+        /** The raw attribute text of the element's opening tag. Empty if the tag has no attributes. */
+        string strRawAttributes;
+
+        /** Set once 'findAttributes' has been run on the raw attribute text. */
+        bool attributesParsed = false;
+
+        /** A vector which is used to store pointers to attribute objects that belong to the
+         element. Only filled in once 'getAttributes' is called. */
+        vector<Attribute*> vecAttribute;
+
+        /** The number of elements using this copy. */
+        int references = 1;
+
+        /**
+         * Standard destructor. Deletes any attribute objects that were created by 'findAttributes'.
+         */
+        ~Content();
+    };
+
+    /** The element's tag name, content and attributes, which may be shared. */
+    Content* data;
 
     /** The line number of an XML document in which the element or it's opening tag was found.*/
     int lineNumber;
 
-    /** The content of an element extracted from the XML file.*/
-    string strContent;
+    /** The line number of an XML document in which the element's closing tag was found.*/
+    int endLineNumber = 0;
 
     /** The number of children that belong to the element. Used when displaying the tree.*/
     int noOfChildren = 0;
@@ -185,15 +311,41 @@ private:
     /** The level within the element tree structure in which the element is located. */
     int level;
 
+    /** The hash of the element's subtree, set by 'updateHash'. */
+    unsigned long long subtreeHash = 0;
+
+    /**
+     * Function that finds the opening tag within an XML line and returns it if it
+     * contains any attributes. The returned text is later passed to 'findAttributes'.
+     * @param currentLine - A complete XML line in which the opening tag is found. 
+     * @return - The opening tag text, or an empty string if there are no attributes. 
+     */
+    static string findAttributeSpan(const string &currentLine);
+
     /**
      * Function that scans an entire XML line to find attribute names
      * and their values. When attributes are found, a new attribute object is created
      * and pushed onto the current element's attribute vector, "vecAttribute". Also,
      * the function's algorithm is executed twice, searching for double quotes and single
      * quotes respectively. 
-     * @param currentLine - A complete XML line which in which attributes are searched for. 
+     * @param currentLine - The raw attribute text in which attributes are searched for. 
      */
-    void findAttributes(string currentLine);
+    void findAttributes(const string &currentLine);
+
+    /**
+     * Function which gives the element its own copy of its content before it is
+     * changed, if the content is shared with other elements.
+     */
+    void unshare();
+
+    /**
+     * Function which stops using the element's content, deleting it if no other
+     * element uses it.
+     */
+    void release();
+
+    /** Assigning an element would share its content without counting it, so it is not allowed. */
+    Element& operator=(const Element& orig);
 };
 
 #endif	/* ELEMENT_H */
@@ -0,0 +1,128 @@
+/* File:   SubtreePool.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the SubtreePool class, which finds identical
+ * subtrees of the element tree as it is built and lets them share one copy of their
+ * text, while every element keeps its own place in the tree.
+ */
+
+#include "SubtreePool.h"
+
+/**
+ * Default constructor. The pool starts empty.
+ */
+SubtreePool::SubtreePool() {
+    elementsSeen = 0;
+    elementsShared = 0;
+    bytesSaved = 0;
+}
+
+/**
+ * Standard destructor.
+ */
+SubtreePool::~SubtreePool() {
+}
+
+/**
+ * Shares the content of a complete element with an identical subtree seen
+ * before, or adds it to the pool if there is none. Must be called for each of
+ * the element's children before it is called for the element, and after the
+ * element's hash has been updated.
+ * @param elem - The element whose subtree has just been completed.
+ */
+void SubtreePool::share(Element* elem) {
+    elementsSeen++;
+    unsigned long long hash = elem->getHash();
+
+    // Elements with the same hash are checked one level down, since identical
+    // children already share their content.
+    pair<unordered_multimap<unsigned long long, Element*>::iterator,
+            unordered_multimap<unsigned long long, Element*>::iterator> range = subtrees.equal_range(hash);
+    for (unordered_multimap<unsigned long long, Element*>::iterator it = range.first; it != range.second; ++it) {
+        if (sameSubtree(elem, it->second)) {
+            bytesSaved += elem->shareContent(*it->second);
+            elementsShared++;
+            return;
+        }
+    }
+    subtrees.insert(make_pair(hash, elem));
+}
+
+/**
+ * Shares the content of every subtree below an element, children first. Used
+ * for trees which were not built line by line, such as a tree loaded from a cache,
+ * once their hashes are up to date.
+ * @param root - The element whose children are shared. The element itself is not.
+ */
+void SubtreePool::shareTree(Element* root) {
+    for (vector<Element*>::iterator it = root->vecChildren.begin(); it != root->vecChildren.end(); ++it) {
+        shareTree(*it);
+        share(*it);
+    }
+}
+
+/**
+ * Forgets every element in the pool, which is done once the tree is built
+ * since the tree may be changed afterwards. Elements keep any content they share.
+ */
+void SubtreePool::clear() {
+    subtrees.clear();
+}
+
+/**
+ * Forgets every element in the pool and sets the counts back to zero. Used
+ * when a tree is thrown away to be built again.
+ */
+void SubtreePool::reset() {
+    clear();
+    elementsSeen = 0;
+    elementsShared = 0;
+    bytesSaved = 0;
+}
+
+/**
+ * Gets the number of elements passed to the pool.
+ * @return - The number of elements.
+ */
+size_t SubtreePool::getElementsSeen() const {
+    return elementsSeen;
+}
+
+/**
+ * Gets the number of elements which took on the content of an identical subtree.
+ * @return - The number of elements.
+ */
+size_t SubtreePool::getElementsShared() const {
+    return elementsShared;
+}
+
+/**
+ * Gets the number of bytes freed by sharing content.
+ * @return - The number of bytes.
+ */
+size_t SubtreePool::getBytesSaved() const {
+    return bytesSaved;
+}
+
+/**
+ * Function which checks if two elements are the roots of identical subtrees,
+ * given that the children of both have already been shared.
+ * @param first - The first element.
+ * @param second - The second element.
+ * @return - True if the subtrees are identical.
+ */
+bool SubtreePool::sameSubtree(const Element* first, const Element* second) {
+    if (first->vecChildren.size() != second->vecChildren.size() || !first->sameContent(*second)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < first->vecChildren.size(); i++) {
+        if (!first->vecChildren[i]->sharesContentWith(*second->vecChildren[i])) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+/* File:   SubtreePool.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the SubtreePool class, which finds identical subtrees
+ * of the element tree as it is built and lets them share one copy of their text.
+ * Each element is passed to the pool once it and everything below it is complete,
+ * and its subtree hash is up to date. If an identical subtree has been seen before,
+ * the element takes on that subtree's copy of its content.
+ *
+ * Since the children of an element are passed to the pool before it is, identical
+ * children already share their content by the time the element is checked, so an
+ * element only has to be compared with the elements in the pool, never their whole
+ * subtrees. Line numbers, levels, parents and children are different for every
+ * place a subtree appears, so every element keeps its own, and anything which
+ * reads the tree sees exactly the same tree as without the pool.
+ */
+
+#ifndef SUBTREEPOOL_H
+#define	SUBTREEPOOL_H
+
+#include <unordered_map>
+#include <vector>
+#include "Element.h"
+
+using namespace std;
+
+class SubtreePool {
+public:
+
+    /**
+     * Default constructor. The pool starts empty.
+     */
+    SubtreePool();
+
+    /**
+     * Standard destructor.
+     */
+    virtual ~SubtreePool();
+
+    /**
+     * Shares the content of a complete element with an identical subtree seen
+     * before, or adds it to the pool if there is none. Must be called for each of
+     * the element's children before it is called for the element, and after the
+     * element's hash has been updated.
+     * @param elem - The element whose subtree has just been completed.
+     */
+    void share(Element* elem);
+
+    /**
+     * Shares the content of every subtree below an element, children first. Used
+     * for trees which were not built line by line, such as a tree loaded from a cache,
+     * once their hashes are up to date.
+     * @param root - The element whose children are shared. The element itself is not.
+     */
+    void shareTree(Element* root);
+
+    /**
+     * Forgets every element in the pool, which is done once the tree is built
+     * since the tree may be changed afterwards. Elements keep any content they share.
+     */
+    void clear();
+
+    /**
+     * Forgets every element in the pool and sets the counts back to zero. Used
+     * when a tree is thrown away to be built again.
+     */
+    void reset();
+
+    /**
+     * Gets the number of elements passed to the pool.
+     * @return - The number of elements.
+     */
+    size_t getElementsSeen() const;
+
+    /**
+     * Gets the number of elements which took on the content of an identical subtree.
+     * @return - The number of elements.
+     */
+    size_t getElementsShared() const;
+
+    /**
+     * Gets the number of bytes freed by sharing content.
+     * @return - The number of bytes.
+     */
+    size_t getBytesSaved() const;
+
+private:
+
+    /**
+     * Function which checks if two elements are the roots of identical subtrees,
+     * given that the children of both have already been shared.
+     * @param first - The first element.
+     * @param second - The second element.
+     * @return - True if the subtrees are identical.
+     */
+    static bool sameSubtree(const Element* first, const Element* second);
+
+    /** The first element seen of each distinct subtree, by hash. */
+    unordered_multimap<unsigned long long, Element*> subtrees;
+
+    /** The number of elements passed to the pool. */
+    size_t elementsSeen;
+
+    /** The number of elements which took on the content of an identical subtree. */
+    size_t elementsShared;
+
+    /** The number of bytes freed by sharing content. */
+    size_t bytesSaved;
+};
+
+#endif	/* SUBTREEPOOL_H */
+
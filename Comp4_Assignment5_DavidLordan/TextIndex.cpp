@@ -0,0 +1,446 @@
+/* File:   TextIndex.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the TextIndex class, an inverted index from
+ * the tokens of element content and attribute values to the elements they appear in.
+ *
+ * The index file is binary. It starts with a short header, the name of the XML
+ * file and the hash of the file, followed by every token in order, each storing
+ * the number of elements it appears in and their line numbers.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include "TextIndex.h"
+
+/** Written at the start of every index file, changed if the format ever changes. */
+static const char INDEX_HEADER[8] = {'D', 'J', 'L', 'I', 'N', 'D', 'X', '1'};
+
+/**
+ * Helper function to write a number to the index file contents.
+ * @param out - The index file contents, written to the file in one go once complete.
+ * @param value - The number to write.
+ */
+static void writeInt(string &out, int value) {
+    out.append((const char*) &value, sizeof (value));
+}
+
+/**
+ * Helper function to write a string to the index file contents, prefixed with its length.
+ * @param out - The index file contents, written to the file in one go once complete.
+ * @param str - The string to write.
+ */
+static void writeString(string &out, const string &str) {
+    writeInt(out, (int) str.size());
+    out.append(str);
+}
+
+/**
+ * Helper function to copy the next bytes of an index file which has been read
+ * into memory, checking that the end of the file has not been passed.
+ * @param data - The contents of the index file.
+ * @param pos - The position of the next byte to read. Passed by reference.
+ * @param dest - Where the bytes are copied to.
+ * @param count - The number of bytes to copy.
+ * @return - False if the index file ended early.
+ */
+static bool readBytes(const vector<char> &data, size_t &pos, void* dest, size_t count) {
+    if (data.size() - pos < count) {
+        return false;
+    }
+    if (count > 0) {
+        memcpy(dest, &data[pos], count);
+    }
+    pos += count;
+    return true;
+}
+
+/**
+ * Helper function to read the next length prefixed string of an index file.
+ * @param data - The contents of the index file.
+ * @param pos - The position of the next byte to read. Passed by reference.
+ * @param str - The string read. Passed by reference.
+ * @return - False if the index file ended early.
+ */
+static bool readString(const vector<char> &data, size_t &pos, string &str) {
+    int length = 0;
+    if (!readBytes(data, pos, &length, sizeof (length)) || length < 0 || data.size() - pos < (size_t) length) {
+        return false;
+    }
+    str.assign(&data[pos], length);
+    pos += length;
+    return true;
+}
+
+/**
+ * Helper function to narrow a list of matching elements down to those also in another list.
+ * @param matches - The line numbers of the matching elements, in order. Passed by reference.
+ * @param list - The line numbers of the elements to keep, in order.
+ */
+static void intersectWith(vector<int> &matches, const vector<int> &list) {
+    vector<int>::iterator end = set_intersection(matches.begin(), matches.end(),
+            list.begin(), list.end(), matches.begin());
+    matches.erase(end, matches.end());
+}
+
+/**
+ * Helper function to turn every ASCII letter of a string to lower case.
+ * @param str - The string to change. Passed by reference.
+ */
+static void toLower(string &str) {
+    for (string::iterator it = str.begin(); it != str.end(); ++it) {
+        if (*it >= 'A' && *it <= 'Z') {
+            *it = *it - 'A' + 'a';
+        }
+    }
+}
+
+/**
+ * Default constructor. The index starts empty.
+ */
+TextIndex::TextIndex() {
+    modified = false;
+}
+
+/**
+ * Standard destructor.
+ */
+TextIndex::~TextIndex() {
+}
+
+/**
+ * Function that splits text into tokens, runs of letters and digits in lower case.
+ * Bytes outside of ASCII are kept as part of a token so that accented letters
+ * do not split words.
+ * @param text - The text to split.
+ * @param tokens - The vector the tokens are added to. Passed by reference.
+ */
+void TextIndex::tokenize(const string &text, vector<string> &tokens) {
+    string token;
+
+    for (string::const_iterator it = text.begin(); it != text.end(); ++it) {
+        unsigned char c = *it;
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80) {
+            token += c;
+        } else if (c >= 'A' && c <= 'Z') {
+            token += c - 'A' + 'a';
+        } else if (!token.empty()) {
+            tokens.push_back(token);
+            token.clear();
+        }
+    }
+    if (!token.empty()) {
+        tokens.push_back(token);
+    }
+}
+
+/**
+ * Function that builds the name of the index file used for an XML file.
+ * The index is stored in the 'dist' folder next to the tree cache.
+ * @param strPath - The name of the XML file.
+ * @return - The name of the index file.
+ */
+string TextIndex::indexPath(const string &strPath) {
+    size_t slash = strPath.find_last_of("/\\");
+    if (slash == string::npos) {
+        return "dist/" + strPath + ".index";
+    }
+    return "dist/" + strPath.substr(slash + 1) + ".index";
+}
+
+/**
+ * Adds the content and attribute values of an element to the index.
+ * @param elem - The element to add, identified by the line it opens on.
+ */
+void TextIndex::addElement(const Element* elem) {
+    int lineNo = elem->getLineNo();
+    vector<string> tokens;
+
+    // Elements without content of their own hold the placeholder "Empty".
+    if (elem->getStrContent() != "Empty") {
+        tokenize(elem->getStrContent(), tokens);
+    }
+
+    // Finds each name="value" or name='value' pair in the raw attribute text.
+    const string &raw = elem->getRawAttributes();
+    size_t equals = raw.find('=');
+    while (equals != string::npos && equals + 1 < raw.size()) {
+        char quote = raw[equals + 1];
+        size_t valueEnd = (quote == '"' || quote == '\'') ? raw.find(quote, equals + 2) : string::npos;
+        if (valueEnd == string::npos) {
+            break;
+        }
+
+        size_t nameStart = raw.find_last_of(" \t", equals);
+        nameStart = (nameStart == string::npos) ? 0 : nameStart + 1;
+        string value = raw.substr(equals + 2, valueEnd - equals - 2);
+
+        string pair = raw.substr(nameStart, equals - nameStart) + '=' + value;
+        toLower(pair);
+        tokens.push_back(pair);
+        tokenize(value, tokens);
+
+        equals = raw.find('=', valueEnd + 1);
+    }
+
+    for (vector<string>::iterator it = tokens.begin(); it != tokens.end(); ++it) {
+        addPosting(*it, lineNo);
+    }
+}
+
+/**
+ * Adds every element below an element to the index. Used for trees which
+ * were not built line by line, such as a tree loaded from the cache.
+ * @param root - The element whose children are added. The element itself is not.
+ */
+void TextIndex::addTree(const Element* root) {
+    for (vector<Element*>::const_iterator it = root->vecChildren.begin(); it != root->vecChildren.end(); ++it) {
+        addElement(*it);
+        addTree(*it);
+    }
+}
+
+/**
+ * Removes every element opening between two lines from the index.
+ * @param first - The first line to remove.
+ * @param last - The last line to remove.
+ */
+void TextIndex::removeLines(int first, int last) {
+    map<string, vector<int> >::iterator it = postings.begin();
+    while (it != postings.end()) {
+        vector<int> &list = it->second;
+        list.erase(lower_bound(list.begin(), list.end(), first), upper_bound(list.begin(), list.end(), last));
+
+        if (list.empty()) {
+            postings.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+    modified = true;
+}
+
+/**
+ * Shifts the line numbers of every element opening after a line.
+ * @param afterLine - The last line which is left alone.
+ * @param delta - The number of lines added, or negative if lines were removed.
+ */
+void TextIndex::shiftLines(int afterLine, int delta) {
+    for (map<string, vector<int> >::iterator it = postings.begin(); it != postings.end(); ++it) {
+        vector<int> &list = it->second;
+        for (vector<int>::iterator line = upper_bound(list.begin(), list.end(), afterLine); line != list.end(); ++line) {
+            *line += delta;
+        }
+    }
+    modified = true;
+}
+
+/**
+ * Finds the elements containing every token of the passed text. If the text
+ * holds a '=', it is looked up whole as an attribute, such as 'id=1234'.
+ * @param text - The text to look up.
+ * @return - The line numbers of the matching elements, in order.
+ */
+vector<int> TextIndex::find(const string &text) const {
+    vector<string> tokens;
+    if (text.find('=') != string::npos) {
+        tokens.push_back(text);
+        toLower(tokens.back());
+    } else {
+        tokenize(text, tokens);
+    }
+
+    vector<int> matches;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        map<string, vector<int> >::const_iterator it = postings.find(tokens[i]);
+        if (it == postings.end()) {
+            return vector<int>();
+        }
+
+        if (i == 0) {
+            matches = it->second;
+        } else {
+            intersectWith(matches, it->second);
+        }
+    }
+    return matches;
+}
+
+/**
+ * Finds the elements containing every token of the passed text, where the
+ * last token only has to start a word in the element.
+ * @param text - The text to look up.
+ * @return - The line numbers of the matching elements, in order.
+ */
+vector<int> TextIndex::findPrefix(const string &text) const {
+    vector<string> tokens;
+    tokenize(text, tokens);
+    if (tokens.empty()) {
+        return vector<int>();
+    }
+
+    // Tokens are kept in order, so every token starting with the prefix comes
+    // straight after the first one that is not less than it.
+    string prefix = tokens.back();
+    tokens.pop_back();
+    vector<int> matches;
+    for (map<string, vector<int> >::const_iterator it = postings.lower_bound(prefix);
+            it != postings.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        matches.insert(matches.end(), it->second.begin(), it->second.end());
+    }
+    sort(matches.begin(), matches.end());
+    matches.erase(unique(matches.begin(), matches.end()), matches.end());
+
+    for (vector<string>::iterator token = tokens.begin(); token != tokens.end() && !matches.empty(); ++token) {
+        map<string, vector<int> >::const_iterator it = postings.find(*token);
+        if (it == postings.end()) {
+            return vector<int>();
+        }
+        intersectWith(matches, it->second);
+    }
+    return matches;
+}
+
+/**
+ * Saves the index to the index file of the passed XML file.
+ * @param strPath - The name of the XML file the index was built from.
+ * @param fileHash - The hash of the XML file, checked when the index is loaded.
+ * @return - True if the index file was written.
+ */
+bool TextIndex::save(const string &strPath, unsigned long long fileHash) {
+    ofstream os(indexPath(strPath).c_str(), ios::binary);
+
+    if (!os) {
+        return false;
+    }
+
+    // The contents are built up in memory and written with a single call.
+    string out;
+    out.append(INDEX_HEADER, sizeof (INDEX_HEADER));
+    writeString(out, strPath);
+    out.append((const char*) &fileHash, sizeof (fileHash));
+
+    writeInt(out, (int) postings.size());
+    for (map<string, vector<int> >::const_iterator it = postings.begin(); it != postings.end(); ++it) {
+        writeString(out, it->first);
+        writeInt(out, (int) it->second.size());
+        out.append((const char*) &it->second[0], it->second.size() * sizeof (int));
+    }
+
+    os.write(out.data(), out.size());
+    os.close();
+    if (os.fail()) {
+        return false;
+    }
+    modified = false;
+    return true;
+}
+
+/**
+ * Loads the index from the index file of the passed XML file, replacing
+ * anything in the index.
+ * @param strPath - The name of the XML file whose index is loaded.
+ * @param fileHash - The hash of the XML file the tree was built from.
+ * @return - False if there is no index, it could not be read, or it was built
+ *           from a different version of the file, in which case the index is empty.
+ */
+bool TextIndex::load(const string &strPath, unsigned long long fileHash) {
+    clear();
+    ifstream is(indexPath(strPath).c_str(), ios::binary | ios::ate);
+
+    if (!is) {
+        return false;
+    }
+
+    // The whole index is read in one go and then taken apart in memory.
+    vector<char> buffer((size_t) is.tellg());
+    is.seekg(0);
+    if (!buffer.empty()) {
+        is.read(&buffer[0], buffer.size());
+    }
+    is.close();
+
+    size_t pos = 0;
+    char header[sizeof (INDEX_HEADER)];
+    string name;
+    unsigned long long savedHash = 0;
+    int tokenCount = 0;
+
+    if (!readBytes(buffer, pos, header, sizeof (header))
+            || memcmp(header, INDEX_HEADER, sizeof (header)) != 0
+            || !readString(buffer, pos, name) || name != strPath
+            || !readBytes(buffer, pos, &savedHash, sizeof (savedHash)) || savedHash != fileHash
+            || !readBytes(buffer, pos, &tokenCount, sizeof (tokenCount)) || tokenCount < 0) {
+        return false;
+    }
+
+    // Tokens were saved in order, so each is added at the end of the map.
+    string token;
+    for (int i = 0; i < tokenCount; i++) {
+        int count = 0;
+        if (!readString(buffer, pos, token) || !readBytes(buffer, pos, &count, sizeof (count))
+                || count <= 0 || (buffer.size() - pos) / sizeof (int) < (size_t) count) {
+            clear();
+            return false;
+        }
+
+        vector<int> &list = postings.emplace_hint(postings.end(), token, vector<int>())->second;
+        list.resize(count);
+        readBytes(buffer, pos, &list[0], count * sizeof (int));
+    }
+
+    modified = false;
+    return true;
+}
+
+/**
+ * Removes every token from the index.
+ */
+void TextIndex::clear() {
+    if (!postings.empty()) {
+        modified = true;
+    }
+    postings.clear();
+}
+
+/**
+ * Checks if the index has changed since it was last loaded or saved.
+ * @return - True if it has changed.
+ */
+bool TextIndex::isModified() const {
+    return modified;
+}
+
+/**
+ * Gets the number of distinct tokens in the index.
+ * @return - The number of tokens.
+ */
+size_t TextIndex::getTokenCount() const {
+    return postings.size();
+}
+
+/**
+ * Function which adds an element to the list of a token, keeping the list
+ * in order and without repeats.
+ * @param token - The token.
+ * @param lineNo - The line the element opens on.
+ */
+void TextIndex::addPosting(const string &token, int lineNo) {
+    vector<int> &list = postings[token];
+    modified = true;
+
+    // While a file is parsed, elements arrive in line order and are added at the end.
+    if (list.empty() || list.back() < lineNo) {
+        list.push_back(lineNo);
+        return;
+    }
+
+    vector<int>::iterator it = lower_bound(list.begin(), list.end(), lineNo);
+    if (*it != lineNo) {
+        list.insert(it, lineNo);
+    }
+}
@@ -0,0 +1,158 @@
+/* File:   TextIndex.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the TextIndex class, an inverted index over the
+ * content and attribute values of the element tree. Text is split into tokens,
+ * runs of letters and digits in lower case, and each token maps to a sorted list
+ * of the elements it appears in. Every attribute is also indexed whole, as its
+ * name and value joined by '=', so an element can be found by an exact attribute.
+ *
+ * Elements are identified by the line they open on, since the parser only ever
+ * opens one element per line. Elements are added as they are created, in line
+ * order, so a list only has to be added to at its end while a file is parsed.
+ * When part of a cached tree is parsed again, the elements covering the changed
+ * lines are removed from the index and the line numbers after them shifted, in
+ * the same way as the tree. The index is saved next to the tree cache, along
+ * with a hash of the file it was built from.
+ */
+
+#ifndef TEXTINDEX_H
+#define	TEXTINDEX_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Element.h"
+
+using namespace std;
+
+class TextIndex {
+public:
+
+    /**
+     * Default constructor. The index starts empty.
+     */
+    TextIndex();
+
+    /**
+     * Standard destructor.
+     */
+    virtual ~TextIndex();
+
+    /**
+     * Function that splits text into tokens, runs of letters and digits in lower case.
+     * Bytes outside of ASCII are kept as part of a token so that accented letters
+     * do not split words.
+     * @param text - The text to split.
+     * @param tokens - The vector the tokens are added to. Passed by reference.
+     */
+    static void tokenize(const string &text, vector<string> &tokens);
+
+    /**
+     * Function that builds the name of the index file used for an XML file.
+     * The index is stored in the 'dist' folder next to the tree cache.
+     * @param strPath - The name of the XML file.
+     * @return - The name of the index file.
+     */
+    static string indexPath(const string &strPath);
+
+    /**
+     * Adds the content and attribute values of an element to the index.
+     * @param elem - The element to add, identified by the line it opens on.
+     */
+    void addElement(const Element* elem);
+
+    /**
+     * Adds every element below an element to the index. Used for trees which
+     * were not built line by line, such as a tree loaded from the cache.
+     * @param root - The element whose children are added. The element itself is not.
+     */
+    void addTree(const Element* root);
+
+    /**
+     * Removes every element opening between two lines from the index.
+     * @param first - The first line to remove.
+     * @param last - The last line to remove.
+     */
+    void removeLines(int first, int last);
+
+    /**
+     * Shifts the line numbers of every element opening after a line.
+     * @param afterLine - The last line which is left alone.
+     * @param delta - The number of lines added, or negative if lines were removed.
+     */
+    void shiftLines(int afterLine, int delta);
+
+    /**
+     * Finds the elements containing every token of the passed text. If the text
+     * holds a '=', it is looked up whole as an attribute, such as 'id=1234'.
+     * @param text - The text to look up.
+     * @return - The line numbers of the matching elements, in order.
+     */
+    vector<int> find(const string &text) const;
+
+    /**
+     * Finds the elements containing every token of the passed text, where the
+     * last token only has to start a word in the element.
+     * @param text - The text to look up.
+     * @return - The line numbers of the matching elements, in order.
+     */
+    vector<int> findPrefix(const string &text) const;
+
+    /**
+     * Saves the index to the index file of the passed XML file.
+     * @param strPath - The name of the XML file the index was built from.
+     * @param fileHash - The hash of the XML file, checked when the index is loaded.
+     * @return - True if the index file was written.
+     */
+    bool save(const string &strPath, unsigned long long fileHash);
+
+    /**
+     * Loads the index from the index file of the passed XML file, replacing
+     * anything in the index.
+     * @param strPath - The name of the XML file whose index is loaded.
+     * @param fileHash - The hash of the XML file the tree was built from.
+     * @return - False if there is no index, it could not be read, or it was built
+     *           from a different version of the file, in which case the index is empty.
+     */
+    bool load(const string &strPath, unsigned long long fileHash);
+
+    /**
+     * Removes every token from the index.
+     */
+    void clear();
+
+    /**
+     * Checks if the index has changed since it was last loaded or saved.
+     * @return - True if it has changed.
+     */
+    bool isModified() const;
+
+    /**
+     * Gets the number of distinct tokens in the index.
+     * @return - The number of tokens.
+     */
+    size_t getTokenCount() const;
+
+private:
+
+    /**
+     * Function which adds an element to the list of a token, keeping the list
+     * in order and without repeats.
+     * @param token - The token.
+     * @param lineNo - The line the element opens on.
+     */
+    void addPosting(const string &token, int lineNo);
+
+    /** The sorted list of elements each token appears in. */
+    map<string, vector<int> > postings;
+
+    /** Set when the index changes, cleared when it is loaded or saved. */
+    bool modified;
+};
+
+#endif	/* TEXTINDEX_H */
+
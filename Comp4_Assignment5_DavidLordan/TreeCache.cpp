@@ -0,0 +1,319 @@
+/* File:   TreeCache.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the TreeCache class, which saves a built element
+ * tree to a cache file and loads it back on the next run. Along with the tree,
+ * the cache stores a hash and the ending parser state of every line of the XML
+ * file. When the file is read again the hashes are compared to find which lines
+ * have changed, so that only the part of the tree covering those lines has to
+ * be parsed again.
+ *
+ * The cache file is binary. It starts with a short header and the name of the
+ * XML file, followed by the line records and then every element of the tree in
+ * order, each storing its line span, number of children, tag name, content and
+ * raw attribute text.
+ */
+
+#include <fstream>
+#include <cstring>
+#include <utility>
+#include "TreeCache.h"
+
+/** Written at the start of every cache file, changed if the format ever changes. */
+static const char CACHE_HEADER[8] = {'D', 'J', 'L', 'T', 'R', 'E', 'E', '1'};
+
+/**
+ * Helper function to write a number to the cache file contents.
+ * @param out - The cache file contents, written to the file in one go once complete.
+ * @param value - The number to write.
+ */
+static void writeInt(string &out, int value) {
+    out.append((const char*) &value, sizeof (value));
+}
+
+/**
+ * Helper function to write a string to the cache file contents, prefixed with its length.
+ * @param out - The cache file contents, written to the file in one go once complete.
+ * @param str - The string to write.
+ */
+static void writeString(string &out, const string &str) {
+    writeInt(out, (int) str.size());
+    out.append(str);
+}
+
+/**
+ * Helper class used to read numbers and strings back out of a cache file which
+ * has been read into memory. Every read checks that the end of the file has
+ * not been passed, so a damaged cache is not trusted.
+ */
+class CacheInput {
+public:
+
+    /**
+     * Custom constructor. Starts reading from the beginning of the passed buffer.
+     * @param buffer - The contents of the cache file.
+     */
+    CacheInput(const vector<char> &buffer) : pos(0), data(buffer), ok(true) {
+    }
+
+    /**
+     * Copies the next bytes of the cache file into the passed destination.
+     * @param dest - Where the bytes are copied to.
+     * @param count - The number of bytes to copy.
+     * @return - False if the cache file ended early.
+     */
+    bool readBytes(void* dest, size_t count) {
+        if (!ok || data.size() - pos < count) {
+            ok = false;
+            return false;
+        }
+        memcpy(dest, &data[pos], count);
+        pos += count;
+        return true;
+    }
+
+    /**
+     * Reads the next number from the cache file.
+     * @return - The number, or 0 if the cache file ended early.
+     */
+    int readInt() {
+        int value = 0;
+        readBytes(&value, sizeof (value));
+        return value;
+    }
+
+    /**
+     * Reads the next length prefixed string from the cache file.
+     * @return - The string, or an empty string if the cache file ended early.
+     */
+    string readString() {
+        int length = readInt();
+        if (!ok || length < 0 || data.size() - pos < (size_t) length) {
+            ok = false;
+            return "";
+        }
+        pos += length;
+        return string(&data[pos - length], length);
+    }
+
+    /** The position of the next byte to read. */
+    size_t pos;
+
+    /** The contents of the cache file. */
+    const vector<char> &data;
+
+    /** Cleared as soon as a read goes past the end of the cache file. */
+    bool ok;
+};
+
+/**
+ * Writes an element and, recursively, all of its children to the cache file contents.
+ * @param out - The cache file contents.
+ * @param currentElement - The element to write.
+ */
+static void writeElement(string &out, Element* currentElement) {
+    writeInt(out, currentElement->getLineNo());
+    writeInt(out, currentElement->getEndLineNo());
+    writeInt(out, (int) currentElement->vecChildren.size());
+    writeString(out, currentElement->getTagName());
+    writeString(out, currentElement->getStrContent());
+    writeString(out, currentElement->getRawAttributes());
+
+    for (vector<Element*>::iterator it = currentElement->vecChildren.begin();
+            it != currentElement->vecChildren.end(); ++it) {
+        writeElement(out, *it);
+    }
+}
+
+/**
+ * Reads an element and, recursively, all of its children from the cache file.
+ * The new element is added as a child of the passed parent.
+ * @param in - The cache file contents.
+ * @param parent - The element to which the new element is added.
+ * @return - False if the cache file ended early.
+ */
+static bool readElement(CacheInput &in, Element* parent) {
+    int lineNo = in.readInt();
+    int endLineNo = in.readInt();
+    int children = in.readInt();
+    string tagName = in.readString();
+    string content = in.readString();
+    string rawAttributes = in.readString();
+
+    if (!in.ok || children < 0) {
+        return false;
+    }
+
+    Element* ElementPtr = new Element(move(tagName), lineNo, move(content), rawAttributes);
+    ElementPtr->setEndLineNo(endLineNo);
+    parent->addChild(ElementPtr);
+    ElementPtr->setParent(parent);
+    ElementPtr->setLevel(parent->getLevel() + 1);
+
+    for (int i = 0; i < children; i++) {
+        if (!readElement(in, ElementPtr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Deletes an element and all of its children. Used to clean up after a cache
+ * file could not be read.
+ * @param currentElement - The element to delete.
+ */
+static void deleteElement(Element* currentElement) {
+    for (vector<Element*>::iterator it = currentElement->vecChildren.begin();
+            it != currentElement->vecChildren.end(); ++it) {
+        deleteElement(*it);
+    }
+    currentElement->vecChildren.clear();
+    delete currentElement;
+}
+
+/**
+ * Function that hashes a line of the XML file. Uses the 64-bit FNV-1a hash.
+ * @param line - The line to be hashed.
+ * @return - The hash of the line.
+ */
+unsigned long long TreeCache::hashLine(const string &line) {
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (string::const_iterator it = line.begin(); it != line.end(); ++it) {
+        hash ^= (unsigned char) *it;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Function that builds the name of the cache file used for an XML file.
+ * The cache is stored in the 'dist' folder, named after the XML file.
+ * @param strPath - The name of the XML file.
+ * @return - The name of the cache file.
+ */
+string TreeCache::cachePath(const string &strPath) {
+    string::size_type slash = strPath.find_last_of("/\\");
+
+    if (slash == string::npos) {
+        return "dist/" + strPath + ".cache";
+    }
+    return "dist/" + strPath.substr(slash + 1) + ".cache";
+}
+
+/**
+ * Function that works out a hash of the whole XML file from the hashes of its
+ * lines, used to check that other files saved next to the cache match it.
+ * @return - The hash of the file.
+ */
+unsigned long long TreeCache::fileHash() const {
+    unsigned long long hash = 14695981039346656037ULL;
+
+    for (vector<LineRecord>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+        const unsigned char* bytes = (const unsigned char*) &it->hash;
+        for (size_t i = 0; i < sizeof (it->hash); i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+/**
+ * Saves the line records and the element tree below the passed root to a cache file.
+ * @param strPath - The name of the XML file the tree was built from.
+ * @param root - The empty root whose children are saved.
+ * @return - True if the cache file was written.
+ */
+bool TreeCache::save(const string &strPath, Element* root) {
+    ofstream os(cachePath(strPath).c_str(), ios::binary);
+
+    if (!os) {
+        return false;
+    }
+
+    // The contents are built up in memory and written with a single call.
+    string out;
+    out.append(CACHE_HEADER, sizeof (CACHE_HEADER));
+    writeString(out, strPath);
+
+    writeInt(out, (int) lines.size());
+    if (!lines.empty()) {
+        out.append((const char*) &lines[0], lines.size() * sizeof (LineRecord));
+    }
+
+    writeInt(out, (int) root->vecChildren.size());
+    for (vector<Element*>::iterator it = root->vecChildren.begin();
+            it != root->vecChildren.end(); ++it) {
+        writeElement(out, *it);
+    }
+
+    os.write(out.data(), out.size());
+    os.close();
+    return !os.fail();
+}
+
+/**
+ * Loads the line records and element tree from the cache file of the passed XML file.
+ * The loaded elements are added as children of the passed root.
+ * @param strPath - The name of the XML file whose cache is loaded.
+ * @param root - The empty root to which the loaded elements are added.
+ * @return - False if there is no cache or it could not be read, in which
+ *           case nothing is added to the root.
+ */
+bool TreeCache::load(const string &strPath, Element* root) {
+    ifstream is(cachePath(strPath).c_str(), ios::binary | ios::ate);
+
+    if (!is) {
+        return false;
+    }
+
+    // The whole cache is read in one go and then taken apart in memory.
+    vector<char> buffer((size_t) is.tellg());
+    is.seekg(0);
+    if (!buffer.empty()) {
+        is.read(&buffer[0], buffer.size());
+    }
+    is.close();
+
+    CacheInput in(buffer);
+
+    char header[sizeof (CACHE_HEADER)];
+    if (!in.readBytes(header, sizeof (header))
+            || memcmp(header, CACHE_HEADER, sizeof (header)) != 0
+            || in.readString() != strPath) {
+        return false;
+    }
+
+    int lineCount = in.readInt();
+    if (!in.ok || lineCount < 0) {
+        return false;
+    }
+    lines.resize(lineCount);
+    if (lineCount > 0 && !in.readBytes(&lines[0], lineCount * sizeof (LineRecord))) {
+        lines.clear();
+        return false;
+    }
+
+    int children = in.readInt();
+    int before = root->getNoOfChildren();
+    bool ok = in.ok && children >= 0;
+
+    for (int i = 0; ok && i < children; i++) {
+        ok = readElement(in, root);
+    }
+
+    // If the cache ended early, everything that was loaded is thrown away.
+    if (!ok) {
+        for (int i = before; i < (int) root->vecChildren.size(); i++) {
+            deleteElement(root->vecChildren[i]);
+        }
+        root->removeChildren(before, (int) root->vecChildren.size());
+        lines.clear();
+    }
+    return ok;
+}
@@ -0,0 +1,83 @@
+/* File:   TreeCache.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the TreeCache class, which saves a built element
+ * tree to a cache file and loads it back on the next run. Along with the tree,
+ * the cache stores a hash and the ending parser state of every line of the XML
+ * file. When the file is read again the hashes are compared to find which lines
+ * have changed, so that only the part of the tree covering those lines has to
+ * be parsed again.
+ */
+
+#ifndef TREECACHE_H
+#define	TREECACHE_H
+
+#include <string>
+#include <vector>
+#include "Element.h"
+
+using namespace std;
+
+/**
+ * Structure storing what the cache knows about a single line of the XML file.
+ */
+struct LineRecord {
+    /** The hash of the line, before it is trimmed. */
+    unsigned long long hash;
+
+    /** The parser state after the line was parsed. */
+    int state;
+};
+
+class TreeCache {
+public:
+
+    /**
+     * Function that hashes a line of the XML file. Uses the 64-bit FNV-1a hash.
+     * @param line - The line to be hashed.
+     * @return - The hash of the line.
+     */
+    static unsigned long long hashLine(const string &line);
+
+    /**
+     * Function that builds the name of the cache file used for an XML file.
+     * The cache is stored in the 'dist' folder, named after the XML file.
+     * @param strPath - The name of the XML file.
+     * @return - The name of the cache file.
+     */
+    static string cachePath(const string &strPath);
+
+    /**
+     * Function that works out a hash of the whole XML file from the hashes of its
+     * lines, used to check that other files saved next to the cache match it.
+     * @return - The hash of the file.
+     */
+    unsigned long long fileHash() const;
+
+    /**
+     * Saves the line records and the element tree below the passed root to a cache file.
+     * @param strPath - The name of the XML file the tree was built from.
+     * @param root - The empty root whose children are saved.
+     * @return - True if the cache file was written.
+     */
+    bool save(const string &strPath, Element* root);
+
+    /**
+     * Loads the line records and element tree from the cache file of the passed XML file.
+     * The loaded elements are added as children of the passed root.
+     * @param strPath - The name of the XML file whose cache is loaded.
+     * @param root - The empty root to which the loaded elements are added.
+     * @return - False if there is no cache or it could not be read, in which
+     *           case nothing is added to the root.
+     */
+    bool load(const string &strPath, Element* root);
+
+    /** The hash and ending parser state of each line of the XML file. */
+    vector<LineRecord> lines;
+};
+
+#endif	/* TREECACHE_H */
+
@@ -0,0 +1,255 @@
+/* File:   TreeDiff.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the TreeDiff class, which compares the element
+ * trees of two versions of an XML file, passing over identical subtrees by their
+ * hashes, and lists the elements that were added, removed or changed.
+ */
+
+#include "TreeDiff.h"
+
+/**
+ * The largest table used to line up two runs of children by their hashes. Longer
+ * runs are paired by tag name alone.
+ */
+static const size_t MAX_ALIGNED_CELLS = 1 << 20;
+
+/**
+ * Default constructor. No changes are listed until 'compare' is called.
+ */
+TreeDiff::TreeDiff() {
+    elementsCompared = 0;
+}
+
+/**
+ * Standard destructor.
+ */
+TreeDiff::~TreeDiff() {
+}
+
+/**
+ * Compares two element trees, listing every change between them. The hashes
+ * of both trees must be up to date.
+ * @param oldRoot - The empty root of the tree of the old version of the file.
+ * @param newRoot - The empty root of the tree of the new version of the file.
+ */
+void TreeDiff::compare(Element* oldRoot, Element* newRoot) {
+    changes.clear();
+    elementsCompared = 0;
+
+    // The empty roots hold no text of their own, so only their children are compared.
+    compareChildren(oldRoot, newRoot);
+}
+
+/**
+ * Gets the changes found by the last call to 'compare', in the order of the new file.
+ * @return - The changes, by const reference.
+ */
+const vector<TreeChange>& TreeDiff::getChanges() const {
+    return changes;
+}
+
+/**
+ * Gets the number of pairs of elements compared by the last call to 'compare'.
+ * Elements inside identical subtrees are not counted.
+ * @return - The number of pairs.
+ */
+size_t TreeDiff::getElementsCompared() const {
+    return elementsCompared;
+}
+
+/**
+ * Writes the changes found by the last call to 'compare', with the line numbers
+ * of each element in the old and new files.
+ * @param os - The output stream the changes are written to.
+ */
+void TreeDiff::writeReport(ostream &os) const {
+    int added = 0;
+    int removed = 0;
+    int changed = 0;
+
+    for (vector<TreeChange>::const_iterator it = changes.begin(); it != changes.end(); ++it) {
+        switch (it->type) {
+            case ELEMENT_ADDED:
+            {
+                os << "Added element \"" << it->newElement->getTagName() << "\" at line "
+                        << it->newElement->getLineNo();
+                if (it->newElement->getEndLineNo() > it->newElement->getLineNo()) {
+                    os << " to " << it->newElement->getEndLineNo();
+                }
+                os << ".\n";
+                added++;
+                break;
+            }
+            case ELEMENT_REMOVED:
+            {
+                os << "Removed element \"" << it->oldElement->getTagName() << "\" from line "
+                        << it->oldElement->getLineNo();
+                if (it->oldElement->getEndLineNo() > it->oldElement->getLineNo()) {
+                    os << " to " << it->oldElement->getEndLineNo();
+                }
+                os << " of the old file.\n";
+                removed++;
+                break;
+            }
+            case ELEMENT_CHANGED:
+            {
+                os << "Changed element \"" << it->newElement->getTagName() << "\" at line "
+                        << it->newElement->getLineNo() << ", line " << it->oldElement->getLineNo()
+                        << " of the old file";
+                if (it->oldElement->getStrContent() != it->newElement->getStrContent()) {
+                    os << ", content \"" << it->oldElement->getStrContent() << "\" is now \""
+                            << it->newElement->getStrContent() << '"';
+                }
+                if (it->oldElement->getRawAttributes() != it->newElement->getRawAttributes()) {
+                    os << ", attributes changed";
+                }
+                os << ".\n";
+                changed++;
+                break;
+            }
+        }
+    }
+
+    if (changes.empty()) {
+        os << "The element trees are the same.\n";
+    } else {
+        os << added << " added, " << removed << " removed and " << changed << " changed.\n";
+    }
+    os << "Compared " << elementsCompared << " pairs of elements.\n";
+}
+
+/**
+ * Function which compares two elements with the same tag name, listing a change
+ * if their own text differs and then comparing their children.
+ * @param oldElement - The element in the old tree.
+ * @param newElement - The element in the new tree.
+ */
+void TreeDiff::compareElements(Element* oldElement, Element* newElement) {
+    elementsCompared++;
+
+    // Identical subtrees are passed over without looking inside them.
+    if (oldElement->getHash() == newElement->getHash()) {
+        return;
+    }
+
+    if (!oldElement->sameContent(*newElement)) {
+        TreeChange change = {ELEMENT_CHANGED, oldElement, newElement};
+        changes.push_back(change);
+    }
+    compareChildren(oldElement, newElement);
+}
+
+/**
+ * Function which lines up the children of two matching elements and compares them.
+ * @param oldParent - The element in the old tree.
+ * @param newParent - The element in the new tree.
+ */
+void TreeDiff::compareChildren(Element* oldParent, Element* newParent) {
+    const vector<Element*> &oldChildren = oldParent->vecChildren;
+    const vector<Element*> &newChildren = newParent->vecChildren;
+
+    // Passes over the children that are the same at the start and the end.
+    size_t first = 0;
+    while (first < oldChildren.size() && first < newChildren.size()
+            && oldChildren[first]->getHash() == newChildren[first]->getHash()) {
+        first++;
+    }
+    size_t oldLast = oldChildren.size();
+    size_t newLast = newChildren.size();
+    while (oldLast > first && newLast > first
+            && oldChildren[oldLast - 1]->getHash() == newChildren[newLast - 1]->getHash()) {
+        oldLast--;
+        newLast--;
+    }
+    elementsCompared += first + (oldChildren.size() - oldLast);
+
+    size_t rows = oldLast - first;
+    size_t cols = newLast - first;
+    if (rows == 0 || cols == 0 || (rows + 1) * (cols + 1) > MAX_ALIGNED_CELLS) {
+        pairChildren(oldChildren, first, oldLast, newChildren, first, newLast);
+        return;
+    }
+
+    // Finds the longest run of unchanged children common to both, in order. Each
+    // entry holds the length of the longest common run after that pair of children.
+    size_t width = cols + 1;
+    vector<unsigned int> table((rows + 1) * width, 0);
+    for (size_t i = rows; i-- > 0;) {
+        for (size_t j = cols; j-- > 0;) {
+            if (oldChildren[first + i]->getHash() == newChildren[first + j]->getHash()) {
+                table[i * width + j] = table[(i + 1) * width + j + 1] + 1;
+            } else {
+                table[i * width + j] = max(table[(i + 1) * width + j], table[i * width + j + 1]);
+            }
+        }
+    }
+
+    // Walks the table, pairing the children between each unchanged child by tag name.
+    size_t i = 0;
+    size_t j = 0;
+    size_t oldGap = 0;
+    size_t newGap = 0;
+    while (i < rows && j < cols) {
+        if (oldChildren[first + i]->getHash() == newChildren[first + j]->getHash()
+                && table[i * width + j] == table[(i + 1) * width + j + 1] + 1) {
+            pairChildren(oldChildren, first + oldGap, first + i, newChildren, first + newGap, first + j);
+            elementsCompared++;
+            i++;
+            j++;
+            oldGap = i;
+            newGap = j;
+        } else if (table[(i + 1) * width + j] >= table[i * width + j + 1]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    pairChildren(oldChildren, first + oldGap, oldLast, newChildren, first + newGap, newLast);
+}
+
+/**
+ * Function which pairs the children in a run of old children with those in a run
+ * of new children by tag name, in order. Paired children are compared, and the
+ * rest are listed as removed or added.
+ * @param oldChildren - The children of the old element.
+ * @param oldFirst - The first old child of the run.
+ * @param oldLast - The old child after the run.
+ * @param newChildren - The children of the new element.
+ * @param newFirst - The first new child of the run.
+ * @param newLast - The new child after the run.
+ */
+void TreeDiff::pairChildren(const vector<Element*> &oldChildren, size_t oldFirst, size_t oldLast,
+        const vector<Element*> &newChildren, size_t newFirst, size_t newLast) {
+    size_t next = newFirst;
+
+    for (size_t i = oldFirst; i < oldLast; i++) {
+
+        // Finds the next new child with the same tag name. Any new children
+        // passed over on the way were added.
+        size_t match = next;
+        while (match < newLast && newChildren[match]->getTagName() != oldChildren[i]->getTagName()) {
+            match++;
+        }
+        if (match == newLast) {
+            TreeChange change = {ELEMENT_REMOVED, oldChildren[i], NULL};
+            changes.push_back(change);
+            continue;
+        }
+
+        for (; next < match; next++) {
+            TreeChange change = {ELEMENT_ADDED, NULL, newChildren[next]};
+            changes.push_back(change);
+        }
+        compareElements(oldChildren[i], newChildren[match]);
+        next = match + 1;
+    }
+
+    for (; next < newLast; next++) {
+        TreeChange change = {ELEMENT_ADDED, NULL, newChildren[next]};
+        changes.push_back(change);
+    }
+}
@@ -0,0 +1,132 @@
+/* File:   TreeDiff.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the TreeDiff class, which compares the element trees
+ * of two versions of an XML file and lists the elements that were added, removed
+ * or changed. Every element carries the hash of its subtree, so two subtrees with
+ * the same hash are passed over without looking inside them, and the work done
+ * grows with the size of the changes rather than the size of the files.
+ *
+ * The children of two matching elements are lined up in three steps. Children at
+ * the start and the end with the same hashes are passed over first. The children
+ * left in the middle are lined up by their hashes, so that unchanged subtrees are
+ * matched even if others were added or removed around them. Between those, children
+ * with the same tag name are paired in order and compared in turn, and the rest
+ * are reported as added or removed.
+ */
+
+#ifndef TREEDIFF_H
+#define	TREEDIFF_H
+
+#include <iostream>
+#include <vector>
+#include "Element.h"
+
+using namespace std;
+
+/**
+ * The kinds of change found between two element trees.
+ */
+enum ChangeType {
+    ELEMENT_ADDED, ELEMENT_REMOVED, ELEMENT_CHANGED
+};
+
+/**
+ * Structure describing a single change between two element trees. An added or
+ * removed element stands for its whole subtree.
+ */
+struct TreeChange {
+    /** The kind of change. */
+    ChangeType type;
+
+    /** The element in the old tree, or NULL if the element was added. */
+    Element* oldElement;
+
+    /** The element in the new tree, or NULL if the element was removed. */
+    Element* newElement;
+};
+
+class TreeDiff {
+public:
+
+    /**
+     * Default constructor. No changes are listed until 'compare' is called.
+     */
+    TreeDiff();
+
+    /**
+     * Standard destructor.
+     */
+    virtual ~TreeDiff();
+
+    /**
+     * Compares two element trees, listing every change between them. The hashes
+     * of both trees must be up to date.
+     * @param oldRoot - The empty root of the tree of the old version of the file.
+     * @param newRoot - The empty root of the tree of the new version of the file.
+     */
+    void compare(Element* oldRoot, Element* newRoot);
+
+    /**
+     * Gets the changes found by the last call to 'compare', in the order of the new file.
+     * @return - The changes, by const reference.
+     */
+    const vector<TreeChange>& getChanges() const;
+
+    /**
+     * Gets the number of pairs of elements compared by the last call to 'compare'.
+     * Elements inside identical subtrees are not counted.
+     * @return - The number of pairs.
+     */
+    size_t getElementsCompared() const;
+
+    /**
+     * Writes the changes found by the last call to 'compare', with the line numbers
+     * of each element in the old and new files.
+     * @param os - The output stream the changes are written to.
+     */
+    void writeReport(ostream &os) const;
+
+private:
+
+    /**
+     * Function which compares two elements with the same tag name, listing a change
+     * if their own text differs and then comparing their children.
+     * @param oldElement - The element in the old tree.
+     * @param newElement - The element in the new tree.
+     */
+    void compareElements(Element* oldElement, Element* newElement);
+
+    /**
+     * Function which lines up the children of two matching elements and compares them.
+     * @param oldParent - The element in the old tree.
+     * @param newParent - The element in the new tree.
+     */
+    void compareChildren(Element* oldParent, Element* newParent);
+
+    /**
+     * Function which pairs the children in a run of old children with those in a run
+     * of new children by tag name, in order. Paired children are compared, and the
+     * rest are listed as removed or added.
+     * @param oldChildren - The children of the old element.
+     * @param oldFirst - The first old child of the run.
+     * @param oldLast - The old child after the run.
+     * @param newChildren - The children of the new element.
+     * @param newFirst - The first new child of the run.
+     * @param newLast - The new child after the run.
+     */
+    void pairChildren(const vector<Element*> &oldChildren, size_t oldFirst, size_t oldLast,
+            const vector<Element*> &newChildren, size_t newFirst, size_t newLast);
+
+    /** The changes found by the last call to 'compare'. */
+    vector<TreeChange> changes;
+
+    /** The number of pairs of elements compared by the last call to 'compare'. */
+    size_t elementsCompared;
+};
+
+#endif	/* TREEDIFF_H */
+
@@ -0,0 +1,122 @@
+#!/bin/bash
+# File:   countAllocations.sh
+# Author: David Lordan, UMass Lowell Computer Science
+# david_lordan@student.uml.edu
+#
+# Created on October 19th, 2026.
+#
+# Counts the memory allocations made while a file is parsed into the element
+# tree. The program is built with an 'operator new' which counts every call,
+# and 'openfile' is wrapped so that only the allocations made while it runs are
+# counted. The count is also given per line of the file, which is the number of
+# strings and vectors copied for each parsed line.
+#
+# Each version passed is a git revision, such as a commit before and after a
+# change, or 'work' for the files in this folder. The file is parsed from
+# scratch every time, since any tree cache is removed first.
+#
+# Usage: ./countAllocations.sh [-f <file.xml>] [<revision> ...]
+#        The file defaults to Assignment5_musicFile.xml and the version to 'work'.
+
+folder=$(cd "$(dirname "$0")" && pwd)
+input=$folder/Assignment5_musicFile.xml
+versions=()
+while [ $# -gt 0 ]; do
+    if [ "$1" = "-f" ]; then
+        input=$(cd "$(dirname "$2")" && pwd)/$(basename "$2")
+        shift 2
+    else
+        versions+=("$1")
+        shift
+    fi
+done
+if [ ${#versions[@]} -eq 0 ]; then
+    versions=(work)
+fi
+if [ ! -f "$input" ]; then
+    echo "The file '$input' does not exist." >&2
+    exit 1
+fi
+lines=$(wc -l < "$input")
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+# Counts every allocation made while 'countingAllocations' is set.
+cat > "$work/countNew.cpp" <<'COUNTER'
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+std::atomic<bool> countingAllocations(false);
+std::atomic<unsigned long long> allocationCount(0);
+std::atomic<unsigned long long> allocationBytes(0);
+
+void* operator new(size_t size) {
+    if (countingAllocations) {
+        allocationCount++;
+        allocationBytes += size;
+    }
+    void* memory = malloc(size == 0 ? 1 : size);
+    if (memory == NULL) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+COUNTER
+
+# Replaces 'openfile' with one which counts the allocations of the original.
+cat > "$work/wrapper.cpp" <<'WRAPPER'
+
+#include <atomic>
+extern std::atomic<bool> countingAllocations;
+extern std::atomic<unsigned long long> allocationCount;
+extern std::atomic<unsigned long long> allocationBytes;
+
+int openfile(string strPath) {
+    countingAllocations = true;
+    int status = openfileCounted(strPath);
+    countingAllocations = false;
+    fprintf(stderr, "%llu %llu\n", (unsigned long long) allocationCount, (unsigned long long) allocationBytes);
+    return status;
+}
+WRAPPER
+
+for version in "${versions[@]}"; do
+    build=$work/$version
+    mkdir -p "$build/dist"
+    if [ "$version" = "work" ]; then
+        cp "$folder"/*.cpp "$folder"/*.h "$build"
+    elif ! git -C "$folder" archive "$version" . | tar -x -C "$build"; then
+        echo "Could not read the revision '$version'." >&2
+        exit 1
+    fi
+
+    sed -i 's/^int openfile(string strPath) {$/int openfile(string strPath);\nint openfileCounted(string strPath) {/' "$build/main.cpp"
+    if ! grep -q openfileCounted "$build/main.cpp"; then
+        echo "The revision '$version' has no 'openfile' to count." >&2
+        exit 1
+    fi
+    cat "$work/wrapper.cpp" >> "$build/main.cpp"
+
+    if ! g++ -std=c++11 -O2 -o "$build/parse" "$build"/*.cpp "$work/countNew.cpp" -pthread -lz 2> "$build/errors.txt"; then
+        cat "$build/errors.txt" >&2
+        exit 1
+    fi
+
+    # The file is always read under the name the first versions of the program used.
+    cp "$input" "$build/Assignment5_musicFile.xml"
+    counts=$(cd "$build" && printf '2\n2\n2\n' | ./parse 2>&1 > /dev/null | tail -n 1)
+    echo "$counts" | awk -v version="$version" -v lines="$lines" '{
+        printf "%s: %d allocations, %.2f per line, %.1f MB, over %d lines\n",
+                version, $1, $1 / lines, $2 / 1048576, lines
+    }'
+done
@@ -32,7 +32,14 @@
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <thread>
 #include "Element.h"
+#include "BlockReader.h"
+#include "TreeCache.h"
+#include "CompressedFile.h"
+#include "SubtreePool.h"
+#include "TreeDiff.h"
+#include "TextIndex.h"
 
 using namespace std;
 
@@ -58,6 +65,30 @@ Element* emptyRoot = currentElement;
 /** A boolean value that stores whether or not the user wishes to see the tree being built.*/
 bool showProcessing = false;
 
+/**
+ * The cache of the element tree. Stores the hash and parser state of every line
+ * read, so that on the next run only the lines that have changed are parsed again.
+ */
+TreeCache treeCache;
+
+/** A boolean value that stores whether identical subtrees share one copy of their text. */
+bool shareSubtrees = false;
+
+/**
+ * The pool of complete subtrees, used while the tree is built to find identical
+ * subtrees when 'shareSubtrees' is set.
+ */
+SubtreePool subtreePool;
+
+/** A boolean value that stores whether the text of the elements is indexed as the tree is built. */
+bool indexText = false;
+
+/**
+ * The index of the content and attribute values of every element, built as the
+ * tree is built when 'indexText' is set and saved next to the tree cache.
+ */
+TextIndex textIndex;
+
 /** 
  * Enumeration for each of the possible states of XML document. These will be 
  *used extensively in the program to determine the context of a particular 
@@ -128,13 +159,15 @@ void ShowState(ParserState ps) {
  * (6) Attributes and their values are ignored. 
  * Much of this logic of this function is based on lecture notes of Prof. Jesse Heines of UML for 
  * the 91.204 Computing IV course. 
- * @param currentLine   - Most recent line read from XML file by 'openFile' function
+ * The extracted content and tag names are assigned straight out of the current line
+ * so that the strings passed by ref can reuse their storage from line to line. 
+ * @param currentLine   - Most recent line read from XML file by 'openFile' function. Passed by const ref.
  * @param currentState  - The current state of the parser as determined by the last line parsed.
  * @param content       - Used to store extracted content, if applicable. Passed by ref.
  * @param tagName       - Used to store extracted tag name, if applicable. Passed by ref.
  * @return              - The new parser state as determined by the algorithm in the function. 
  */
-ParserState parse(string currentLine, ParserState currentState, string &content, string &tagName) {
+ParserState parse(const string &currentLine, ParserState currentState, string &content, string &tagName) {
 
     //The function first determines if '>' is located in the current line, if not, the line must 
     //be a starting comment, in comment, or possibly unknown. 
@@ -173,20 +206,20 @@ ParserState parse(string currentLine, ParserState currentState, string &content,
             //Checks if '<' is really '<?', implying a directive. The directive
             //is extracted and DIRECTIVE returned. 
             if (currentLine[1] == '?') {
-                content = currentLine.substr(2, currentLine.rfind('?') - 2);
+                content.assign(currentLine, 2, currentLine.rfind('?') - 2);
 
                 return DIRECTIVE;
 
                 //Checks for one line comment, uses the 'content' variable, which
                 //Is passed by reference, to store the extracted comment.
             } else if (currentLine[1] == '!' && currentLine [2] == '-' && currentLine[3] == '-') {
-                content = currentLine.substr(4, currentLine.rfind('-') - 5);
+                content.assign(currentLine, 4, currentLine.rfind('-') - 5);
 
                 return ONE_LINE_COMMENT;
 
                 //Checks for closing tag, extracts tag name.
             } else if (currentLine[1] == '/') {
-                tagName = currentLine.substr(2, currentLine.find('>') - 2);
+                tagName.assign(currentLine, 2, currentLine.find('>') - 2);
                 return ELEMENT_CLOSING_TAG;
 
                 //Eliminating all other possibilities, the following now treats
@@ -194,18 +227,19 @@ ParserState parse(string currentLine, ParserState currentState, string &content,
                 // Either way, the tag name is extracted and stored in tagName.
             } else {
 
-                //Extracting of tag name.
-                tagName = currentLine.substr(1, currentLine.find('>') - 1);
-                tagName = tagName.substr(0, tagName.find(' '));
+                //Extracting of tag name. Cutting the string down with 'resize'
+                // works the same as taking a substring from the start of it.
+                tagName.assign(currentLine, 1, currentLine.find('>') - 1);
+                tagName.resize(min(tagName.size(), tagName.find(' ')));
 
                 //Checks for complete element, extracts the content
                 if (currentLine[currentLine.rfind('<') + 1] == '/') {
-                    content = currentLine.substr(currentLine.find('>') + 1, currentLine.find('/'));
-                    content = content.substr(0, content.find('/') - 1);
+                    content.assign(currentLine, currentLine.find('>') + 1, currentLine.find('/'));
+                    content.resize(min(content.size(), content.find('/') - 1));
                     return ELEMENT_NAME_AND_CONTENT;
                 }// Checks for self-closing tag extracts content.
                 else if (currentLine[currentLine.rfind('>') - 1] == '/') {
-                    tagName = tagName.substr(0, tagName.find('/'));
+                    tagName.resize(min(tagName.size(), tagName.find('/')));
                     content = ("{EMPTY}");
                     return SELF_CLOSING_TAG;
                 }// By elimination the line must be an opening tag, whos tag name
@@ -225,34 +259,28 @@ ParserState parse(string currentLine, ParserState currentState, string &content,
 
 /**
  * Trim leading and trailing white space (spaces and tabs) from the string
- * passed as an argument and return the trimmed string.
+ * passed as an argument. The string is trimmed in place, with one erase at
+ * each end, rather than copied and returned.
  * NOTE: This function was written by Prof. Jesse Heines of UMass Lowell 
  * for the Fall 2014 91.204-Computing IV class. 
- * @param str string to trim
- * @return  trimmed string
+ * @param str string to trim. Passed by ref.
  */
-string trim(string str) {
-    string::iterator it = str.begin();
-    while (*it == ' ' || *it == '\t') {
-        str.erase(str.begin());
-    }
-    it = str.end() - 1;
-    while (*it == ' ' || *it == '\t') {
-        str.erase(str.end() - 1);
-    }
-    return str;
+void trim(string &str) {
+    str.erase(0, str.find_first_not_of(" \t"));
+    str.erase(str.find_last_not_of(" \t") + 1);
 }
 
 /**
  * This function iterates through the elementVect, which is used as a stack,
  * displaying the current stack content. This is called whenever the stack content is changed.
  * @param elementVect   -   The vector which stores element pointers, used to implement a stack.
+ *                          Passed by const ref so the stack is not copied on every call.
  */
-void showStack(vector<Element*> elementVect) {
+void showStack(const vector<Element*> &elementVect) {
     cout << "*** The stack now contains: ";
 
     if (!elementVect.empty()) {
-        for (vector<Element*>::iterator it = elementVect.begin(); it != elementVect.end(); ++it) {
+        for (vector<Element*>::const_iterator it = elementVect.begin(); it != elementVect.end(); ++it) {
             cout << (*it)->getTagName();
 
             // Simply adds a period at the end of the list, otherwise the element
@@ -268,16 +296,45 @@ void showStack(vector<Element*> elementVect) {
     }
 }
 
+/**
+ * Function called once an element and everything below it is complete. Works out
+ * the hash of the element's subtree and, if the user asked for it, shares the
+ * element's text with an identical subtree.
+ * @param completed - The element whose subtree has just been completed.
+ */
+void completeElement(Element* completed) {
+    completed->updateHash();
+    if (shareSubtrees) {
+        subtreePool.share(completed);
+    }
+}
+
+/**
+ * Recursively works out the hash of every subtree below an element, children
+ * first. Used for trees which were not built line by line, such as a tree loaded
+ * from the cache.
+ * @param currentElement - The element whose children are hashed. Its own hash is left alone.
+ */
+void hashTree(Element* currentElement) {
+    for (vector<Element*>::iterator it = currentElement->vecChildren.begin();
+            it != currentElement->vecChildren.end(); ++it) {
+        hashTree(*it);
+        (*it)->updateHash();
+    }
+}
+
 /**
  * Function to process each line, building the element tree. If the user has chosen so,
  * the tree building itself will be displayed.
- * @param currentLine - The current line of an XML file which is to be processed.
+ * @param currentLine - The current line of an XML file which is to be processed. Passed by const ref.
  * @param currentState - The current parser state of the XML file. Used to give context to a line.
  * @param lineNumber - The line number on which the current line was found. 
  * @param content - The content within an element that was extracted from the 'parse' function.
+ *                  Passed by const ref.
  * @param tagName - The tag name that was extracted from an XML opening tag by the 'parse' function.
+ *                  Passed by const ref.
  */
-void proccesLine(string currentLine, ParserState &currentState, int lineNumber, string content, string tagName) {
+void proccesLine(const string &currentLine, ParserState &currentState, int lineNumber, const string &content, const string &tagName) {
 
 
     // Depending upon the current state, an appropriate output is displayed, 
@@ -341,6 +398,11 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
             // The current element is then set as the parent to the new element. 
             ElementPtr->setParent(currentElement);
 
+            // Elements are indexed as they are created, which is in line order.
+            if (indexText) {
+                textIndex.addElement(ElementPtr);
+            }
+
             // The new element is added to the element stack. 
             elementVect.push_back(ElementPtr);
 
@@ -356,7 +418,7 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
                     cout << "*** No parent found, creating root element: " << ElementPtr->getTagName() << endl;
                 }
 
-                if (!ElementPtr->vecAttribute.empty()) {
+                if (ElementPtr->hasAttributes()) {
                     cout << "*** Attributes found: " << endl;
                     ElementPtr->displayAttributes();
                 }
@@ -377,8 +439,12 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
 
             // Creates a new element and creates the parent/child relationship with the current element.
             Element* ElementPtr = new Element(tagName, lineNumber, content, currentLine);
+            ElementPtr->setEndLineNo(lineNumber);
             currentElement->addChild(ElementPtr);
             ElementPtr->setParent(currentElement);
+            if (indexText) {
+                textIndex.addElement(ElementPtr);
+            }
 
             if (showProcessing) {
                 cout << lineNumber << " : " << currentLine << endl;
@@ -388,7 +454,7 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
                 cout << "*** Creating new child: " << ElementPtr->getTagName()
                         << ", for parent: " << currentElement->getTagName() << endl;
 
-                if (!ElementPtr->vecAttribute.empty()) {
+                if (ElementPtr->hasAttributes()) {
                     cout << "*** Attributes found: " << endl;
                     ElementPtr->displayAttributes();
                 }
@@ -397,6 +463,9 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
             }
             // Sets the new element's level to be one higher than its parent. 
             ElementPtr->setLevel(ElementPtr->getParent()->getLevel() + 1);
+
+            // A complete element is a subtree of its own straight away.
+            completeElement(ElementPtr);
             break;
         }
 
@@ -423,6 +492,12 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
                 // the change. 
             else {
 
+                // Records the line the element was closed on, giving its span of lines.
+                elementVect.back()->setEndLineNo(lineNumber);
+
+                // Every child of the element has been closed, so its subtree is complete.
+                completeElement(elementVect.back());
+
                 // Sets the current element to be it's parent, moving up the tree. 
                 currentElement = currentElement->getParent();
 
@@ -442,8 +517,12 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
 
             // Creates a new element and sets up the parent/child relationship with the current element.
             Element* ElementPtr = new Element(tagName, lineNumber, "Empty", currentLine);
+            ElementPtr->setEndLineNo(lineNumber);
             currentElement->addChild(ElementPtr);
             ElementPtr->setParent(currentElement);
+            if (indexText) {
+                textIndex.addElement(ElementPtr);
+            }
 
             if (showProcessing) {
                 cout << lineNumber << " : " << currentLine << endl;
@@ -453,7 +532,7 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
                 cout << "*** Creating new child: " << ElementPtr->getTagName()
                         << ", for parent: " << currentElement->getTagName() << endl;
 
-                if (!ElementPtr->vecAttribute.empty()) {
+                if (ElementPtr->hasAttributes()) {
                     cout << "*** Attributes found: " << endl;
                     ElementPtr->displayAttributes();
                 }
@@ -462,6 +541,8 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
 
             // Sets the new element's level to be one level higher that it's parent. 
             ElementPtr->setLevel(ElementPtr->getParent()->getLevel() + 1);
+
+            completeElement(ElementPtr);
             break;
         }
 
@@ -493,6 +574,10 @@ void proccesLine(string currentLine, ParserState &currentState, int lineNumber,
  * This function opens and reads the passed text file, line by line. As each line
  * is taken from the input file, leading white space is removed, the current state
  * is determined by calling the 'parse' function, and the line is processed.
+ * The file is read with a 'BlockReader', which reads the next block of the file
+ * on a background thread while the current block is being parsed, decompressing
+ * it first if the file is compressed. The hash and
+ * parser state of each line are recorded in 'treeCache' so the tree can be cached.
  * The 'processLine' function will also display relevant information about the 
  * current line. As each line is processed, an element tree is created.
  * @param strPath - The name of the file to be read.
@@ -504,10 +589,9 @@ int openfile(string strPath) {
     // to parse and process each line. Initialized to STARTING_DOCUMENT. 
     ParserState currentState = STARTING_DOCUMENT;
 
-    //Creates an object of the class ifstream and uses it to open the passed
-    // file name. 
-    ifstream infile;
-    infile.open(strPath);
+    //Creates a BlockReader and uses it to open the passed file name. The reader
+    // starts reading the file ahead on its own thread. 
+    BlockReader infile(strPath);
 
     //Initializes a string to store the current line being processed and 
     //initializes a line number counter. 
@@ -516,7 +600,7 @@ int openfile(string strPath) {
 
     //The entire top line of the passed file is removed and stored in the
     //variable "currentLine".
-    getline(infile, currentLine);
+    infile.getLine(currentLine);
 
     // These strings are used to store content and tag names extracted by the
     // 'currentState' function, which are then passed into the 'proccessLine'
@@ -532,9 +616,13 @@ int openfile(string strPath) {
     // well-formed. 
     while (!currentLine.empty() && currentState != ERROR && currentState != UNKNOWN) {
 
+        // The line is hashed before it is trimmed, so any change to it is noticed
+        // when the file is checked against its cache.
+        unsigned long long lineHash = TreeCache::hashLine(currentLine);
+
         //Passes the current line the trim function, removing any white space
         // and/or tabs in the line. 
-        currentLine = trim(currentLine);
+        trim(currentLine);
 
         // The current state is determined by the state returned from the previous
         // line and the text on the current line. 'Content' and 'tagName' are
@@ -545,12 +633,20 @@ int openfile(string strPath) {
         // information and updates the element pointer stack, 'elementVect' .
         proccesLine(currentLine, currentState, lineNumber, content, tagName);
 
+        LineRecord record = {lineHash, currentState};
+        treeCache.lines.push_back(record);
+
         //Increments the line number, gets the next line of the file.
         lineNumber++;
-        getline(infile, currentLine);
+        infile.getLine(currentLine);
+    }
+
+    // A compressed file which could not be decompressed to its end leaves the
+    // tree unfinished, even if every line read so far was well-formed.
+    if (infile.hasFailed()) {
+        cout << "The file '" << strPath << "' could not be decompressed." << endl;
+        return EXIT_FAILURE;
     }
-    //Closes the input file.
-    infile.close();
 
     // If after reading the XML file the current state is "ERROR", the function
     // returns the appropriate exit status. 
@@ -577,52 +673,54 @@ void clearVectorContents(vector <Element*> &vect) {
 
 /**
  * Function that is called recursively to output the element tree, which is already stored
- * in it's entirety in memory. 
+ * in it's entirety in memory. Lines are ended with '\n' rather than 'endl' so the
+ * stream is not flushed for every element. 
  * @param currentElement - The current element whose information is to be displayed. 
+ * @param os - The output stream the tree is written to. Passed by reference. 
  */
-void displayTree(Element* currentElement) {
+void displayTree(Element* currentElement, ostream &os) {
 
     // Begins tree output. 
     if (currentElement != emptyRoot) {
 
         for (int i = 1; i < currentElement->getLevel(); i++) {
-            cout << ".";
+            os << ".";
         }
-        cout << "Element \"" << currentElement->getTagName()
+        os << "Element \"" << currentElement->getTagName()
                 << "\" was found at line " << currentElement->getLineNo()
                 << ", level " << currentElement->getLevel();
         if (currentElement->getStrContent() == "Empty")
-            cout << ", with no content";
+            os << ", with no content";
         else
-            cout << ", containing \"" << currentElement->getStrContent() << '"';
-        cout << " and " << currentElement->getNoOfChildren();
+            os << ", containing \"" << currentElement->getStrContent() << '"';
+        os << " and " << currentElement->getNoOfChildren();
         if (currentElement->getNoOfChildren() == 1)
-            cout << " child";
+            os << " child";
         else
-            cout << " children";
+            os << " children";
 
         if (currentElement->hasAttributes()) {
 
-            cout << ", along with " << currentElement->vecAttribute.size();
+            os << ", along with " << currentElement->getAttributes().size();
 
-            if (currentElement->vecAttribute.size() == 1)
-                cout << " attribute: " << endl;
+            if (currentElement->getAttributes().size() == 1)
+                os << " attribute: \n";
             else
-                cout << " attributes: " << endl;
+                os << " attributes: \n";
 
-            currentElement->displayAttributes();
+            currentElement->displayAttributes(os);
         } else
-            cout << "." << endl;
+            os << ".\n";
 
-        cout << endl;
+        os << '\n';
     }// If the current element is the emptyRoot, which should be the parameter the first time this
         // function is called, then the user is told that the element tree has started to be displayed. 
     else {
         //Displays a line of '*' to separate the display of the tree building process
         for (int i = 0; i < 40; i++) {
-            cout << "*";
+            os << "*";
         }
-        cout << endl << endl << "Now showing the element tree:" << endl << endl;
+        os << "\n\nNow showing the element tree:\n\n";
     }
 
     // Checks if the current element has children, if so, the program iterates through
@@ -632,7 +730,7 @@ void displayTree(Element* currentElement) {
         for (vector<Element*>::iterator it = currentElement->vecChildren.begin();
                 it != currentElement->vecChildren.end(); ++it) {
 
-            displayTree(*it);
+            displayTree(*it, os);
 
         }
     }
@@ -652,9 +750,364 @@ void deleteTree(Element* currentElement) {
             deleteTree(*it);
         }
     }
-    delete currentElement;
     currentElement->vecChildren.clear();
+    delete currentElement;
+
+}
 
+/**
+ * Deletes every element of the tree below the empty root and resets the stack,
+ * leaving the program as it was before any file was read. Used when a cached
+ * tree cannot be brought up to date and the file has to be parsed in full.
+ */
+void clearTree() {
+    for (vector<Element*>::iterator it = emptyRoot->vecChildren.begin();
+            it != emptyRoot->vecChildren.end(); ++it) {
+        deleteTree(*it);
+    }
+    emptyRoot->removeChildren(0, emptyRoot->getNoOfChildren());
+    elementVect.clear();
+    currentElement = emptyRoot;
+    treeCache.lines.clear();
+    textIndex.clear();
+}
+
+/**
+ * Moves every element of the tree below the empty root under a new element and
+ * resets the stack, so that another file can be read while the tree is kept.
+ * Used to compare two versions of a file.
+ * @return - The new element holding the tree. Deleted with 'deleteTree'.
+ */
+Element* detachTree() {
+    Element* detachedRoot = new Element;
+    for (vector<Element*>::iterator it = emptyRoot->vecChildren.begin();
+            it != emptyRoot->vecChildren.end(); ++it) {
+        (*it)->setParent(detachedRoot);
+        detachedRoot->addChild(*it);
+    }
+    emptyRoot->removeChildren(0, emptyRoot->getNoOfChildren());
+    elementVect.clear();
+    currentElement = emptyRoot;
+    treeCache.lines.clear();
+    textIndex.clear();
+    return detachedRoot;
+}
+
+/**
+ * Checks if a parser state means that the parser is inside a comment. A part of
+ * the file can only be parsed again on its own if it does not start or end
+ * inside a comment.
+ * @param state - The parser state to check.
+ * @return - True if the state is inside a comment.
+ */
+bool inComment(int state) {
+    return state == STARTING_COMMENT || state == IN_COMMENT;
+}
+
+/**
+ * Recursively shifts the line numbers of every element that comes after a
+ * re-parsed part of the file, by the number of lines that were added or removed.
+ * Elements that end before the re-parsed part are skipped along with their children.
+ * @param currentElement - The element whose line numbers are to be shifted.
+ * @param afterLine - The last line of the re-parsed part, in the old file.
+ * @param delta - The number of lines added, or negative if lines were removed.
+ */
+void shiftLines(Element* currentElement, int afterLine, int delta) {
+    if (currentElement->getLineNo() > afterLine) {
+        currentElement->setLineNo(currentElement->getLineNo() + delta);
+    }
+    if (currentElement->getEndLineNo() > afterLine) {
+        currentElement->setEndLineNo(currentElement->getEndLineNo() + delta);
+    }
+
+    for (vector<Element*>::reverse_iterator it = currentElement->vecChildren.rbegin();
+            it != currentElement->vecChildren.rend() && (*it)->getEndLineNo() > afterLine; ++it) {
+        shiftLines(*it, afterLine, delta);
+    }
+}
+
+/**
+ * Function to bring a tree loaded from the cache up to date with the XML file.
+ * The lines of the file are hashed and compared with the cached hashes to find
+ * the lines that have changed. The deepest element whose opening and closing tags
+ * are both outside of the changed lines is found, and only its children that
+ * cover the changed lines are parsed again and spliced back into the tree.
+ * @param strPath - The name of the file to be read.
+ * @return - False if the tree could not be brought up to date, in which case
+ *           the file must be parsed in full.
+ */
+bool reparseChanges(const string &strPath) {
+
+    // Reads the file the same way as 'openfile', stopping at the first empty line.
+    // The lines are kept one after another in a single string, along with where
+    // each of them starts, so that the lines to be re-parsed can be found again.
+    BlockReader infile(strPath);
+    string newText;
+    vector<size_t> lineStarts;
+    vector<unsigned long long> newHashes;
+    string currentLine;
+
+    infile.getLine(currentLine);
+    while (!currentLine.empty()) {
+        newHashes.push_back(TreeCache::hashLine(currentLine));
+        lineStarts.push_back(newText.size());
+        newText.append(currentLine);
+        infile.getLine(currentLine);
+    }
+    lineStarts.push_back(newText.size());
+
+    // A compressed file which could not be read in full is left to 'openfile'
+    // to report.
+    if (infile.hasFailed()) {
+        return false;
+    }
+
+    vector<LineRecord> &oldLines = treeCache.lines;
+    int oldCount = oldLines.size();
+    int newCount = newHashes.size();
+
+    // Counts the lines that are unchanged at the start and the end of the file.
+    int prefix = 0;
+    while (prefix < oldCount && prefix < newCount && oldLines[prefix].hash == newHashes[prefix]) {
+        prefix++;
+    }
+
+    if (prefix == oldCount && prefix == newCount) {
+        cout << "Building tree for file: " << strPath << "..." << endl;
+        cout << "File unchanged, using the cached tree." << endl << endl;
+        return true;
+    }
+
+    int suffix = 0;
+    while (suffix < oldCount - prefix && suffix < newCount - prefix
+            && oldLines[oldCount - 1 - suffix].hash == newHashes[newCount - 1 - suffix]) {
+        suffix++;
+    }
+
+    // The changed lines in the old file. If lines were only inserted, 'lastChanged'
+    // is one less than 'firstChanged'.
+    int firstChanged = prefix + 1;
+    int lastChanged = oldCount - suffix;
+    int delta = newCount - oldCount;
+
+    // Finds the deepest element that has both its opening and closing tags
+    // outside of the changed lines. Children are in line order, so the only
+    // child that can contain the change is the last one opened before it.
+    Element* parent = emptyRoot;
+    while (true) {
+        vector<Element*> &kids = parent->vecChildren;
+        vector<Element*>::iterator it = partition_point(kids.begin(), kids.end(),
+                [firstChanged](Element * e) {
+                    return e->getLineNo() < firstChanged; });
+
+        if (it == kids.begin()) {
+            break;
+        }
+        Element* candidate = *(it - 1);
+        if (candidate->getEndLineNo() <= lastChanged || candidate->getEndLineNo() == candidate->getLineNo()) {
+            break;
+        }
+        parent = candidate;
+    }
+
+    // Finds the range of the parent's children which cover the changed lines.
+    // If the part to re-parse would start or end inside a comment, it is widened
+    // to the parent itself, moving up the tree.
+    int firstKid;
+    int lastKid;
+    int regionStart;
+    int regionEnd;
+
+    while (true) {
+        vector<Element*> &kids = parent->vecChildren;
+        firstKid = partition_point(kids.begin(), kids.end(),
+                [firstChanged](Element * e) {
+                    return e->getEndLineNo() < firstChanged; }) - kids.begin();
+        lastKid = partition_point(kids.begin(), kids.end(),
+                [lastChanged](Element * e) {
+                    return e->getLineNo() <= lastChanged; }) - kids.begin();
+
+        regionStart = firstChanged;
+        regionEnd = lastChanged;
+        if (firstKid < lastKid) {
+            regionStart = min(regionStart, kids[firstKid]->getLineNo());
+            regionEnd = max(regionEnd, kids[lastKid - 1]->getEndLineNo());
+        }
+
+        bool startsInComment = regionStart > 1 && inComment(oldLines[regionStart - 2].state);
+        bool endsInComment = regionEnd >= 1 && inComment(oldLines[regionEnd - 1].state);
+
+        if (!startsInComment && !endsInComment) {
+            break;
+        }
+        if (parent == emptyRoot) {
+            return false;
+        }
+        firstChanged = parent->getLineNo();
+        lastChanged = parent->getEndLineNo();
+        parent = parent->getParent();
+    }
+
+    // Removes the children that cover the changed lines.
+    for (int i = firstKid; i < lastKid; i++) {
+        deleteTree(parent->vecChildren[i]);
+    }
+    parent->removeChildren(firstKid, lastKid);
+
+    // Shifts the line numbers of everything after the changed lines before the
+    // new children are added, as they are already numbered for the new file.
+    if (delta != 0) {
+        shiftLines(emptyRoot, regionEnd, delta);
+    }
+
+    // The index is changed the same way, leaving the new children to be indexed
+    // as they are parsed.
+    if (indexText) {
+        textIndex.removeLines(regionStart, regionEnd);
+        if (delta != 0) {
+            textIndex.shiftLines(regionEnd, delta);
+        }
+    }
+
+    // Sets up the stack and current element as they were when the first line
+    // of the part being re-parsed was reached.
+    elementVect.clear();
+    for (Element* e = parent; e != emptyRoot; e = e->getParent()) {
+        elementVect.push_back(e);
+    }
+    reverse(elementVect.begin(), elementVect.end());
+    size_t depth = elementVect.size();
+    currentElement = parent;
+    int childrenBefore = parent->getNoOfChildren();
+
+    ParserState currentState = (regionStart > 1) ? (ParserState) oldLines[regionStart - 2].state : STARTING_DOCUMENT;
+    string content;
+    string tagName;
+    vector<LineRecord> newRecords;
+
+    for (int lineNumber = regionStart; lineNumber <= regionEnd + delta; lineNumber++) {
+        currentLine.assign(newText, lineStarts[lineNumber - 1],
+                lineStarts[lineNumber] - lineStarts[lineNumber - 1]);
+        trim(currentLine);
+        currentState = parse(currentLine, currentState, content, tagName);
+
+        // The part being re-parsed must not close any element that it did not open.
+        if (currentState == ELEMENT_CLOSING_TAG && elementVect.size() <= depth) {
+            return false;
+        }
+
+        proccesLine(currentLine, currentState, lineNumber, content, tagName);
+
+        if (currentState == ERROR || currentState == UNKNOWN) {
+            return false;
+        }
+
+        LineRecord record = {newHashes[lineNumber - 1], currentState};
+        newRecords.push_back(record);
+    }
+
+    // Every element opened in the re-parsed part must also have been closed in it.
+    if (currentElement != parent || elementVect.size() != depth || inComment(currentState)) {
+        return false;
+    }
+
+    // Moves the new children, which were added at the end, into the place of the removed ones.
+    rotate(parent->vecChildren.begin() + firstKid, parent->vecChildren.begin() + childrenBefore,
+            parent->vecChildren.end());
+
+    // The new children were hashed as they were closed, which leaves only the
+    // elements above them to be hashed again.
+    for (Element* e = parent; e != emptyRoot; e = e->getParent()) {
+        e->updateHash();
+    }
+
+    // Replaces the line records of the re-parsed part.
+    oldLines.erase(oldLines.begin() + (regionStart - 1), oldLines.begin() + regionEnd);
+    oldLines.insert(oldLines.begin() + (regionStart - 1), newRecords.begin(), newRecords.end());
+
+    elementVect.clear();
+    currentElement = emptyRoot;
+    treeCache.save(strPath, emptyRoot);
+
+    cout << "Building tree for file: " << strPath << "..." << endl;
+    cout << "Re-parsed lines " << regionStart << " to " << (regionEnd + delta)
+            << " of " << newCount << " using the cached tree." << endl << endl;
+    return true;
+}
+
+/**
+ * Function to tell the user how much was saved by sharing identical subtrees,
+ * if they asked for subtrees to be shared.
+ */
+void showSharing() {
+    if (shareSubtrees) {
+        cout << "Shared the text of " << subtreePool.getElementsShared() << " of "
+                << subtreePool.getElementsSeen() << " elements with identical subtrees, saving about "
+                << subtreePool.getBytesSaved() / 1024 << " KB." << endl << endl;
+    }
+}
+
+/**
+ * Function to save the text index next to the tree cache, if the text is being
+ * indexed and the index has changed since it was loaded.
+ * @param strPath - The name of the file the tree was built from.
+ */
+void saveIndex(const string &strPath) {
+    if (indexText && textIndex.isModified()) {
+        textIndex.save(strPath, treeCache.fileHash());
+    }
+}
+
+/**
+ * Function to build the element tree for the passed file. If the file has a
+ * cache from an earlier run, the cached tree is loaded and only the lines that
+ * have changed are parsed again. Otherwise, or if the building process is being
+ * displayed, the whole file is parsed with 'openfile' and the cache is saved.
+ * If 'shareSubtrees' is set, identical subtrees share their text once built,
+ * and if 'indexText' is set, the text index is built or brought up to date along with the tree.
+ * @param strPath - The name of the file to be read.
+ * @return Status flag - EXIT_SUCCESS if the tree was built. 
+ */
+int buildTree(const string &strPath) {
+
+    // Every line has to be processed to display the building process, so the
+    // cache is only used when it is not being displayed.
+    if (!showProcessing && treeCache.load(strPath, emptyRoot)) {
+
+        // The cached tree was not built line by line, so its subtrees are hashed
+        // and shared all at once. The pool is emptied before any of the tree is replaced.
+        hashTree(emptyRoot);
+        if (shareSubtrees) {
+            subtreePool.shareTree(emptyRoot);
+            subtreePool.clear();
+        }
+
+        // The saved index only matches the cached tree if both were saved from the
+        // same version of the file, otherwise it is built from the cached tree.
+        if (indexText && !textIndex.load(strPath, treeCache.fileHash())) {
+            textIndex.addTree(emptyRoot);
+        }
+
+        bool reparsed = reparseChanges(strPath);
+        subtreePool.clear();
+        if (reparsed) {
+            saveIndex(strPath);
+            showSharing();
+            return EXIT_SUCCESS;
+        }
+        clearTree();
+        subtreePool.reset();
+    }
+
+    int status = openfile(strPath);
+    subtreePool.clear();
+
+    if (status == EXIT_SUCCESS) {
+        treeCache.save(strPath, emptyRoot);
+        saveIndex(strPath);
+        showSharing();
+    }
+    return status;
 }
 
 /**
@@ -735,7 +1188,7 @@ bool askOutputFormat() {
  * @param currentElement - The current element who's level is be checked.
  * @param os - The output stream of a JSON file. Passed by reference. 
  */
-void addSpaces(Element* currentElement, ofstream &os) {
+void addSpaces(Element* currentElement, ostream &os) {
     for (int i = 0; i < currentElement->getLevel(); i++) {
         os << " ";
     }
@@ -747,12 +1200,11 @@ void addSpaces(Element* currentElement, ofstream &os) {
  * and is not part of the assignment's requirements. This is virtually identical
  * to the algorithm in the 'displayTree' function.
  * @param currentElement - The current element whose data is to be written to the HTML file. 
- * @param os - ofstream object that is sent recursively to the function. Passed by reference.
+ * @param os - Output stream that is sent recursively to the function. Passed by reference.
  */
-void writeHTML(Element* currentElement, ofstream &os) {
+void writeHTML(Element* currentElement, ostream &os) {
 
     if (currentElement == emptyRoot) {
-        cout << "Now outputting the element tree as an HTML file..." << endl;
         // If the current element is the root, standard opening code for an html file is written. 
         os << "<!DOCTYPE html>\n<html lang=\"en\">\n\n<head>\n <title></title>\n"
                 " <meta charset=\"utf-8\">\n</head>\n<body>\n";
@@ -779,15 +1231,15 @@ void writeHTML(Element* currentElement, ofstream &os) {
 
         if (currentElement->hasAttributes()) {
 
-            os << ", along with " << currentElement->vecAttribute.size();
+            os << ", along with " << currentElement->getAttributes().size();
 
-            if (currentElement->vecAttribute.size() == 1)
+            if (currentElement->getAttributes().size() == 1)
                 os << " attribute: ";
             else
                 os << " attributes: ";
 
-            for (vector<Attribute*>::iterator it = currentElement->vecAttribute.begin();
-                    it != currentElement->vecAttribute.end(); it++) {
+            for (vector<Attribute*>::iterator it = currentElement->getAttributes().begin();
+                    it != currentElement->getAttributes().end(); it++) {
                 os << "</div>";
                 os << "<div>";
                 for (int j = 1; j < currentElement->getLevel(); j++) {
@@ -818,12 +1270,9 @@ void writeHTML(Element* currentElement, ofstream &os) {
         }
     }
 
-    // After the function has returned to the empty root, the ofstream is closed. 
+    // After the function has returned to the empty root, the body is closed. 
     if (currentElement == emptyRoot) {
         os << "</body>";
-        os.close();
-        cout << "HTML output complete." << endl;
-        cout << "File 'DJL_Assn05_Element_Tree.html' written to the folder dist." << endl;
     }
 }
 
@@ -833,13 +1282,13 @@ void writeHTML(Element* currentElement, ofstream &os) {
  * that allow for proper JSON syntax. The function is called recursively, traversing
  * the entire element tree and creating a matching JSON structure. 
  * @param currentElement - The element whose children and attributes are to be written to the JSON file.
+ * The tree itself is not changed, so it may be written at the same time as the other formats.
  * @param os - The output stream to the JSON file. Passed by reference. 
  */
-void writeJSON(Element* currentElement, ofstream &os) {
+void writeJSON(Element* currentElement, ostream &os) {
 
 
     if (currentElement == emptyRoot) {
-        cout << "Now outputting the element tree as a JSON file..." << endl;
         os << "{\n";
     } else { //Checks if the current element is a parent. If so, the output is 
         //formatted to get ready to display its attributes and children. 
@@ -847,8 +1296,8 @@ void writeJSON(Element* currentElement, ofstream &os) {
             addSpaces(currentElement, os);
             os << "\"" << currentElement->getTagName() << "\":{\n";
 
-            for (vector<Attribute*>::iterator it = currentElement->vecAttribute.begin();
-                    it != currentElement->vecAttribute.end(); it++) {
+            for (vector<Attribute*>::iterator it = currentElement->getAttributes().begin();
+                    it != currentElement->getAttributes().end(); it++) {
                 addSpaces(currentElement, os);
                 os << "\"" << (*it)->getAttName() << "\":";
                 os << "\"" << (*it)->getAttValue() << "\",\n";
@@ -863,19 +1312,22 @@ void writeJSON(Element* currentElement, ofstream &os) {
 
             /* Several musicbrainz XML files have double quotes in the element
             // content, (12" Vinyl for example), the following algorithm adds a 
-              forward slash before any quotes found within a tag's content. */
-            if (currentElement->getStrContent().find('\"') != string::npos) {
-                string content = currentElement->getStrContent();
-                for (int i = 0; i < content.size(); i++) {
-                    if (content[i] == '\"') {
-                        content = content.substr(0, i) + '\\' + content.substr(i, content.size());
-                        i++;
-                        currentElement->setStrContent(content);
+              forward slash before any quotes found within a tag's content. The
+              escaped content is written out without changing the element. */
+            const string &content = currentElement->getStrContent();
+
+            os << "\"";
+            if (content.find('\"') != string::npos) {
+                for (string::const_iterator it = content.begin(); it != content.end(); ++it) {
+                    if (*it == '\"') {
+                        os << '\\';
                     }
+                    os << *it;
                 }
+            } else {
+                os << content;
             }
-
-            os << "\"" << currentElement->getStrContent() << "\"";
+            os << "\"";
 
             if (currentElement->getParent()->vecChildren.back() == currentElement) {
                 os << "\n";
@@ -891,14 +1343,14 @@ void writeJSON(Element* currentElement, ofstream &os) {
 
             if (currentElement->hasAttributes()) {
                 os << ":{\n";
-                for (vector<Attribute*>::iterator it = currentElement->vecAttribute.begin();
-                        it != currentElement->vecAttribute.end(); it++) {
+                for (vector<Attribute*>::iterator it = currentElement->getAttributes().begin();
+                        it != currentElement->getAttributes().end(); it++) {
 
                     addSpaces(currentElement, os);
                     os << "\"" << (*it)->getAttName() << "\":";
                     os << "\"" << (*it)->getAttValue() << "\"";
 
-                    if (it != currentElement->vecAttribute.end() - 1) {
+                    if (it != currentElement->getAttributes().end() - 1) {
                         os << ",\n";
                     } else {
                         os << "\n";
@@ -932,12 +1384,253 @@ void writeJSON(Element* currentElement, ofstream &os) {
     // Closes the entire JSON file. 
     if (currentElement == emptyRoot) {
         os << "}\n";
-        cout << "JSON output complete." << endl;
-        cout << "File 'DJL_Assn05_Element_Tree.json' written to the folder dist." << endl;
     }
 
 }
 
+/**
+ * Recursively parses the attributes of every element in the tree. Attributes are
+ * parsed the first time they are needed, so this is called before the tree is
+ * written by several threads at once, leaving the tree unchanged while they run.
+ * @param currentElement - The element whose attributes, and whose children's attributes, are parsed.
+ */
+void parseAllAttributes(Element* currentElement) {
+    if (currentElement->hasAttributes()) {
+        currentElement->getAttributes();
+    }
+    for (vector<Element*>::iterator it = currentElement->vecChildren.begin();
+            it != currentElement->vecChildren.end(); ++it) {
+        parseAllAttributes(*it);
+    }
+}
+
+/**
+ * Function to write the element tree in each of the chosen output formats. Every
+ * format only reads the tree, so each one is written on its own thread at the same
+ * time as the others. The text report is written to the console, while the JSON and
+ * HTML files are written to the folder dist. Each file is compressed and written by
+ * a thread of its own, so the threads building the files never wait on the disk.
+ * @param root - The empty root of the element tree.
+ * @param text - Whether the tree is displayed as a text report.
+ * @param json - Whether the tree is written as a JSON file.
+ * @param html - Whether the tree is written as an HTML file.
+ * @param compression - The way the JSON and HTML files are compressed.
+ */
+void exportTree(Element* root, bool text, bool json, bool html, Compression compression) {
+    CompressedFile jsonFile;
+    CompressedFile htmlFile;
+    ostream jsonStream(&jsonFile);
+    ostream htmlStream(&htmlFile);
+    vector<thread> writers;
+    string jsonName = string("DJL_Assn05_Element_Tree.json") + CompressedFile::extension(compression);
+    string htmlName = string("DJL_Assn05_Element_Tree.html") + CompressedFile::extension(compression);
+
+    parseAllAttributes(root);
+
+    if (json) {
+        cout << "Now outputting the element tree as a JSON file..." << endl;
+        jsonFile.open("dist/" + jsonName, compression);
+        writers.push_back(thread([root, &jsonStream]() {
+            writeJSON(root, jsonStream);
+        }));
+    }
+
+    if (html) {
+        cout << "Now outputting the element tree as an HTML file..." << endl;
+        htmlFile.open("dist/" + htmlName, compression);
+        writers.push_back(thread([root, &htmlStream]() {
+            writeHTML(root, htmlStream);
+        }));
+    }
+
+    // Nothing else is written to the console until the text report is finished.
+    if (text) {
+        writers.push_back(thread([root]() {
+            displayTree(root, cout);
+        }));
+    }
+
+    for (vector<thread>::iterator it = writers.begin(); it != writers.end(); ++it) {
+        it->join();
+    }
+
+    // Closing a file waits for the last of it to be compressed and written.
+    if (json) {
+        jsonStream.flush();
+        if (jsonFile.close() && jsonStream) {
+            cout << "JSON output complete." << endl;
+            cout << "File '" << jsonName << "' written to the folder dist." << endl;
+        } else {
+            cout << "The file '" << jsonName << "' could not be written." << endl;
+        }
+    }
+
+    if (html) {
+        htmlStream.flush();
+        if (htmlFile.close() && htmlStream) {
+            cout << "HTML output complete." << endl;
+            cout << "File '" << htmlName << "' written to the folder dist." << endl;
+        } else {
+            cout << "The file '" << htmlName << "' could not be written." << endl;
+        }
+    }
+}
+
+/**
+ * Finds the element opening on a line by walking down the tree. Children are in
+ * line order, so the only child that can hold the line is the last one opened
+ * on or before it.
+ * @param lineNo - The line the element opens on.
+ * @return - The element, or NULL if no element opens on the line.
+ */
+Element* findElement(int lineNo) {
+    Element* parent = emptyRoot;
+    while (true) {
+        vector<Element*> &kids = parent->vecChildren;
+        vector<Element*>::iterator it = partition_point(kids.begin(), kids.end(),
+                [lineNo](Element * e) {
+                    return e->getLineNo() <= lineNo; });
+
+        if (it == kids.begin()) {
+            return NULL;
+        }
+        Element* candidate = *(it - 1);
+        if (candidate->getLineNo() == lineNo) {
+            return candidate;
+        }
+        if (candidate->getEndLineNo() < lineNo) {
+            return NULL;
+        }
+        parent = candidate;
+    }
+}
+
+/**
+ * Function to look up text in the text index and list the matching elements,
+ * each with the tag names of the elements above it and its content.
+ * @param text - The text to look up.
+ * @param prefix - Whether the last word of the text only has to start a word.
+ */
+void showMatches(const string &text, bool prefix) {
+    vector<int> matches = prefix ? textIndex.findPrefix(text) : textIndex.find(text);
+
+    cout << matches.size() << " element" << (matches.size() == 1 ? "" : "s") << " found for \""
+            << text << (prefix ? "*" : "") << "\"." << endl;
+
+    for (vector<int>::iterator it = matches.begin(); it != matches.end(); ++it) {
+        Element* match = findElement(*it);
+        if (match == NULL) {
+            continue;
+        }
+
+        string path = match->getTagName();
+        for (Element* e = match->getParent(); e != emptyRoot; e = e->getParent()) {
+            path = e->getTagName() + "/" + path;
+        }
+
+        cout << "  Line " << *it << ": " << path;
+        if (match->getStrContent() != "Empty") {
+            cout << " = \"" << match->getStrContent() << '"';
+        }
+        cout << endl;
+    }
+    cout << endl;
+}
+
+/**
+ * Function to display the command line options of the program.
+ * @param program - The name the program was run with.
+ */
+void showUsage(const char* program) {
+    cout << "Usage: " << program << " [options] [file]" << endl;
+    cout << "Options:" << endl;
+    cout << "  --show-build  Display the tree as it is being built." << endl;
+    cout << "  --text        Display the element tree as a text report." << endl;
+    cout << "  --json        Write the element tree to dist/DJL_Assn05_Element_Tree.json." << endl;
+    cout << "  --html        Write the element tree to dist/DJL_Assn05_Element_Tree.html." << endl;
+    cout << "  --share-subtrees  Keep one copy of the text of identical subtrees." << endl;
+    cout << "  --diff <old>  List the elements added, removed or changed since the file <old>," << endl;
+    cout << "                in place of the text report and JSON file." << endl;
+    cout << "  --find <text> List the elements whose content or attribute values hold every word" << endl;
+    cout << "                of <text>, or the attribute <text> if it is written as name=value." << endl;
+    cout << "  --find-prefix <text>  As --find, but the last word only has to start a word." << endl;
+    cout << "                Either may be given more than once, in place of the text report and JSON file." << endl;
+    cout << "  --gzip        Compress the JSON and HTML files with gzip, adding '.gz' to their names." << endl;
+    if (CompressedFile::isSupported(ZSTD_COMPRESSION)) {
+        cout << "  --zstd        Compress the JSON and HTML files with zstd, adding '.zst' to their names." << endl;
+    }
+    cout << "  --help        Display this message." << endl;
+    cout << "If no output format is given, the text report and JSON file are written." << endl;
+    cout << "If no file is given, 'Assignment5_musicFile.xml' is read." << endl;
+    if (CompressedFile::isSupported(ZSTD_COMPRESSION)) {
+        cout << "The file may be compressed with gzip or zstd." << endl;
+    } else {
+        cout << "The file may be compressed with gzip." << endl;
+    }
+}
+
+/**
+ * Function to read the command line options, which are used in place of asking
+ * the user questions when the program is run with any arguments. 
+ * @param argc - Number of command line arguments. 
+ * @param argv - Array of pointers to command line arguments. 
+ * @param strPath - The name of the file to be read. Passed by reference. 
+ * @param text - Set if the text report was chosen. Passed by reference. 
+ * @param json - Set if the JSON file was chosen. Passed by reference. 
+ * @param html - Set if the HTML file was chosen. Passed by reference. 
+ * @param compression - Set to the way the JSON and HTML files are compressed. Passed by reference. 
+ * @param diffPath - Set to the name of the old file to compare with, if one was given. Passed by reference. 
+ * @param searches - Set to the text of each search, and whether it is a prefix search. Passed by reference. 
+ * @return - False if an option was not recognized or help was asked for.
+ */
+bool parseArguments(int argc, char** argv, string &strPath, bool &text, bool &json, bool &html,
+        Compression &compression, string &diffPath, vector<pair<string, bool> > &searches) {
+    text = json = html = false;
+    compression = NO_COMPRESSION;
+    diffPath.clear();
+    searches.clear();
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+
+        if (arg == "--show-build") {
+            showProcessing = true;
+        } else if (arg == "--text") {
+            text = true;
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg == "--html") {
+            html = true;
+        } else if (arg == "--share-subtrees") {
+            shareSubtrees = true;
+        } else if (arg == "--gzip") {
+            compression = GZIP_COMPRESSION;
+        } else if (arg == "--zstd") {
+            if (!CompressedFile::isSupported(ZSTD_COMPRESSION)) {
+                cout << "zstd support was not built in. Use --gzip instead." << endl;
+                return false;
+            }
+            compression = ZSTD_COMPRESSION;
+        } else if (arg == "--diff" && i + 1 < argc) {
+            diffPath = argv[++i];
+        } else if ((arg == "--find" || arg == "--find-prefix") && i + 1 < argc) {
+            searches.push_back(make_pair(string(argv[++i]), arg == "--find-prefix"));
+            indexText = true;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            strPath = arg;
+        } else {
+            return false;
+        }
+    }
+
+    // Matches what the program writes when run without any arguments, unless
+    // the file is being compared with an old version or searched.
+    if (!text && !json && !html && diffPath.empty() && searches.empty()) {
+        text = json = true;
+    }
+    return true;
+}
+
 /**
  * Standard C++ main function. 
  * @param argc - Number of command line arguments. 
@@ -946,34 +1639,72 @@ void writeJSON(Element* currentElement, ofstream &os) {
  */
 int main(int argc, char** argv) {
 
-    // Asks the user if they would like for the tree building process to be displayed. 
-    askDisplay();
+    string strPath = "Assignment5_musicFile.xml";
+    bool text = true;
+    bool json = true;
+    bool html = false;
+    Compression compression = NO_COMPRESSION;
+    string diffPath;
+    vector<pair<string, bool> > searches;
+
+    // If the program was given any arguments they choose what is displayed and
+    // written, otherwise the user is asked. 
+    if (argc > 1) {
+        if (!parseArguments(argc, argv, strPath, text, json, html, compression, diffPath, searches)) {
+            showUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    } else {
+        // Asks the user if they would like for the tree building process to be displayed. 
+        askDisplay();
+    }
+
+    // To compare two versions of a file, the tree of the old version is built
+    // first and kept aside while the tree of the new version is built.
+    Element* oldRoot = NULL;
+    if (!diffPath.empty()) {
+        if (buildTree(diffPath) != EXIT_SUCCESS) {
+            clearVectorContents(elementVect);
+            return EXIT_FAILURE;
+        }
+        oldRoot = detachTree();
+        subtreePool.reset();
+    }
 
     /**
-     * If the 'openFile' function exits successfully, the element tree is displayed,
+     * If the 'buildTree' function exits successfully, the element tree is displayed,
      * converted to a JSON structure and exported, exported as an HTML file, then
      * deleted recursively. 
      */
-    if (openfile("Assignment5_musicFile.xml") == EXIT_SUCCESS) {
+    if (buildTree(strPath) == EXIT_SUCCESS) {
 
-        displayTree(currentElement);
-
-        //Converts the element tree to a JSON structure and writes it to an external file
-        ofstream jsonStream;
-        jsonStream.open("dist/DJL_Assn05_Element_Tree.json");
-        writeJSON(currentElement, jsonStream);
+        // Asks the user if they would also like an HTML file of the tree.
+        if (argc <= 1) {
+            html = askOutputFormat();
+        }
 
-        //Writes the element tree to an html file.
+        // Lists the changes since the old version, passing over identical subtrees.
+        if (oldRoot != NULL) {
+            TreeDiff diff;
+            diff.compare(oldRoot, currentElement);
+            diff.writeReport(cout);
+            cout << endl;
+        }
 
-        if (askOutputFormat()) {
-            ofstream htmlStream;
-            htmlStream.open("dist/DJL_Assn05_Element_Tree.html");
-            writeHTML(currentElement, htmlStream);
+        // Lists the elements matching each search.
+        for (vector<pair<string, bool> >::iterator it = searches.begin(); it != searches.end(); ++it) {
+            showMatches(it->first, it->second);
         }
 
+        // Displays and writes the element tree in each of the chosen formats at once.
+        exportTree(currentElement, text, json, html, compression);
+
         //Recursively deletes all element objects.
         deleteTree(currentElement);
     }
+    if (oldRoot != NULL) {
+        deleteTree(oldRoot);
+    }
 
     // Clears any remaining contents of the 'elementVect' vector, deleting each
     // object that any pointers in the vector may point to. 
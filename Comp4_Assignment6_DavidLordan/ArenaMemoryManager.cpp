@@ -0,0 +1,287 @@
+/* File:   ArenaMemoryManager.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the ArenaMemoryManager class, a Xerces memory
+ * manager which hands out blocks of a few size classes from large mapped chunks,
+ * keeping a free list for each class so freed blocks are reused straight away.
+ */
+
+#include <xercesc/util/OutOfMemoryException.hpp>
+#include <sys/mman.h>
+#include <cstdint>
+#include <unistd.h>
+#include "ArenaMemoryManager.h"
+
+/** The size of a huge page, which chunks are aligned to when huge pages are used. */
+static const size_t HUGE_PAGE_SIZE = 1 << 21;
+
+/** The largest block kept in a chunk, including its header. */
+static const size_t MAX_CLASS_SIZE = 1 << 15;
+
+/** The most bytes of freed large blocks kept for reuse. */
+static const size_t MAX_CACHED_LARGE = 1 << 26;
+
+/**
+ * Structure placed in front of every block, keeping the block aligned to 16 bytes.
+ */
+struct BlockHeader {
+    /** The size class of the block. */
+    size_t sizeClass;
+
+    /** The size of the block, including this header. */
+    size_t size;
+};
+
+/**
+ * Custom constructor. No memory is mapped until the first request.
+ * @param nHugePages - Set to back the chunks with huge pages.
+ * @param nChunkSize - The number of bytes mapped at a time. Defaults to 2 MB.
+ */
+ArenaMemoryManager::ArenaMemoryManager(bool nHugePages, size_t nChunkSize) {
+    hugePages = nHugePages;
+    chunkSize = nChunkSize;
+
+    // Chunks backed with huge pages are made up of whole huge pages.
+    if (hugePages) {
+        chunkSize = (chunkSize + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    for (unsigned int i = 0; i < CLASS_COUNT; i++) {
+        freeLists[i] = NULL;
+    }
+    next = NULL;
+    end = NULL;
+    reserved = 0;
+    inUse = 0;
+    cachedLarge = 0;
+}
+
+/**
+ * Standard destructor. Gives every chunk back to the system.
+ */
+ArenaMemoryManager::~ArenaMemoryManager() {
+    for (size_t i = 0; i < chunks.size(); i++) {
+        munmap(chunks[i], chunkSize);
+    }
+
+    map<size_t, vector<void*> >::iterator cached;
+    for (cached = largeFree.begin(); cached != largeFree.end(); ++cached) {
+        for (size_t i = 0; i < cached->second.size(); i++) {
+            munmap(cached->second[i], cached->first);
+        }
+    }
+}
+
+/**
+ * Gets the memory manager used for exceptions, which is this one.
+ * @return - This memory manager.
+ */
+MemoryManager* ArenaMemoryManager::getExceptionMemoryManager() {
+    return this;
+}
+
+/**
+ * Allocates a block of memory, aligned to 16 bytes.
+ * @param size - The number of bytes needed.
+ * @return - The block. Throws an 'OutOfMemoryException' if there is no memory left.
+ */
+void* ArenaMemoryManager::allocate(XMLSize_t size) {
+    size_t total = size + sizeof (BlockHeader);
+    unsigned int sizeClass = classOf(total);
+    BlockHeader* header;
+
+    if (sizeClass == LARGE_CLASS) {
+        size_t pageSize = sysconf(_SC_PAGESIZE);
+        total = (total + pageSize - 1) & ~(pageSize - 1);
+
+        // A freed block of the same size is reused, otherwise the block is mapped.
+        {
+            lock_guard<mutex> guard(lock);
+            map<size_t, vector<void*> >::iterator cached = largeFree.find(total);
+            if (cached != largeFree.end() && !cached->second.empty()) {
+                header = static_cast<BlockHeader*> (cached->second.back());
+                cached->second.pop_back();
+                cachedLarge -= total;
+                inUse += total;
+                return header + 1;
+            }
+        }
+
+        header = static_cast<BlockHeader*> (mapPages(total));
+        if (header == NULL) {
+            throw OutOfMemoryException();
+        }
+
+        lock_guard<mutex> guard(lock);
+        inUse += total;
+    } else {
+        total = classSize(sizeClass);
+
+        lock_guard<mutex> guard(lock);
+        if (freeLists[sizeClass] != NULL) {
+            header = static_cast<BlockHeader*> (freeLists[sizeClass]);
+            freeLists[sizeClass] = *reinterpret_cast<void**> (header + 1);
+        } else {
+            header = reinterpret_cast<BlockHeader*> (carve(total));
+            if (header == NULL) {
+                throw OutOfMemoryException();
+            }
+        }
+        inUse += total;
+    }
+
+    header->sizeClass = sizeClass;
+    header->size = total;
+    return header + 1;
+}
+
+/**
+ * Frees a block of memory, keeping it for the next request of the same size class.
+ * @param p - The block, which may be NULL.
+ */
+void ArenaMemoryManager::deallocate(void* p) {
+    if (p == NULL) {
+        return;
+    }
+
+    BlockHeader* header = static_cast<BlockHeader*> (p) - 1;
+    size_t sizeClass = header->sizeClass;
+
+    lock_guard<mutex> guard(lock);
+    inUse -= header->size;
+    if (sizeClass == LARGE_CLASS) {
+
+        // Large blocks are kept for reuse until too many bytes are waiting.
+        if (cachedLarge + header->size <= MAX_CACHED_LARGE) {
+            largeFree[header->size].push_back(header);
+            cachedLarge += header->size;
+        } else {
+            munmap(header, header->size);
+        }
+    } else {
+        // The free list is threaded through the blocks themselves.
+        *reinterpret_cast<void**> (p) = freeLists[sizeClass];
+        freeLists[sizeClass] = header;
+    }
+}
+
+/**
+ * Gets the number of bytes mapped for chunks.
+ * @return - The number of bytes.
+ */
+size_t ArenaMemoryManager::bytesReserved() const {
+    lock_guard<mutex> guard(lock);
+    return reserved;
+}
+
+/**
+ * Gets the number of bytes in blocks which have not been freed, including
+ * large blocks mapped on their own.
+ * @return - The number of bytes.
+ */
+size_t ArenaMemoryManager::bytesInUse() const {
+    lock_guard<mutex> guard(lock);
+    return inUse;
+}
+
+/**
+ * Checks if the chunks are being backed with huge pages.
+ * @return - True if huge pages were asked for.
+ */
+bool ArenaMemoryManager::usesHugePages() const {
+    return hugePages;
+}
+
+/**
+ * Finds the size class of a request.
+ * @param size - The number of bytes, including the header.
+ * @return - The size class, or 'LARGE_CLASS' if the request is mapped on its own.
+ */
+unsigned int ArenaMemoryManager::classOf(size_t size) {
+    if (size <= 512) {
+        return (size + 15) / 16 - 1;
+    }
+    if (size > MAX_CLASS_SIZE) {
+        return LARGE_CLASS;
+    }
+
+    // Above 512 bytes each class is twice the size of the one before.
+    unsigned int bits = 0;
+    for (size_t rest = size - 1; rest > 0; rest >>= 1) {
+        bits++;
+    }
+    return 32 + bits - 10;
+}
+
+/**
+ * Gets the size of the blocks of a size class.
+ * @param sizeClass - The size class.
+ * @return - The number of bytes, including the header.
+ */
+size_t ArenaMemoryManager::classSize(unsigned int sizeClass) {
+    if (sizeClass < 32) {
+        return (sizeClass + 1) * 16;
+    }
+    return static_cast<size_t> (1) << (sizeClass - 32 + 10);
+}
+
+/**
+ * Maps memory straight from the system. With huge pages, memory of at least
+ * a huge page starts on a huge page boundary and the kernel is asked to back
+ * it with huge pages.
+ * @param length - The number of bytes, a whole number of pages.
+ * @return - The memory, or NULL if it could not be mapped.
+ */
+void* ArenaMemoryManager::mapPages(size_t length) {
+    if (!hugePages || length < HUGE_PAGE_SIZE) {
+        void* mapped = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return (mapped == MAP_FAILED) ? NULL : mapped;
+    }
+
+    // Maps an extra huge page so the memory can start on a huge page
+    // boundary, then gives back the unused parts on either side.
+    size_t padded = length + HUGE_PAGE_SIZE;
+    void* mapped = mmap(NULL, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return NULL;
+    }
+    uintptr_t start = reinterpret_cast<uintptr_t> (mapped);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(static_cast<uintptr_t> (HUGE_PAGE_SIZE) - 1);
+    if (aligned > start) {
+        munmap(mapped, aligned - start);
+    }
+    munmap(reinterpret_cast<void*> (aligned + length), start + padded - aligned - length);
+
+    void* memory = reinterpret_cast<void*> (aligned);
+#ifdef MADV_HUGEPAGE
+    madvise(memory, length, MADV_HUGEPAGE);
+#endif
+    return memory;
+}
+
+/**
+ * Takes a new block from the end of the current chunk, mapping a new chunk
+ * if there is not enough room left. Called with the lock held.
+ * @param bytes - The size of the block.
+ * @return - The block, or NULL if no chunk could be mapped.
+ */
+char* ArenaMemoryManager::carve(size_t bytes) {
+    if (next == NULL || static_cast<size_t> (end - next) < bytes) {
+        char* chunk = static_cast<char*> (mapPages(chunkSize));
+        if (chunk == NULL) {
+            return NULL;
+        }
+
+        chunks.push_back(chunk);
+        reserved += chunkSize;
+        next = chunk;
+        end = chunk + chunkSize;
+    }
+
+    char* block = next;
+    next += bytes;
+    return block;
+}
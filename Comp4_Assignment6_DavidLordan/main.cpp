@@ -20,6 +20,14 @@
  * After the XML structure is created and stored in memory it is then printed
  * using the Xerces DOMSerializer and Xerces tree walker. The tree walker is 
  * used to traverse the DOMNodes and can be used to create a custom output style. 
+ * 
+ * The program can also generate a much larger DOM structure of the same shape
+ * for load testing, by repeating the semesters as many times as asked. The time
+ * taken and memory used by each step are then reported. 
+ * 
+ * Xerces allocates its memory through an arena memory manager, which keeps blocks
+ * of a few sizes in large chunks, unless the default memory manager is asked for.
+ * Generating the same DOM with each of them compares their speed and peak memory.
  */
 
 /* Includes the necessary Xerces libraries and Xerces namespace. */
@@ -27,9 +35,16 @@
 #include <xercesc/framework/StdOutFormatTarget.hpp>
 #include <iostream>
 #include "xercesc/dom/DOMTreeWalker.hpp"
+#include "OutputSink.h"
+#include "ArenaMemoryManager.h"
 
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <limits.h>
+#include <random>
+#include <chrono>
+#include <sys/resource.h>
 
 XERCES_CPP_NAMESPACE_USE
 
@@ -80,146 +95,523 @@ int courseLoad[] = {4, 4, 5, 5, 3, 5, 5, 3, 4, 3};
 const char *campus[] = {"Lynn/McGee", "Danvers/Berry", "Online", "Salem State North Campus",
     "UML North Campus"};
 
+/** The number of entries in each of the arrays above. */
+const int COURSE_COUNT = sizeof (courses) / sizeof (courses[0]);
+const int SEMESTER_COUNT = sizeof (semesters) / sizeof (semesters[0]);
+const int CAMPUS_COUNT = sizeof (campus) / sizeof (campus[0]);
+
+/** Names for each entry of the 'degreeNames' array below. */
+enum DegreeName {
+    CS_DEGREE, INSTRUCTOR, CAMPUS, GRADE, CLASS_LEVEL, GRADUATE, INFO_RELIABILITY,
+    SUBJECT_TO_CHANGE, HAS_BACHELORDEG, APPLIES_TO_MATH_MINOR, TRUE_VALUE, GRADE_A,
+    GRADE_NA, DEGREE_NAME_COUNT
+};
+
+/** An array of the tag names, attribute names and values used by every course. */
+const char *degreeNames[DEGREE_NAME_COUNT] = {"CS_Degree", "Instructor", "Campus", "Grade",
+    "class_Level", "Graduate", "info_reliability", "subject_to_change", "has_BachelorDeg",
+    "appliesToMathMinor", "true", "A", "N/A"};
+
+/** The attributes given to each course of the graduate semester, as name and value pairs. */
+const DegreeName graduateAttributes[][2] = {{CLASS_LEVEL, GRADUATE},
+    {INFO_RELIABILITY, SUBJECT_TO_CHANGE}, {HAS_BACHELORDEG, TRUE_VALUE}};
+
+/** The attribute given to courses which apply to the math minor. */
+const DegreeName mathMinorAttributes[][2] = {{APPLIES_TO_MATH_MINOR, TRUE_VALUE}};
+
+/** 
+ * Transcoded copies of each of the arrays above. Every name is transcoded once
+ * by 'transcodeNames' before the DOM is created, rather than once per node. 
+ */
+XMLCh *xCourses[COURSE_COUNT];
+XMLCh *xProfessors[COURSE_COUNT];
+XMLCh *xSemesters[SEMESTER_COUNT];
+XMLCh *xCampus[CAMPUS_COUNT];
+XMLCh *xDegreeNames[DEGREE_NAME_COUNT];
+
+/** Set for each course that applies to the math minor. */
+bool mathMinor[COURSE_COUNT];
+
+/**
+ * Function to transcode each string of an array into a table of XMLCh strings.
+ * @param source - The array of strings to transcode.
+ * @param table - The table in which the transcoded strings are stored.
+ * @param count - The number of strings in the array.
+ */
+void transcodeTable(const char* const source[], XMLCh* table[], int count) {
+    for (int i = 0; i < count; i++) {
+        table[i] = X(source[i]);
+    }
+}
+
+/**
+ * Function to free each transcoded string in a table.
+ * @param table - The table of transcoded strings.
+ * @param count - The number of strings in the table.
+ */
+void releaseTable(XMLCh* table[], int count) {
+    for (int i = 0; i < count; i++) {
+        XMLString::release(&table[i]);
+    }
+}
+
+/**
+ * Function to transcode every name used to create the DOM structure, and to
+ * find which courses apply to the math minor. 
+ */
+void transcodeNames() {
+    transcodeTable(courses, xCourses, COURSE_COUNT);
+    transcodeTable(professors, xProfessors, COURSE_COUNT);
+    transcodeTable(semesters, xSemesters, SEMESTER_COUNT);
+    transcodeTable(campus, xCampus, CAMPUS_COUNT);
+    transcodeTable(degreeNames, xDegreeNames, DEGREE_NAME_COUNT);
+
+    for (int j = 0; j < COURSE_COUNT; j++) {
+        mathMinor[j] = strncmp(courses[j], "Differential_Equations", 15) == 0
+                || strncmp(courses[j], "Calculus", 8) == 0
+                || strncmp(courses[j], "Discrete", 8) == 0;
+    }
+}
+
+/**
+ * Function to free every name transcoded by 'transcodeNames'. The DOM document
+ * keeps its own copy of each name, so this can be called as soon as it is created. 
+ */
+void releaseNames() {
+    releaseTable(xCourses, COURSE_COUNT);
+    releaseTable(xProfessors, COURSE_COUNT);
+    releaseTable(xSemesters, SEMESTER_COUNT);
+    releaseTable(xCampus, CAMPUS_COUNT);
+    releaseTable(xDegreeNames, DEGREE_NAME_COUNT);
+}
+
+/**
+ * Function to create an element from an already transcoded name and append it
+ * to a parent node. 
+ * @param doc - The DOMDocument that contains the DOM structure. 
+ * @param parent - The node to which the new element is appended.
+ * @param name - The transcoded tag name of the new element.
+ * @return - The new element.
+ */
+DOMElement* appendElement(DOMDocument* doc, DOMNode* parent, const XMLCh* name) {
+    DOMElement* elem = doc->createElement(name);
+    parent->appendChild(elem);
+    return elem;
+}
+
+/**
+ * Function to create an element containing a text node and append it to a parent
+ * node. Both the name and the text must already be transcoded. 
+ * @param doc - The DOMDocument that contains the DOM structure. 
+ * @param parent - The node to which the new element is appended.
+ * @param name - The transcoded tag name of the new element.
+ * @param text - The transcoded content of the new element.
+ * @return - The new element.
+ */
+DOMElement* appendTextElement(DOMDocument* doc, DOMNode* parent, const XMLCh* name,
+        const XMLCh* text) {
+    DOMElement* elem = appendElement(doc, parent, name);
+    elem->appendChild(doc->createTextNode(text));
+    return elem;
+}
+
+/**
+ * Function to add a list of attributes to an element, each taken from the
+ * transcoded 'degreeNames' table. 
+ * @param elem - The element to which the attributes are added. 
+ * @param pairs - The name and value of each attribute.
+ * @param count - The number of attributes.
+ */
+void setAttributes(DOMElement* elem, const DegreeName pairs[][2], int count) {
+    for (int i = 0; i < count; i++) {
+        elem->setAttribute(xDegreeNames[pairs[i][0]], xDegreeNames[pairs[i][1]]);
+    }
+}
+
+/**
+ * Function to find which campus a course took place on, depending on the 
+ * semester, course or instructor. 
+ * @param i - The index of the semester in the 'semesters' array.
+ * @param j - The index of the course in the 'courses' array.
+ * @return - The index of the campus in the 'campus' array.
+ */
+int campusFor(int i, int j) {
+
+    // Variable used to keep track of the campus to use. 
+    int campusNum = 0;
+
+    // Switch statement that assigns a value to 'campusNum' depending on
+    // the current semester, course or instructor. 
+    switch (i) {
+        case 0:
+            if (j == 0 || j == 1) {
+                campusNum = 0;
+            } else {
+                campusNum = 2;
+            }
+            break;
+        case 1:
+            if (j == 4) {
+                campusNum = 1;
+            } else if (j == 5) {
+                campusNum = 3;
+            } else {
+                campusNum = 2;
+            }
+            break;
+        case 2:
+        case 3:
+            campusNum = 0;
+            break;
+        case 4:
+            campusNum = 2;
+            if (strncmp(professors[j], "Prof. Lepsky", 13) == 0) {
+                campusNum = 4;
+            }
+            break;
+        case 7:
+            campusNum = 2;
+            break;
+        default:
+            campusNum = 4;
+            break;
+    }
+    return campusNum;
+}
+
+/**
+ * Function to append a course to a semester node. The course is given an Instructor,
+ * Campus and Grade child, and may be given attributes. 
+ * @param doc - The DOMDocument that contains the DOM structure. 
+ * @param semesterElem - The semester node to which the course is appended.
+ * @param i - The index of the semester in the 'semesters' array.
+ * @param j - The index of the course in the 'courses' array.
+ * @param graduate - Whether the course is given the graduate attributes.
+ * @param mathMinorAtt - Whether the course is given the math minor attribute.
+ * @return - The new course element.
+ */
+DOMElement* appendCourse(DOMDocument* doc, DOMElement* semesterElem, int i, int j,
+        bool graduate, bool mathMinorAtt) {
+
+    DOMElement* courseElem = appendElement(doc, semesterElem, xCourses[j]);
+    appendTextElement(doc, courseElem, xDegreeNames[INSTRUCTOR], xProfessors[j]);
+
+    if (graduate) {
+        setAttributes(courseElem, graduateAttributes, 3);
+    }
+
+    if (mathMinorAtt) {
+        setAttributes(courseElem, mathMinorAttributes, 1);
+    }
+
+    // Uses 'campusFor' to add the appropriate campus name to the course. 
+    appendTextElement(doc, courseElem, xDegreeNames[CAMPUS], xCampus[campusFor(i, j)]);
+
+    // Assigns grade values based on the semester. 
+    if (i < 5) {
+        appendTextElement(doc, courseElem, xDegreeNames[GRADE], xDegreeNames[GRADE_A]);
+    } else {
+        appendTextElement(doc, courseElem, xDegreeNames[GRADE], xDegreeNames[GRADE_NA]);
+    }
+    return courseElem;
+}
+
 /**
  * Function to create the DOM structure. Scans through each member of the 'semesters'
  * array, creating a child node of the root for each. Each of the semester nodes are
  * then given children corresponding to each course in that semester. Each course
  * is then given a Instructor, Campus, and Grade child. Also, courses may or may 
  * not have attributes associated with them. Much of this function is based on
- * the Xerces DOMPrint sample program. 
+ * the Xerces DOMPrint sample program. Every name is transcoded once before the
+ * loops begin.
  * @param impl - DOMImplementation used to create the DOM structure.
  * @return  - Returns a DOMDocument pointer containing the DOM structure.
  */
 DOMDocument* createDOM(DOMImplementation *impl) {
 
+    transcodeNames();
+
     //Creates a DOMDocument from the DOMImplementaiton. Initializes the DOM
     // structure with a root node. 
     DOMDocument* doc = impl->createDocument(
             0, // root element namespace URI.
-            X("CS_Degree"), // root element name
+            xDegreeNames[CS_DEGREE], // root element name
             0); // document type object (DTD).
 
     //Assigns the root element. 
     DOMElement* rootElem = doc->getDocumentElement();
 
-    // Group of 3 DOMElment placeholder variables which each correspond to a 
-    // different level of the DOM structure. 
+    // DOMElment placeholder variable for the current semester. 
     DOMElement* lvl1Elem;
-    DOMElement* lvl2Elem;
-    DOMElement* lvl3Elem;
-
-    // Place holder variable for DOM content. 
-    DOMText* txtNode;
 
-    //Variables used to keep track of the next course and campus to use. 
+    //Variable used to keep track of the next course to use. 
     int classNum = 0;
-    int campusNum = 0;
 
     // For loop which appends children to the root. Each iteration through 
     // the loop corresponds to a different semester. 
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < SEMESTER_COUNT; i++) {
 
-
-        lvl1Elem = doc->createElement(X(semesters[i]));
-        rootElem->appendChild(lvl1Elem);
+        lvl1Elem = appendElement(doc, rootElem, xSemesters[i]);
 
         // For loop which appends children to a semester node. Each iteration
         // through the loop corresponds to a different course, along with that 
-        // course's information.
+        // course's information. Courses in the last semester are given the
+        // graduate attributes, and certain math courses the math minor attribute.
         for (int j = classNum; j < (courseLoad[i] + classNum); j++) {
+            appendCourse(doc, lvl1Elem, i, j, i == 9, mathMinor[j]);
+        }
 
-            lvl2Elem = doc->createElement(X(courses[j]));
-            lvl1Elem->appendChild(lvl2Elem);
+        // Increments clasNum by the current semester's course load. 
+        classNum += courseLoad[i];
 
-            lvl3Elem = doc->createElement(X("Instructor"));
-            lvl2Elem->appendChild(lvl3Elem);
+    }
 
-            txtNode = doc->createTextNode(X(professors[j]));
-            lvl3Elem->appendChild(txtNode);
+    // The document has its own copy of every name, so the tables are freed.
+    releaseNames();
 
-            lvl3Elem = doc->createElement(X("Campus"));
-            lvl2Elem->appendChild(lvl3Elem);
+    // Returns the completed document. 
+    return doc;
+}
 
-            // When creating the last semester, three attributes are added to each
-            // course. 
-            if (i == 9) {
-                lvl2Elem->setAttribute(X("class_Level"), X("Graduate"));
-                lvl2Elem->setAttribute(X("info_reliability"), X("subject_to_change"));
-                lvl2Elem->setAttribute(X("has_BachelorDeg"), X("true"));
-            }
+/**
+ * Structure storing the command line options, most of which are used to generate
+ * a large DOM structure.
+ */
+struct ProgramOptions {
+    /** Set if a generated DOM structure is used in place of my own program of study. */
+    bool generate;
 
-            // Add attributes to certain math courses. 
-            if (strncmp(courses[j], "Differential_Equations", 15) == 0
-                    || strncmp(courses[j], "Calculus", 8) == 0
-                    || strncmp(courses[j], "Discrete", 8) == 0) {
-                lvl2Elem->setAttribute(X("appliesToMathMinor"), X("true"));
+    /** The number of times the ten semesters are repeated. */
+    unsigned long long scale;
 
-            }
+    /** The seed of the random number generator. */
+    unsigned int seed;
 
-            // Switch statement that assigns a value to 'campusNum' depending on
-            // the current semester, course or instructor. 
-            switch (i) {
-                case 0:
-                    if (j == 0 || j == 1) {
-                        campusNum = 0;
-                    } else {
-                        campusNum = 2;
-                    }
-                    break;
-                case 1:
-                    if (j == 4) {
-                        campusNum = 1;
-                    } else if (j == 5) {
-                        campusNum = 3;
-                    } else {
-                        campusNum = 2;
-                    }
-                    break;
-                case 2:
-                case 3:
-                    campusNum = 0;
-                    break;
-                case 4:
-                    campusNum = 2;
-                    if (strncmp(professors[j], "Prof. Lepsky", 13) == 0) {
-                        campusNum = 4;
-                    }
-                    break;
-                case 7:
-                    campusNum = 2;
-                    break;
-                default:
-                    campusNum = 4;
-                    break;
-            }
+    /** The number of courses in each semester, or 0 to use the 'courseLoad' array. */
+    int fanOut;
 
-            // Uses 'campusNum' to add the appropriate campus name to the most
-            // recently created element. 
-            txtNode = doc->createTextNode(X(campus[campusNum]));
-            lvl3Elem->appendChild(txtNode);
+    /** The chance that a course which may be given attributes is given them. */
+    double attProbability;
 
-            lvl3Elem = doc->createElement(X("Grade"));
-            lvl2Elem->appendChild(lvl3Elem);
+    /** Set if the serializer and tree walker output is not printed. */
+    bool noOutput;
 
-            // Assigns grade values based on the semester. 
-            if (i < 5) {
-                txtNode = doc->createTextNode(X("A"));
-                lvl3Elem->appendChild(txtNode);
-            } else {
-                txtNode = doc->createTextNode(X("N/A"));
-                lvl3Elem->appendChild(txtNode);
-            }
-        }
+    /** The file to which the tree walker output is written, or empty for the console. */
+    string listFile;
 
-        // Increments clasNum by the current semester's course load. 
-        classNum += courseLoad[i];
+    /** Set if Xerces uses its default memory manager rather than the arena. */
+    bool defaultMemory;
+
+    /** Set if the arena's chunks are backed with huge pages. */
+    bool hugePages;
+};
+
+/**
+ * Structure storing the number of each type of node in a generated DOM structure.
+ */
+struct NodeCounts {
+    unsigned long long elements;
+    unsigned long long textNodes;
+    unsigned long long attributes;
+};
+
+/**
+ * Function to generate a DOM structure of the same shape as 'createDOM', but of
+ * any size. The ten semesters are repeated 'scale' times, each with 'fanOut'
+ * courses taken in order from the 'courses' array, wrapping around to the start
+ * once the array runs out. Courses are given a campus with the same rules, and
+ * courses of the last of each ten semesters and math courses may be given the
+ * same attributes, each with the chance set in the options. 
+ * @param impl - DOMImplementation used to create the DOM structure.
+ * @param options - The size and shape of the DOM structure.
+ * @param counts - The number of each type of node created. Passed by reference.
+ * @return  - Returns a DOMDocument pointer containing the DOM structure.
+ */
+DOMDocument* generateDOM(DOMImplementation *impl, const ProgramOptions &options,
+        NodeCounts &counts) {
+
+    transcodeNames();
+
+    DOMDocument* doc = impl->createDocument(0, xDegreeNames[CS_DEGREE], 0);
+    DOMElement* rootElem = doc->getDocumentElement();
+    DOMElement* lvl1Elem;
+
+    // Random number generator used to decide which courses are given attributes. 
+    mt19937 random(options.seed);
+    uniform_real_distribution<double> chance(0.0, 1.0);
 
+    counts.elements = 1;
+    counts.textNodes = 0;
+    counts.attributes = 0;
+
+    int classNum = 0;
+
+    for (unsigned long long n = 0; n < options.scale * SEMESTER_COUNT; n++) {
+
+        int i = (int) (n % SEMESTER_COUNT);
+        int load = options.fanOut > 0 ? options.fanOut : courseLoad[i];
+
+        lvl1Elem = appendElement(doc, rootElem, xSemesters[i]);
+        counts.elements++;
+
+        for (int c = 0; c < load; c++) {
+            int j = classNum;
+            classNum = (classNum + 1) % COURSE_COUNT;
+
+            bool graduate = i == 9 && chance(random) < options.attProbability;
+            bool mathMinorAtt = mathMinor[j] && chance(random) < options.attProbability;
+
+            appendCourse(doc, lvl1Elem, i, j, graduate, mathMinorAtt);
+
+            // Each course is an element with three children, each containing text. 
+            counts.elements += 4;
+            counts.textNodes += 3;
+            counts.attributes += (graduate ? 3 : 0) + (mathMinorAtt ? 1 : 0);
+        }
     }
 
-    // Returns the completed document. 
+    releaseNames();
+
     return doc;
 }
 
+/**
+ * Function to find the most memory the program has used so far. 
+ * @return - The peak resident memory of the program, in kilobytes.
+ */
+long peakMemoryKB() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * Function to report how long a step took and the most memory used so far.
+ * The report is written to the error stream so it is kept apart from the output.
+ * @param step - A description of the step.
+ * @param start - The time at which the step started.
+ * @param nodes - The number of nodes the step went through, used to report
+ *                how many it handled each second. Not reported if 0.
+ */
+void report(string step, chrono::steady_clock::time_point start, unsigned long long nodes = 0) {
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cerr << step << " took " << elapsed.count() << " seconds";
+    if (nodes > 0 && elapsed.count() > 0) {
+        cerr << " (" << (unsigned long long) (nodes / elapsed.count()) << " nodes per second)";
+    }
+    cerr << ", peak memory " << (peakMemoryKB() / 1024) << " MB." << endl;
+}
+
+/**
+ * Function to read a whole number given as the value of a command line option.
+ * Only digits are accepted, so a negative or partly numeric value is rejected
+ * rather than read as some other number.
+ * @param option - The name of the option, used in the error message.
+ * @param value - The value given to the option.
+ * @param min - The smallest number accepted.
+ * @param max - The largest number accepted.
+ * @param number - The number read. Passed by reference.
+ * @return - False if the value is not a whole number from 'min' to 'max'.
+ */
+bool readWholeNumber(const string &option, const char* value, unsigned long long min,
+        unsigned long long max, unsigned long long &number) {
+    char* end;
+    errno = 0;
+    number = strtoull(value, &end, 10);
+    if (*value < '0' || *value > '9' || *end != '\0' || errno == ERANGE || number < min || number > max) {
+        cerr << "The value of " << option << " must be a whole number from " << min
+                << " to " << max << ", not '" << value << "'." << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Function to read the command line options. 
+ * @param argC - Number of command line arguments. 
+ * @param argV - Array of pointers to command line arguments. 
+ * @param options - The options read. Passed by reference. 
+ * @return - False if an option was not recognized or has a value which is not valid.
+ */
+bool parseArguments(int argC, char* argV[], ProgramOptions &options) {
+
+    options.generate = false;
+    options.scale = 1;
+    options.seed = 1;
+    options.fanOut = 0;
+    options.attProbability = 1.0;
+    options.noOutput = false;
+    options.listFile = "";
+    options.defaultMemory = false;
+    options.hugePages = false;
+
+    for (int i = 1; i < argC; i++) {
+        string arg = argV[i];
+        bool hasValue = i + 1 < argC;
+
+        if (arg == "--generate" && hasValue) {
+            // The scale must be a whole number of at least one, since a DOM with
+            // no semesters has nothing for the tree walker to print.
+            options.generate = true;
+            if (!readWholeNumber(arg, argV[++i], 1, ULLONG_MAX, options.scale)) {
+                return false;
+            }
+        } else if (arg == "--seed" && hasValue) {
+            unsigned long long seed;
+            if (!readWholeNumber(arg, argV[++i], 0, UINT_MAX, seed)) {
+                return false;
+            }
+            options.seed = (unsigned int) seed;
+        } else if (arg == "--fan-out" && hasValue) {
+            // A semester needs at least one course. Leaving the option out uses
+            // the 'courseLoad' array instead.
+            unsigned long long fanOut;
+            if (!readWholeNumber(arg, argV[++i], 1, INT_MAX, fanOut)) {
+                return false;
+            }
+            options.fanOut = (int) fanOut;
+        } else if (arg == "--att-probability" && hasValue) {
+            // The comparison is written so that "nan" is rejected as well.
+            const char* value = argV[++i];
+            char* end;
+            options.attProbability = strtod(value, &end);
+            if (end == value || *end != '\0' || !(options.attProbability >= 0.0 && options.attProbability <= 1.0)) {
+                cerr << "The value of " << arg << " must be a number from 0 to 1, not '"
+                        << value << "'." << endl;
+                return false;
+            }
+        } else if (arg == "--list-file" && hasValue) {
+            options.listFile = argV[++i];
+        } else if (arg == "--no-output") {
+            options.noOutput = true;
+        } else if (arg == "--memory" && hasValue && (string(argV[i + 1]) == "default" || string(argV[i + 1]) == "arena")) {
+            options.defaultMemory = (string(argV[++i]) == "default");
+        } else if (arg == "--huge-pages") {
+            options.hugePages = true;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Function to display the command line options of the program.
+ * @param program - The name the program was run with.
+ */
+void showUsage(const char* program) {
+    cerr << "Usage: " << program << " [options]" << endl;
+    cerr << "Options:" << endl;
+    cerr << "  --generate <scale>        Generate a DOM with the semesters repeated <scale> times." << endl;
+    cerr << "  --seed <n>                Seed used to decide which courses get attributes." << endl;
+    cerr << "  --fan-out <n>             Courses in each generated semester." << endl;
+    cerr << "  --att-probability <p>     Chance from 0 to 1 that a course keeps its attributes." << endl;
+    cerr << "  --list-file <file>        Write the tree walker output to <file>." << endl;
+    cerr << "  --no-output               Build the DOM without printing it." << endl;
+    cerr << "  --memory <default|arena>  Memory manager used by Xerces. Defaults to the arena." << endl;
+    cerr << "  --huge-pages              Back the arena with huge pages." << endl;
+}
+
 /**
  * Function that uses the Xerces serializer to display the tree in an XML format.
  * Much of this function is based on the Xerces DOMPrint sample program. 
@@ -256,29 +648,26 @@ void printTree(DOMDocument* doc, DOMImplementation *impl) {
  * @param attributes - a DOM map which contains a list of attribute names and values. 
  * @param level - The level on which an attribute's parent is located. Used for output
  *                formatting. 
+ * @param sink - The buffered output to which the attributes are written.
  */
-void displayAttributes(DOMNamedNodeMap* attributes, int level) {
-
-    // Tag to hold attribute names and values which then sent to 'transcode'.
-    const XMLCh * tag = NULL;
+void displayAttributes(DOMNamedNodeMap* attributes, int level, OutputSink &sink) {
 
     // For loop which displays each attribute found on a particular element. 
     for (XMLSize_t j = 0; j < attributes->getLength(); j++) {
-        cout << endl;
+        sink.write('\n');
         DOMNode * nextAtt = attributes->item(j);
 
         DOMAttr* att = dynamic_cast<DOMAttr*> (nextAtt);
-        tag = att->getName();
 
         // Output formatting. 
-        for (int i = 0; i <= level; i++) {
-            cout << "   ";
-        }
+        sink.indent(level + 1);
 
-        cout << "Attribute " << (j + 1) << ": ";
-        cout << XMLString::transcode(tag);
-        tag = att->getValue();
-        cout << " = " << XMLString::transcode(tag);
+        sink.write("Attribute ", 10);
+        sink.writeNumber(j + 1);
+        sink.write(": ", 2);
+        sink.write(att->getName());
+        sink.write(" = ", 3);
+        sink.write(att->getValue());
 
     }
 }
@@ -288,20 +677,19 @@ void displayAttributes(DOMNamedNodeMap* attributes, int level) {
  * DOM structure. Creates the tree then scans through each node, checks its type,
  * and depending on the results outputs the content in a particular format. 
  * @param doc - The DOM document containing the DOM structure. 
+ * @param sink - The buffered output to which the tree is written. 
  */
-void treeWalker(DOMDocument* doc) {
+void treeWalker(DOMDocument* doc, OutputSink &sink) {
 
     // Variable used to keep track of the current element's level in the tree. 
     int level = 0;
-    cout << endl;
+    sink.write('\n');
 
     //  Grabs the root element and uses it to create the tree walker object. The
     //  walker's filter is set to show all nodes. 
     DOMElement* rootElem = doc->getDocumentElement();
     DOMTreeWalker *walker = doc->createTreeWalker(rootElem, DOMNodeFilter::SHOW_ALL, NULL, true);
 
-    // Placeholder variable used to store tag names and content. Passed to transcode. 
-    const XMLCh * tag = NULL;
     //Grabs the walker root to begin traversing the tree. 
     DOMNode * node = walker->getRoot();
     // Placholder node for an element that is being analyzed.
@@ -319,21 +707,19 @@ void treeWalker(DOMDocument* doc) {
                 // are also displayed.
             case DOMNode::ELEMENT_NODE:
 
-                for (int i = 0; i < level; i++) {
-                    cout << "   ";
-                }
+                sink.indent(level);
 
                 elemNode = dynamic_cast<DOMElement*> (node);
-                tag = elemNode->getTagName();
-                cout << XMLString::transcode(tag) << ":";
+                sink.write(elemNode->getTagName());
+                sink.write(':');
 
                 if (elemNode->hasAttributes()) {
                     DOMNamedNodeMap* attributes = elemNode->getAttributes();
-                    displayAttributes(attributes, level);
+                    displayAttributes(attributes, level, sink);
                 }
 
-                if (elemNode->getFirstChild()->getNodeType() != 3) {
-                    cout << endl;
+                if (elemNode->getFirstChild() == NULL || elemNode->getFirstChild()->getNodeType() != 3) {
+                    sink.write('\n');
                 }
 
                 break;
@@ -343,13 +729,13 @@ void treeWalker(DOMDocument* doc) {
                 // content, its text is displayed. 
             case DOMNode::TEXT_NODE:
 
-                tag = node->getTextContent();
-                cout << XMLString::transcode(tag) << endl;
+                sink.write(node->getTextContent());
+                sink.write('\n');
                 break;
 
             default:
 
-                cout << "ERROR!" << endl;
+                sink.write("ERROR!\n", 7);
                 break;
         }
 
@@ -364,7 +750,7 @@ void treeWalker(DOMDocument* doc) {
             // before moving back the parent.
         } else while (walker->nextSibling() == NULL && walker->getCurrentNode() != rootElem) {
                 if (walker->getCurrentNode()->getNodeType() == DOMNode::ELEMENT_NODE) {
-                    cout << endl;
+                    sink.write('\n');
                 }
                 walker->parentNode();
                 level--;
@@ -372,6 +758,11 @@ void treeWalker(DOMDocument* doc) {
 
         // When the above algorithm returns to the root, the loop ends. 
     } while (walker->getCurrentNode() != rootElem);
+
+    walker->release();
+
+    // Everything that was collected is written once the walk is complete. 
+    sink.flush();
 }
 
 /**
@@ -398,33 +789,77 @@ void banner(string type) {
  */
 int main(int argC, char* argV[]) {
 
+    ProgramOptions options;
+    if (!parseArguments(argC, argV, options)) {
+        showUsage(argV[0]);
+        return EXIT_FAILURE;
+    }
+
     // Starts the XML platform utilities, allow for the use of several Xerces features. 
-    XMLPlatformUtils::Initialize();
+    // Unless the default is asked for, Xerces allocates from the arena, which must
+    // outlive the call to 'Terminate'.
+    ArenaMemoryManager arena(options.hugePages);
+    XMLPlatformUtils::Initialize(XMLUni::fgXercescDefaultLocale, 0, 0,
+            options.defaultMemory ? 0 : &arena);
 
     // Creates a DOM implementation object. Taken from the Xeces DOMPrint sample program.
     XMLCh tempStr[3] = {chLatin_L, chLatin_S, chNull};
     DOMImplementation *impl = DOMImplementationRegistry::getDOMImplementation(tempStr);
 
-    // Creates the DOM document to store the DOM structure. 
-    DOMDocument* doc = createDOM(impl);
+    // Creates the DOM document to store the DOM structure, either my own program
+    // of study or a generated one. 
+    DOMDocument* doc;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    NodeCounts counts = {0, 0, 0};
+    if (options.generate) {
+        cerr << "Using the " << (options.defaultMemory ? "default memory manager"
+                : (options.hugePages ? "arena memory manager with huge pages" : "arena memory manager"))
+                << "." << endl;
+        doc = generateDOM(impl, options, counts);
+        cerr << "Generated " << counts.elements << " elements, " << counts.textNodes
+                << " text nodes and " << counts.attributes << " attributes." << endl;
+        report("Generating the DOM", start, counts.elements + counts.textNodes);
+    } else {
+        doc = createDOM(impl);
+    }
 
-    // Creates a 'serializer' banner and calls the 'printTree' function, displaying
-    // the tree with a Xerces serializer. 
-    banner("serializer");
-    printTree(doc, impl);
+    if (!options.noOutput) {
 
+        // Creates a 'serializer' banner and calls the 'printTree' function, displaying
+        // the tree with a Xerces serializer. 
+        start = chrono::steady_clock::now();
+        banner("serializer");
+        printTree(doc, impl);
+        if (options.generate) {
+            report("The serializer", start, counts.elements + counts.textNodes);
+        }
 
-    // Creates a 'serializer' banner and calls the 'printTree' function, displaying
-    // the tree with a Xerces tree walker object.
-    banner("treeWalker");
-    treeWalker(doc);
+        // Creates a 'serializer' banner and calls the 'printTree' function, displaying
+        // the tree with a Xerces tree walker object.
+        start = chrono::steady_clock::now();
+        banner("treeWalker");
+        OutputSink sink;
+        if (!options.listFile.empty() && !sink.open(options.listFile)) {
+            cerr << "Could not create the file '" << options.listFile << "'." << endl;
+        }
+        treeWalker(doc, sink);
+        sink.close();
+        if (options.generate) {
+            report("The tree walker", start, counts.elements + counts.textNodes);
+        }
+    }
+
+    // Frees the DOM structure. 
+    doc->release();
+
+    if (options.generate && !options.defaultMemory) {
+        cerr << "The arena mapped " << (arena.bytesReserved() / 1024) << " KB, of which "
+                << (arena.bytesInUse() / 1024) << " KB is still in use." << endl;
+    }
 
     // Closes the XML platform utilities.
     XMLPlatformUtils::Terminate();
 
     return 0;
 }
-
-
-
-
@@ -0,0 +1,132 @@
+/* File:   BackgroundExport.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the BackgroundExport class, which writes the tree
+ * to a file on a worker thread, reading it through a copy-on-write view so that the
+ * file holds the tree as it was when the export was started.
+ */
+
+#include <stdio.h>
+#include <iostream>
+#include "BackgroundExport.h"
+
+/**
+ * Default constructor.
+ */
+BackgroundExport::BackgroundExport() : finished(false) {
+    running = false;
+    complete = false;
+    doc = NULL;
+    seconds = 0;
+}
+
+/**
+ * Standard destructor. Waits for an export which is still running.
+ */
+BackgroundExport::~BackgroundExport() {
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+/**
+ * Starts writing the tree to a file on the worker thread, waiting first for
+ * an export which is still running. Called with the view's lock held.
+ * @param nDoc - The document to write.
+ * @param nFileName - The path of the file.
+ * @return - False if the file could not be created.
+ */
+bool BackgroundExport::start(DOMDocument* nDoc, const string &nFileName) {
+    if (running) {
+        cout << "Waiting for the export to '" << fileName << "' to finish." << endl;
+        wait();
+    }
+
+    if (!sink.open(nFileName)) {
+        cout << "Could not create the file '" << nFileName << "'." << endl;
+        return false;
+    }
+
+    doc = nDoc;
+    fileName = nFileName;
+    view.open();
+    running = true;
+    finished = false;
+    started = chrono::steady_clock::now();
+    worker = thread(&BackgroundExport::run, this);
+    return true;
+}
+
+/**
+ * Checks if an export has been started and not yet reported.
+ * @return - True while an export is running or waiting to be reported.
+ */
+bool BackgroundExport::isRunning() const {
+    return running;
+}
+
+/**
+ * Reports an export which has finished and closes its view. Called with the
+ * view's lock held.
+ */
+void BackgroundExport::poll() {
+    if (!running || !finished) {
+        return;
+    }
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+    view.close();
+    running = false;
+
+    if (complete) {
+        cout << "Exported the DOM tree to '" << fileName << "' in the background in "
+                << seconds << " seconds." << endl;
+    } else {
+        remove(fileName.c_str());
+        cout << "The tree holds nodes which can only be exported with 'export', so the file '"
+                << fileName << "' was not written." << endl;
+    }
+}
+
+/**
+ * Waits for a running export to finish, then reports it. Called with the
+ * view's lock held, which is given up while waiting.
+ */
+void BackgroundExport::wait() {
+    if (!running) {
+        return;
+    }
+
+    view.unlock();
+    worker.join();
+    view.lock();
+    poll();
+}
+
+/**
+ * Gets the view the exports read the tree through, which must be told about
+ * every change made to the tree.
+ * @return - The view.
+ */
+CopyOnWriteView& BackgroundExport::getView() {
+    return view;
+}
+
+/**
+ * Writes the tree through the view. Runs on the worker thread.
+ */
+void BackgroundExport::run() {
+    view.lock();
+    complete = writer.write(doc, true, sink, &view);
+    view.unlock();
+
+    // The rest of the file is written once the shell can use the tree again.
+    sink.close();
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+    finished = true;
+}
@@ -0,0 +1,126 @@
+/* File:   BackgroundExport.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the BackgroundExport class, which writes the tree to a
+ * file on a worker thread while the shell keeps taking commands. Starting an export
+ * opens a CopyOnWriteView of the tree, which costs nothing, so the file holds the
+ * tree exactly as it was when the export was started no matter what is changed
+ * while it is written.
+ *
+ * The export is written by a UTF8Writer reading through the view, so it produces the
+ * same bytes as 'export' would have at that moment. Trees holding nodes only the
+ * Xerces serializer can write, such as comments, cannot be exported this way, and
+ * the file is removed if one is found. The shell checks for a finished export
+ * before each command, which is when it is reported and the view is closed.
+ */
+
+#ifndef BACKGROUNDEXPORT_H
+#define	BACKGROUNDEXPORT_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include "CopyOnWriteView.h"
+#include "OutputSink.h"
+#include "UTF8Writer.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class BackgroundExport {
+public:
+
+    /**
+     * Default constructor.
+     */
+    BackgroundExport();
+
+    /**
+     * Standard destructor. Waits for an export which is still running.
+     */
+    virtual ~BackgroundExport();
+
+    /**
+     * Starts writing the tree to a file on the worker thread, waiting first for
+     * an export which is still running. Called with the view's lock held.
+     * @param nDoc - The document to write.
+     * @param nFileName - The path of the file.
+     * @return - False if the file could not be created.
+     */
+    bool start(DOMDocument* nDoc, const string &nFileName);
+
+    /**
+     * Checks if an export has been started and not yet reported.
+     * @return - True while an export is running or waiting to be reported.
+     */
+    bool isRunning() const;
+
+    /**
+     * Reports an export which has finished and closes its view. Called with the
+     * view's lock held.
+     */
+    void poll();
+
+    /**
+     * Waits for a running export to finish, then reports it. Called with the
+     * view's lock held, which is given up while waiting.
+     */
+    void wait();
+
+    /**
+     * Gets the view the exports read the tree through, which must be told about
+     * every change made to the tree.
+     * @return - The view.
+     */
+    CopyOnWriteView& getView();
+
+private:
+
+    /**
+     * Writes the tree through the view. Runs on the worker thread.
+     */
+    void run();
+
+    /** The view of the tree being written. */
+    CopyOnWriteView view;
+
+    /** The worker thread. */
+    thread worker;
+
+    /** Set while an export has been started and not yet reported. */
+    bool running;
+
+    /** Set by the worker once the file is written. */
+    atomic<bool> finished;
+
+    /** Set by the worker if every node could be written. */
+    bool complete;
+
+    /** The document being written. */
+    DOMDocument* doc;
+
+    /** The path of the file being written. */
+    string fileName;
+
+    /** The file being written. */
+    OutputSink sink;
+
+    /** The writer used by the worker. */
+    UTF8Writer writer;
+
+    /** The time the export was started. */
+    chrono::steady_clock::time_point started;
+
+    /** The number of seconds the worker took. */
+    double seconds;
+};
+
+#endif	/* BACKGROUNDEXPORT_H */
+
@@ -0,0 +1,368 @@
+/* File:   CompressedFile.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the CompressedFile class, a stream buffer which
+ * writes a file compressed with gzip or zstd. Full blocks of text are compressed and
+ * written by a background thread while the next block is being filled.
+ */
+
+#include <cstring>
+#include "CompressedFile.h"
+
+/** The number of compressed bytes collected before they are written to the file. */
+static const size_t PACKED_BLOCK_SIZE = 1 << 17;
+
+/** The zstd compression level, the library's own default. */
+static const int ZSTD_LEVEL = 3;
+
+/** Set if the program was built with zstd. */
+#ifdef HAVE_ZSTD
+static const bool ZSTD_BUILT = true;
+#else
+static const bool ZSTD_BUILT = false;
+#endif
+
+/**
+ * Custom constructor. Nothing is written until a file is opened.
+ * @param nBlockSize - The number of bytes collected before they are compressed. Defaults to 256 KB.
+ */
+CompressedFile::CompressedFile(size_t nBlockSize) : failed(false) {
+    blockSize = nBlockSize;
+    compression = NO_COMPRESSION;
+    lengths[0] = lengths[1] = 0;
+    full[0] = full[1] = false;
+    finalBlock = -1;
+    current = 0;
+#ifdef HAVE_ZSTD
+    zstd = NULL;
+#endif
+    setp(NULL, NULL);
+}
+
+/**
+ * Standard destructor. Finishes and closes any open file.
+ */
+CompressedFile::~CompressedFile() {
+    close();
+}
+
+/**
+ * Opens a file and starts the background thread which compresses it.
+ * @param strPath - The name of the file to write.
+ * @param nCompression - The way the file is compressed. With 'NO_COMPRESSION'
+ *                       the text is written as it is, still on the background thread.
+ * @return - False if the file could not be opened or the compression is not
+ *           supported by this build.
+ */
+bool CompressedFile::open(const string &strPath, Compression nCompression) {
+    close();
+    compression = nCompression;
+    failed = false;
+
+    if (compression == GZIP_COMPRESSION) {
+        memset(&gzip, 0, sizeof (gzip));
+
+        // Adding 16 to the window size has zlib write a gzip header and trailer.
+        if (deflateInit2(&gzip, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return false;
+        }
+    } else if (compression == ZSTD_COMPRESSION) {
+#ifdef HAVE_ZSTD
+        zstd = ZSTD_createCStream();
+        if (zstd == NULL || ZSTD_isError(ZSTD_initCStream(zstd, ZSTD_LEVEL))) {
+            ZSTD_freeCStream(zstd);
+            zstd = NULL;
+            return false;
+        }
+#else
+        return false;
+#endif
+    }
+
+    file.open(strPath.c_str(), ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        if (compression == GZIP_COMPRESSION) {
+            deflateEnd(&gzip);
+        }
+#ifdef HAVE_ZSTD
+        ZSTD_freeCStream(zstd);
+        zstd = NULL;
+#endif
+        return false;
+    }
+
+    blocks[0].resize(blockSize);
+    blocks[1].resize(blockSize);
+    if (compression != NO_COMPRESSION) {
+        packed.resize(PACKED_BLOCK_SIZE);
+    }
+    full[0] = full[1] = false;
+    finalBlock = -1;
+    current = 0;
+    setp(&blocks[0][0], &blocks[0][0] + blockSize);
+
+    writer = thread(&CompressedFile::compressAhead, this);
+    return true;
+}
+
+/**
+ * Compresses the rest of the text, finishes the file and closes it.
+ * @return - False if any part of the file could not be compressed or written.
+ */
+bool CompressedFile::close() {
+    if (!writer.joinable()) {
+        return !failed;
+    }
+
+    handOff(true);
+    writer.join();
+    setp(NULL, NULL);
+
+    if (compression == GZIP_COMPRESSION) {
+        deflateEnd(&gzip);
+    }
+#ifdef HAVE_ZSTD
+    ZSTD_freeCStream(zstd);
+    zstd = NULL;
+#endif
+
+    file.close();
+    if (file.fail()) {
+        failed = true;
+    }
+    return !failed;
+}
+
+/**
+ * Checks if a file is open.
+ * @return - True while a file is open.
+ */
+bool CompressedFile::isOpen() const {
+    return writer.joinable();
+}
+
+/**
+ * Gets the ending added to the name of a file compressed a certain way.
+ * @param compression - The way the file is compressed.
+ * @return - ".gz" or ".zst", or an empty string for 'NO_COMPRESSION'.
+ */
+const char* CompressedFile::extension(Compression compression) {
+    switch (compression) {
+        case GZIP_COMPRESSION:
+            return ".gz";
+        case ZSTD_COMPRESSION:
+            return ".zst";
+        default:
+            return "";
+    }
+}
+
+/**
+ * Checks if this build can write files compressed a certain way. Files
+ * compressed with zstd need the program to be built with HAVE_ZSTD.
+ * @param compression - The way the file is compressed.
+ * @return - False if 'open' would always fail for this compression.
+ */
+bool CompressedFile::isSupported(Compression compression) {
+    return compression != ZSTD_COMPRESSION || ZSTD_BUILT;
+}
+
+/**
+ * Called by the stream when the current block is full. Hands the block to the
+ * background thread and stores the character at the start of the next block.
+ * @param c - The character which did not fit, or EOF.
+ * @return - EOF if no file is open, otherwise anything else.
+ */
+CompressedFile::int_type CompressedFile::overflow(int_type c) {
+    if (pbase() == NULL) {
+        return traits_type::eof();
+    }
+
+    handOff(false);
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/**
+ * Called by the stream to add several characters at once.
+ * @param text - The characters to add.
+ * @param count - The number of characters.
+ * @return - The number of characters added.
+ */
+streamsize CompressedFile::xsputn(const char* text, streamsize count) {
+    if (pbase() == NULL) {
+        return 0;
+    }
+
+    // The text is copied into the block in pieces, handing the block off each
+    // time it fills up.
+    streamsize written = 0;
+    while (written < count) {
+        streamsize room = epptr() - pptr();
+        if (room == 0) {
+            handOff(false);
+            continue;
+        }
+
+        streamsize piece = (count - written < room) ? count - written : room;
+        memcpy(pptr(), text + written, piece);
+        pbump(piece);
+        written += piece;
+    }
+    return written;
+}
+
+/**
+ * Called by the stream when it is flushed. Hands the current block to the
+ * background thread, even if it is not full.
+ * @return - 0, or -1 if the file has failed.
+ */
+int CompressedFile::sync() {
+    if (pbase() != NULL && pptr() > pbase()) {
+        handOff(false);
+    }
+    return failed ? -1 : 0;
+}
+
+/**
+ * Function which hands the current block to the background thread and waits
+ * until the other block is free to be filled.
+ * @param last - Set if this is the final block of the file.
+ */
+void CompressedFile::handOff(bool last) {
+    unique_lock<mutex> lock(blockMutex);
+
+    lengths[current] = pptr() - pbase();
+    full[current] = true;
+    if (last) {
+        finalBlock = current;
+    }
+    blockReady.notify_all();
+
+    if (last) {
+        return;
+    }
+
+    // Blocks are written in the same order they are filled, so the other block
+    // is free once the background thread has written it.
+    current = 1 - current;
+    while (full[current]) {
+        blockReady.wait(lock);
+    }
+    setp(&blocks[current][0], &blocks[current][0] + blockSize);
+}
+
+/**
+ * Function run by the background thread. Compresses and writes each block in
+ * the order they were filled, until the final block has been written.
+ */
+void CompressedFile::compressAhead() {
+    int next = 0;
+
+    while (true) {
+        bool last;
+
+        // Waits until the stream has handed this block over.
+        {
+            unique_lock<mutex> lock(blockMutex);
+            while (!full[next]) {
+                blockReady.wait(lock);
+            }
+            last = (finalBlock == next);
+        }
+
+        // The block is compressed without holding the lock so the stream can
+        // keep filling the other block. Once the file has failed, the blocks
+        // are still taken so the stream is never left waiting.
+        if (!failed) {
+            compressBlock(&blocks[next][0], lengths[next], last);
+        }
+
+        {
+            lock_guard<mutex> lock(blockMutex);
+            full[next] = false;
+        }
+        blockReady.notify_all();
+
+        if (last) {
+            return;
+        }
+        next = 1 - next;
+    }
+}
+
+/**
+ * Function which compresses a block and writes the result to the file.
+ * @param data - The text in the block.
+ * @param length - The number of bytes in the block.
+ * @param last - Set if this is the final block, which ends the compressed stream.
+ */
+void CompressedFile::compressBlock(const char* data, size_t length, bool last) {
+    switch (compression) {
+        case GZIP_COMPRESSION:
+        {
+            gzip.next_in = (Bytef*) data;
+            gzip.avail_in = length;
+
+            // The compressor is called until it leaves room in the output, which
+            // means it has taken all the input, or has ended the stream if asked to.
+            do {
+                gzip.next_out = (Bytef*) & packed[0];
+                gzip.avail_out = packed.size();
+                if (deflate(&gzip, last ? Z_FINISH : Z_NO_FLUSH) == Z_STREAM_ERROR) {
+                    failed = true;
+                    return;
+                }
+                writePacked(packed.size() - gzip.avail_out);
+            } while (gzip.avail_out == 0);
+            break;
+        }
+#ifdef HAVE_ZSTD
+        case ZSTD_COMPRESSION:
+        {
+            ZSTD_inBuffer input = {data, length, 0};
+            ZSTD_EndDirective mode = last ? ZSTD_e_end : ZSTD_e_continue;
+            bool finished;
+
+            // The final block is done once the compressor has nothing left to write,
+            // any other block once all of its input has been taken.
+            do {
+                ZSTD_outBuffer output = {&packed[0], packed.size(), 0};
+                size_t remaining = ZSTD_compressStream2(zstd, &output, &input, mode);
+                if (ZSTD_isError(remaining)) {
+                    failed = true;
+                    return;
+                }
+                writePacked(output.pos);
+                finished = last ? (remaining == 0) : (input.pos == input.size);
+            } while (!finished);
+            break;
+        }
+#endif
+        default:
+            file.write(data, length);
+            if (file.fail()) {
+                failed = true;
+            }
+            break;
+    }
+}
+
+/**
+ * Function which writes compressed bytes from 'packed' to the file.
+ * @param length - The number of bytes to write.
+ */
+void CompressedFile::writePacked(size_t length) {
+    if (length > 0) {
+        file.write(&packed[0], length);
+        if (file.fail()) {
+            failed = true;
+        }
+    }
+}
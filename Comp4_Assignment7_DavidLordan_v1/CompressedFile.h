@@ -0,0 +1,199 @@
+/* File:   CompressedFile.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the CompressedFile class, a stream buffer which writes
+ * a file compressed with gzip or zstd. It is used by wrapping it in an ostream, so
+ * anything which writes to a stream can write a compressed file.
+ *
+ * Text written to the stream is collected in one of two blocks. Once a block is full
+ * it is handed to a background thread, which compresses it and writes it to the file
+ * while the other block is being filled, so that building the output and compressing
+ * it happen at the same time. Files compressed with zstd can only be written when the
+ * program is built with HAVE_ZSTD defined and linked with libzstd.
+ */
+
+#ifndef COMPRESSEDFILE_H
+#define	COMPRESSEDFILE_H
+
+#include <streambuf>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+/**
+ * The ways a file can be compressed.
+ */
+enum Compression {
+    NO_COMPRESSION, GZIP_COMPRESSION, ZSTD_COMPRESSION
+};
+
+class CompressedFile : public streambuf {
+public:
+
+    /**
+     * Custom constructor. Nothing is written until a file is opened.
+     * @param nBlockSize - The number of bytes collected before they are compressed. Defaults to 256 KB.
+     */
+    CompressedFile(size_t nBlockSize = 1 << 18);
+
+    /**
+     * Standard destructor. Finishes and closes any open file.
+     */
+    virtual ~CompressedFile();
+
+    /**
+     * Opens a file and starts the background thread which compresses it.
+     * @param strPath - The name of the file to write.
+     * @param nCompression - The way the file is compressed. With 'NO_COMPRESSION'
+     *                       the text is written as it is, still on the background thread.
+     * @return - False if the file could not be opened or the compression is not
+     *           supported by this build.
+     */
+    bool open(const string &strPath, Compression nCompression);
+
+    /**
+     * Compresses the rest of the text, finishes the file and closes it.
+     * @return - False if any part of the file could not be compressed or written.
+     */
+    bool close();
+
+    /**
+     * Checks if a file is open.
+     * @return - True while a file is open.
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets the ending added to the name of a file compressed a certain way.
+     * @param compression - The way the file is compressed.
+     * @return - ".gz" or ".zst", or an empty string for 'NO_COMPRESSION'.
+     */
+    static const char* extension(Compression compression);
+
+    /**
+     * Checks if this build can write files compressed a certain way. Files
+     * compressed with zstd need the program to be built with HAVE_ZSTD.
+     * @param compression - The way the file is compressed.
+     * @return - False if 'open' would always fail for this compression.
+     */
+    static bool isSupported(Compression compression);
+
+protected:
+
+    /**
+     * Called by the stream when the current block is full. Hands the block to the
+     * background thread and stores the character at the start of the next block.
+     * @param c - The character which did not fit, or EOF.
+     * @return - EOF if no file is open, otherwise anything else.
+     */
+    int_type overflow(int_type c);
+
+    /**
+     * Called by the stream to add several characters at once.
+     * @param text - The characters to add.
+     * @param count - The number of characters.
+     * @return - The number of characters added.
+     */
+    streamsize xsputn(const char* text, streamsize count);
+
+    /**
+     * Called by the stream when it is flushed. Hands the current block to the
+     * background thread, even if it is not full.
+     * @return - 0, or -1 if the file has failed.
+     */
+    int sync();
+
+private:
+
+    /** Copying a file would copy the running thread, so it is not allowed. */
+    CompressedFile(const CompressedFile& orig);
+    CompressedFile& operator=(const CompressedFile& orig);
+
+    /**
+     * Function which hands the current block to the background thread and waits
+     * until the other block is free to be filled.
+     * @param last - Set if this is the final block of the file.
+     */
+    void handOff(bool last);
+
+    /**
+     * Function run by the background thread. Compresses and writes each block in
+     * the order they were filled, until the final block has been written.
+     */
+    void compressAhead();
+
+    /**
+     * Function which compresses a block and writes the result to the file.
+     * @param data - The text in the block.
+     * @param length - The number of bytes in the block.
+     * @param last - Set if this is the final block, which ends the compressed stream.
+     */
+    void compressBlock(const char* data, size_t length, bool last);
+
+    /**
+     * Function which writes compressed bytes from 'packed' to the file.
+     * @param length - The number of bytes to write.
+     */
+    void writePacked(size_t length);
+
+    /** The file being written. Only used by the background thread once it is started. */
+    ofstream file;
+
+    /** The way the open file is compressed. */
+    Compression compression;
+
+    /** The number of bytes collected before they are compressed. */
+    size_t blockSize;
+
+    /** The two blocks the text is collected in. */
+    vector<char> blocks[2];
+
+    /** The number of bytes stored in each block once it has been handed off. */
+    size_t lengths[2];
+
+    /** Set while a block holds text that the background thread has not written. */
+    bool full[2];
+
+    /** The block which ends the file, or -1 until it has been handed off. */
+    int finalBlock;
+
+    /** The block currently being filled. */
+    int current;
+
+    /** Set if any part of the file could not be compressed or written. */
+    atomic<bool> failed;
+
+    /** Buffer holding compressed bytes before they are written to the file. */
+    vector<char> packed;
+
+    /** The state of the gzip compressor. */
+    z_stream gzip;
+
+#ifdef HAVE_ZSTD
+    /** The state of the zstd compressor. */
+    ZSTD_CStream* zstd;
+#endif
+
+    /** Mutex and condition variable shared by the stream and the background thread. */
+    mutex blockMutex;
+    condition_variable blockReady;
+
+    /** The background thread which compresses the file. */
+    thread writer;
+};
+
+#endif	/* COMPRESSEDFILE_H */
+
@@ -0,0 +1,259 @@
+/* File:   CopyOnWriteView.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the CopyOnWriteView class, which shows the tree
+ * as it was when the view was opened. Each node keeps its live state until it is first
+ * changed, when the part which changes is copied, so opening the view is constant time.
+ */
+
+#include <thread>
+#include "CopyOnWriteView.h"
+
+/**
+ * Helper function to copy a null terminated XMLCh string into a vector.
+ * @param input - The string to copy.
+ * @param output - The copy. Passed by reference.
+ */
+static void copyInto(const XMLCh* input, vector<XMLCh> &output) {
+    output.assign(input, input + XMLString::stringLen(input) + 1);
+}
+
+/**
+ * Default constructor. The view starts closed.
+ */
+CopyOnWriteView::CopyOnWriteView() : waiting(0) {
+    opened = false;
+}
+
+/**
+ * Standard destructor. Closes the view, releasing any nodes it kept.
+ */
+CopyOnWriteView::~CopyOnWriteView() {
+    close();
+}
+
+/**
+ * Opens the view at the current state of the tree. Nothing is copied until
+ * the tree is changed. Called with the lock held.
+ */
+void CopyOnWriteView::open() {
+    opened = true;
+}
+
+/**
+ * Closes the view, dropping every copy and releasing the nodes which were
+ * kept for it. Called with the lock held, once nothing reads the view.
+ */
+void CopyOnWriteView::close() {
+    opened = false;
+    children.clear();
+    names.clear();
+    attributes.clear();
+
+    for (size_t i = 0; i < kept.size(); i++) {
+        kept[i]->release();
+    }
+    kept.clear();
+}
+
+/**
+ * Checks if the view is open.
+ * @return - True while the view is open.
+ */
+bool CopyOnWriteView::isOpen() const {
+    return opened;
+}
+
+/**
+ * Copies the children of a node which are part of the view, before one is
+ * added or removed. Does nothing if the view is closed or already has them.
+ * @param parent - The node whose children are changing.
+ * @param added - A child which was just added and is not part of the view, or NULL.
+ */
+void CopyOnWriteView::preserveChildren(const DOMNode* parent, const DOMNode* added) {
+    if (!opened || parent == NULL || children.count(parent) > 0) {
+        return;
+    }
+
+    vector<DOMNode*> &copy = children[parent];
+    for (DOMNode* child = parent->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        if (child != added) {
+            copy.push_back(child);
+        }
+    }
+}
+
+/**
+ * Copies the name of an element before it is renamed. Does nothing if the
+ * view is closed or already has it.
+ * @param elem - The element being renamed.
+ * @param oldName - The name it has before the change.
+ */
+void CopyOnWriteView::preserveName(const DOMNode* elem, const XMLCh* oldName) {
+    if (!opened || names.count(elem) > 0) {
+        return;
+    }
+    copyInto(oldName, names[elem]);
+}
+
+/**
+ * Copies the attributes of an element before one is set or removed. Does
+ * nothing if the view is closed or already has them.
+ * @param elem - The element whose attributes are changing.
+ */
+void CopyOnWriteView::preserveAttributes(const DOMNode* elem) {
+    if (!opened || attributes.count(elem) > 0) {
+        return;
+    }
+
+    vector<CopiedAttribute> &copy = attributes[elem];
+    DOMNamedNodeMap* atts = elem->getAttributes();
+    copy.resize(atts->getLength());
+    for (XMLSize_t i = 0; i < copy.size(); i++) {
+        DOMNode* att = atts->item(i);
+        copyInto(att->getNodeName(), copy[i].first);
+        copyInto(att->getNodeValue(), copy[i].second);
+    }
+}
+
+/**
+ * Keeps a node which is about to be released until the view is closed, since
+ * the view may still read it.
+ * @param node - The node, out of the tree.
+ * @return - True if the view kept the node, in which case it must not be released.
+ */
+bool CopyOnWriteView::releaseLater(DOMNode* node) {
+    if (!opened) {
+        return false;
+    }
+    kept.push_back(node);
+    return true;
+}
+
+/**
+ * Gets the first child of a node as it was when the view was opened.
+ * @param node - The node.
+ * @return - The first child, or NULL if there were none.
+ */
+DOMNode* CopyOnWriteView::getFirstChild(const DOMNode* node) const {
+    return getNextChild(node, NULL, 0);
+}
+
+/**
+ * Gets the next child of a node as it was when the view was opened.
+ * @param parent - The node whose children are being read.
+ * @param previous - The child read before this one.
+ * @param position - The number of children read so far.
+ * @return - The next child, or NULL if there are no more.
+ */
+DOMNode* CopyOnWriteView::getNextChild(const DOMNode* parent, const DOMNode* previous, size_t position) const {
+    // Until a node's children change, the live list is the one in the view. Once
+    // they do, the copy takes over from the same position, which is why it is
+    // counted rather than following the previous child.
+    if (!children.empty()) {
+        unordered_map<const DOMNode*, vector<DOMNode*> >::const_iterator copy = children.find(parent);
+        if (copy != children.end()) {
+            return (position < copy->second.size()) ? copy->second[position] : NULL;
+        }
+    }
+    return (previous == NULL) ? parent->getFirstChild() : previous->getNextSibling();
+}
+
+/**
+ * Gets the name of a node as it was when the view was opened.
+ * @param node - The node.
+ * @return - The name, valid until the lock is given up.
+ */
+const XMLCh* CopyOnWriteView::getName(const DOMNode* node) const {
+    if (!names.empty()) {
+        unordered_map<const DOMNode*, vector<XMLCh> >::const_iterator copy = names.find(node);
+        if (copy != names.end()) {
+            return &copy->second[0];
+        }
+    }
+    return node->getNodeName();
+}
+
+/**
+ * Gets the number of attributes an element had when the view was opened.
+ * @param elem - The element.
+ * @return - The number of attributes.
+ */
+XMLSize_t CopyOnWriteView::getAttributeCount(const DOMNode* elem) const {
+    if (!attributes.empty()) {
+        unordered_map<const DOMNode*, vector<CopiedAttribute> >::const_iterator copy = attributes.find(elem);
+        if (copy != attributes.end()) {
+            return copy->second.size();
+        }
+    }
+    return elem->getAttributes()->getLength();
+}
+
+/**
+ * Gets the name of an attribute of an element as it was when the view was opened.
+ * @param elem - The element.
+ * @param i - The position of the attribute.
+ * @return - The name, valid until the lock is given up.
+ */
+const XMLCh* CopyOnWriteView::getAttributeName(const DOMNode* elem, XMLSize_t i) const {
+    if (!attributes.empty()) {
+        unordered_map<const DOMNode*, vector<CopiedAttribute> >::const_iterator copy = attributes.find(elem);
+        if (copy != attributes.end()) {
+            return &copy->second[i].first[0];
+        }
+    }
+    return elem->getAttributes()->item(i)->getNodeName();
+}
+
+/**
+ * Gets the value of an attribute of an element as it was when the view was opened.
+ * @param elem - The element.
+ * @param i - The position of the attribute.
+ * @return - The value, valid until the lock is given up.
+ */
+const XMLCh* CopyOnWriteView::getAttributeValue(const DOMNode* elem, XMLSize_t i) const {
+    if (!attributes.empty()) {
+        unordered_map<const DOMNode*, vector<CopiedAttribute> >::const_iterator copy = attributes.find(elem);
+        if (copy != attributes.end()) {
+            return &copy->second[i].second[0];
+        }
+    }
+    return elem->getAttributes()->item(i)->getNodeValue();
+}
+
+/**
+ * Takes the lock on the tree, for the shell. A reader holding it gives it up
+ * at its next node.
+ */
+void CopyOnWriteView::lock() {
+    waiting++;
+    treeLock.lock();
+    waiting--;
+}
+
+/**
+ * Gives up the lock on the tree.
+ */
+void CopyOnWriteView::unlock() {
+    treeLock.unlock();
+}
+
+/**
+ * Called by the reader for every node it reads, with the lock held. Gives
+ * the lock up to the shell if it is waiting, then takes it back.
+ */
+void CopyOnWriteView::visit() {
+    if (waiting.load(memory_order_relaxed) > 0) {
+        treeLock.unlock();
+
+        // The shell only stops waiting once it holds the lock, so the reader
+        // cannot take it straight back.
+        while (waiting.load() > 0) {
+            this_thread::yield();
+        }
+        treeLock.lock();
+    }
+}
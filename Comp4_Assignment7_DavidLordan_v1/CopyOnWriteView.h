@@ -0,0 +1,195 @@
+/* File:   CopyOnWriteView.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the CopyOnWriteView class, which lets the tree be read
+ * as it was at one moment while the shell keeps changing it. Opening the view costs
+ * nothing, since it shares every node with the live tree. The first time a node is
+ * about to be changed, the part of it which is changing is copied into the view:
+ *
+ *     Children   - The list of children, before one is added or removed.
+ *     Name       - The name of an element, before it is renamed.
+ *     Attributes - Every attribute of an element, before one is set or removed.
+ *
+ * Reading a node through the view gives the copy if there is one and the live node
+ * otherwise, so the view only costs as much as the changes made while it is open.
+ * Text nodes are never changed in place by the shell, so their values are always
+ * read from the live tree. Nodes taken out of the tree may still be part of the
+ * view, so those which would be released are kept until the view is closed.
+ *
+ * The live tree is shared with a reader on another thread, so both sides hold the
+ * view's lock while they use the tree. The reader gives the lock up every so often
+ * if the shell is waiting for it, so a command never waits long.
+ */
+
+#ifndef COPYONWRITEVIEW_H
+#define	COPYONWRITEVIEW_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class CopyOnWriteView {
+public:
+
+    /**
+     * Default constructor. The view starts closed.
+     */
+    CopyOnWriteView();
+
+    /**
+     * Standard destructor. Closes the view, releasing any nodes it kept.
+     */
+    virtual ~CopyOnWriteView();
+
+    /**
+     * Opens the view at the current state of the tree. Nothing is copied until
+     * the tree is changed. Called with the lock held.
+     */
+    void open();
+
+    /**
+     * Closes the view, dropping every copy and releasing the nodes which were
+     * kept for it. Called with the lock held, once nothing reads the view.
+     */
+    void close();
+
+    /**
+     * Checks if the view is open.
+     * @return - True while the view is open.
+     */
+    bool isOpen() const;
+
+    /**
+     * Copies the children of a node which are part of the view, before one is
+     * added or removed. Does nothing if the view is closed or already has them.
+     * @param parent - The node whose children are changing.
+     * @param added - A child which was just added and is not part of the view, or NULL.
+     */
+    void preserveChildren(const DOMNode* parent, const DOMNode* added = NULL);
+
+    /**
+     * Copies the name of an element before it is renamed. Does nothing if the
+     * view is closed or already has it.
+     * @param elem - The element being renamed.
+     * @param oldName - The name it has before the change.
+     */
+    void preserveName(const DOMNode* elem, const XMLCh* oldName);
+
+    /**
+     * Copies the attributes of an element before one is set or removed. Does
+     * nothing if the view is closed or already has them.
+     * @param elem - The element whose attributes are changing.
+     */
+    void preserveAttributes(const DOMNode* elem);
+
+    /**
+     * Keeps a node which is about to be released until the view is closed, since
+     * the view may still read it.
+     * @param node - The node, out of the tree.
+     * @return - True if the view kept the node, in which case it must not be released.
+     */
+    bool releaseLater(DOMNode* node);
+
+    /**
+     * Gets the first child of a node as it was when the view was opened.
+     * @param node - The node.
+     * @return - The first child, or NULL if there were none.
+     */
+    DOMNode* getFirstChild(const DOMNode* node) const;
+
+    /**
+     * Gets the next child of a node as it was when the view was opened.
+     * @param parent - The node whose children are being read.
+     * @param previous - The child read before this one.
+     * @param position - The number of children read so far.
+     * @return - The next child, or NULL if there are no more.
+     */
+    DOMNode* getNextChild(const DOMNode* parent, const DOMNode* previous, size_t position) const;
+
+    /**
+     * Gets the name of a node as it was when the view was opened.
+     * @param node - The node.
+     * @return - The name, valid until the lock is given up.
+     */
+    const XMLCh* getName(const DOMNode* node) const;
+
+    /**
+     * Gets the number of attributes an element had when the view was opened.
+     * @param elem - The element.
+     * @return - The number of attributes.
+     */
+    XMLSize_t getAttributeCount(const DOMNode* elem) const;
+
+    /**
+     * Gets the name of an attribute of an element as it was when the view was opened.
+     * @param elem - The element.
+     * @param i - The position of the attribute.
+     * @return - The name, valid until the lock is given up.
+     */
+    const XMLCh* getAttributeName(const DOMNode* elem, XMLSize_t i) const;
+
+    /**
+     * Gets the value of an attribute of an element as it was when the view was opened.
+     * @param elem - The element.
+     * @param i - The position of the attribute.
+     * @return - The value, valid until the lock is given up.
+     */
+    const XMLCh* getAttributeValue(const DOMNode* elem, XMLSize_t i) const;
+
+    /**
+     * Takes the lock on the tree, for the shell. A reader holding it gives it up
+     * at its next node.
+     */
+    void lock();
+
+    /**
+     * Gives up the lock on the tree.
+     */
+    void unlock();
+
+    /**
+     * Called by the reader for every node it reads, with the lock held. Gives
+     * the lock up to the shell if it is waiting, then takes it back.
+     */
+    void visit();
+
+private:
+
+    /** The name and value of an attribute. */
+    typedef pair<vector<XMLCh>, vector<XMLCh> > CopiedAttribute;
+
+    /** Set while the view is open. */
+    bool opened;
+
+    /** The children of each node changed since the view was opened. */
+    unordered_map<const DOMNode*, vector<DOMNode*> > children;
+
+    /** The name of each element renamed since the view was opened. */
+    unordered_map<const DOMNode*, vector<XMLCh> > names;
+
+    /** The attributes of each element whose attributes changed since the view was opened. */
+    unordered_map<const DOMNode*, vector<CopiedAttribute> > attributes;
+
+    /** Nodes which would have been released while the view was open. */
+    vector<DOMNode*> kept;
+
+    /** Held by whichever side is using the tree. */
+    mutex treeLock;
+
+    /** The number of times the shell is waiting for the lock. */
+    atomic<int> waiting;
+};
+
+#endif	/* COPYONWRITEVIEW_H */
+
@@ -0,0 +1,213 @@
+/* File:   DocumentLoader.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the DocumentLoader class, which is used by the 'load'
+ * command to read an existing XML file into the shell. The file is parsed with
+ * the Xerces DOM parser, which is created once and reused for every load unless
+ * the user asks for a new one. Validation and namespace processing are off by
+ * default since the shell does not use them, and comments are not kept since the
+ * shell cannot display them. Once the file is parsed the whitespace used to indent
+ * it is removed and the lookup index used by the editing commands is built.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <xercesc/sax/SAXParseException.hpp>
+#include "DocumentLoader.h"
+
+/**
+ * Helper function to print an error message from Xerces.
+ * @param fileName - The name of the file which could not be loaded.
+ * @param message - The message given by Xerces.
+ * @param line - The line of the file on which the error was found, 0 if not known.
+ */
+static void printError(const string &fileName, const XMLCh* message, XMLFileLoc line = 0) {
+    char* cMessage = XMLString::transcode(message);
+    cout << "Could not load '" << fileName << "'";
+    if (line != 0) {
+        cout << ", error on line " << line;
+    }
+    cout << ": " << cMessage << endl;
+    XMLString::release(&cMessage);
+}
+
+/**
+ * Standard constructor. The parser is not created until the first load.
+ */
+DocumentLoader::DocumentLoader() {
+    parser = NULL;
+}
+
+/**
+ * Standard destructor. Releases the parser if it is still held.
+ */
+DocumentLoader::~DocumentLoader() {
+    release();
+}
+
+/**
+ * Reads the options given after the file name of a 'load' command.
+ * @param flags - The rest of the command, a list of option names.
+ * @param options - The options read. Passed by reference.
+ * @return - False if an option was not recognized.
+ */
+bool DocumentLoader::parseOptions(const string &flags, LoadOptions &options) {
+    options.validate = false;
+    options.namespaces = false;
+    options.keepSpace = false;
+    options.newParser = false;
+
+    istringstream words(flags);
+    string word;
+
+    while (words >> word) {
+        if (word == "validate") {
+            options.validate = true;
+        } else if (word == "namespaces") {
+            options.namespaces = true;
+        } else if (word == "keepspace") {
+            options.keepSpace = true;
+        } else if (word == "newparser") {
+            options.newParser = true;
+        } else {
+            cout << "Unknown load option '" << word << "'. Options are 'validate', "
+                    "'namespaces', 'keepspace' and 'newparser'." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Removes the text nodes made up only of whitespace from every element
+ * which also contains other elements.
+ * @param root - The element whose subtree is cleaned up.
+ */
+void DocumentLoader::removeWhitespace(DOMNode* root) {
+    bool hasElements = false;
+
+    for (DOMNode* child = root->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        if (child->getNodeType() == DOMNode::ELEMENT_NODE) {
+            hasElements = true;
+            removeWhitespace(child);
+        }
+    }
+
+    // Elements holding only text keep it, even if it is all whitespace.
+    if (!hasElements) {
+        return;
+    }
+
+    DOMNode* child = root->getFirstChild();
+    while (child != NULL) {
+        DOMNode* next = child->getNextSibling();
+
+        if (child->getNodeType() == DOMNode::TEXT_NODE) {
+            const XMLCh* text = child->getNodeValue();
+            while (*text == chSpace || *text == chLF || *text == chHTab || *text == chCR) {
+                text++;
+            }
+
+            if (*text == 0) {
+                root->removeChild(child)->release();
+            }
+        }
+        child = next;
+    }
+}
+
+/**
+ * Parses an XML file and replaces the current document with it. The lookup
+ * index is rebuilt for the new document. If the file cannot be parsed the
+ * current document is kept.
+ * @param doc - The current document, replaced by the loaded one. Passed by reference.
+ * @param fileName - The name of the XML file.
+ * @param options - The options for this load.
+ * @param index - The lookup index used by the editing commands.
+ * @return - True if the file was loaded.
+ */
+bool DocumentLoader::load(DOMDocument* &doc, string fileName, const LoadOptions &options, NodeIndex &index) {
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    // The parser is kept between loads so its setup is only done once.
+    if (options.newParser) {
+        release();
+    }
+    bool reused = (parser != NULL);
+    if (!reused) {
+        parser = new XercesDOMParser();
+
+        // Comments and entity reference nodes are not kept, since the shell has
+        // no way to display them.
+        parser->setCreateCommentNodes(false);
+        parser->setCreateEntityReferenceNodes(false);
+    }
+
+    parser->setValidationScheme(options.validate ? XercesDOMParser::Val_Auto : XercesDOMParser::Val_Never);
+    parser->setDoSchema(options.validate);
+    parser->setLoadExternalDTD(options.validate);
+    parser->setDoNamespaces(options.namespaces);
+    parser->setIncludeIgnorableWhitespace(options.keepSpace);
+
+    try {
+        parser->parse(fileName.c_str());
+    } catch (const SAXParseException &e) {
+        printError(fileName, e.getMessage(), e.getLineNumber());
+        parser->resetDocumentPool();
+        return false;
+    } catch (const XMLException &e) {
+        printError(fileName, e.getMessage());
+        parser->resetDocumentPool();
+        return false;
+    } catch (const DOMException &e) {
+        printError(fileName, e.getMessage());
+        parser->resetDocumentPool();
+        return false;
+    }
+
+    if (parser->getErrorCount() != 0 || parser->getDocument() == NULL
+            || parser->getDocument()->getDocumentElement() == NULL) {
+        cout << "Could not load '" << fileName << "': the file is not a valid XML document." << endl;
+        parser->resetDocumentPool();
+        return false;
+    }
+
+    // The new document is taken over from the parser so that it is not released
+    // by the next load.
+    DOMDocument* newDoc = parser->adoptDocument();
+    chrono::steady_clock::time_point parsed = chrono::steady_clock::now();
+
+    if (!options.keepSpace) {
+        removeWhitespace(newDoc->getDocumentElement());
+    }
+    index.build(newDoc);
+    chrono::steady_clock::time_point indexed = chrono::steady_clock::now();
+
+    // The old document is no longer needed.
+    doc->release();
+    doc = newDoc;
+
+    chrono::duration<double> parseTime = parsed - start;
+    chrono::duration<double> indexTime = indexed - parsed;
+
+    cout << "Loaded '" << fileName << "' with " << index.size() << " elements in "
+            << (parseTime + indexTime).count() << " seconds (parsing "
+            << parseTime.count() << ", indexing " << indexTime.count() << ")." << endl;
+    if (reused) {
+        cout << "Reused the parser from the previous load." << endl;
+    }
+    return true;
+}
+
+/**
+ * Releases the parser. Must be called before the XML platform utilities are closed.
+ */
+void DocumentLoader::release() {
+    delete parser;
+    parser = NULL;
+}
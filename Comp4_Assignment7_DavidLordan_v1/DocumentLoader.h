@@ -0,0 +1,102 @@
+/* File:   DocumentLoader.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the DocumentLoader class, which is used by the 'load'
+ * command to read an existing XML file into the shell. The file is parsed with
+ * the Xerces DOM parser, which is created once and reused for every load unless
+ * the user asks for a new one. Validation and namespace processing are off by
+ * default since the shell does not use them, and comments are not kept since the
+ * shell cannot display them. Once the file is parsed the whitespace used to indent
+ * it is removed and the lookup index used by the editing commands is built.
+ */
+
+#ifndef DOCUMENTLOADER_H
+#define	DOCUMENTLOADER_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <string>
+#include "NodeIndex.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+/**
+ * Structure storing the options given to the 'load' command.
+ */
+struct LoadOptions {
+    /** Validates the file against its DTD or schema, if it has one. */
+    bool validate;
+
+    /** Turns on namespace processing. */
+    bool namespaces;
+
+    /** Keeps the whitespace between elements instead of removing it. */
+    bool keepSpace;
+
+    /** Creates a new parser instead of reusing the one from the last load. */
+    bool newParser;
+};
+
+class DocumentLoader {
+public:
+
+    /**
+     * Standard constructor. The parser is not created until the first load.
+     */
+    DocumentLoader();
+
+    /**
+     * Standard destructor. Releases the parser if it is still held.
+     */
+    virtual ~DocumentLoader();
+
+    /**
+     * Reads the options given after the file name of a 'load' command.
+     * @param flags - The rest of the command, a list of option names.
+     * @param options - The options read. Passed by reference.
+     * @return - False if an option was not recognized.
+     */
+    static bool parseOptions(const string &flags, LoadOptions &options);
+
+    /**
+     * Parses an XML file and replaces the current document with it. The lookup
+     * index is rebuilt for the new document. If the file cannot be parsed the
+     * current document is kept.
+     * @param doc - The current document, replaced by the loaded one. Passed by reference.
+     * @param fileName - The name of the XML file.
+     * @param options - The options for this load.
+     * @param index - The lookup index used by the editing commands.
+     * @return - True if the file was loaded.
+     */
+    bool load(DOMDocument* &doc, string fileName, const LoadOptions &options, NodeIndex &index);
+
+    /**
+     * Releases the parser. Must be called before the XML platform utilities are closed.
+     */
+    void release();
+
+private:
+
+    /** Copying a loader would release the parser twice, so it is not allowed. */
+    DocumentLoader(const DocumentLoader& orig);
+    DocumentLoader& operator=(const DocumentLoader& orig);
+
+    /**
+     * Removes the text nodes made up only of whitespace from every element
+     * which also contains other elements.
+     * @param root - The element whose subtree is cleaned up.
+     */
+    static void removeWhitespace(DOMNode* root);
+
+    /** The Xerces parser, created by the first load. */
+    XercesDOMParser* parser;
+};
+
+#endif	/* DOCUMENTLOADER_H */
+
@@ -0,0 +1,501 @@
+/* File:   Journal.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the Journal class, which records the changes made
+ * by the editing commands so that they can be undone and redone. Each entry keeps
+ * a list of operations which swap the tree between its state before and after the
+ * command, so undoing and redoing never copy a subtree. Recording only happens
+ * while an entry is open, and costs one small operation for each node changed.
+ * Removed subtrees are released once no operation refers to them.
+ */
+
+#include "Journal.h"
+
+/**
+ * Helper function to copy a null terminated XMLCh string into a vector.
+ * @param input - The string to copy.
+ * @param output - The copy. Passed by reference.
+ */
+static void copyInto(const XMLCh* input, vector<XMLCh> &output) {
+    output.assign(input, input + XMLString::stringLen(input) + 1);
+}
+
+/**
+ * Custom constructor.
+ * @param nMaxUndo - The number of entries which can be undone. Older entries
+ *                   are kept in the history, but their operations are dropped.
+ */
+Journal::Journal(size_t nMaxUndo) {
+    maxUndo = nMaxUndo;
+    applied = 0;
+    firstUndo = 0;
+    depth = 0;
+    changes = 0;
+    change = CHANGE_NONE;
+    current.replaced = false;
+    view = NULL;
+    cache = NULL;
+}
+
+/**
+ * Sets the view which is told about every change before it is made.
+ * @param nView - The view, or NULL for none.
+ */
+void Journal::setView(CopyOnWriteView* nView) {
+    view = nView;
+}
+
+/**
+ * Sets the cache of written bytes which is invalidated by every change.
+ * @param nCache - The cache, or NULL for none.
+ */
+void Journal::setCache(SubtreeCache* nCache) {
+    cache = nCache;
+}
+
+/**
+ * Starts an entry for a command. Calls may be nested, so the commands in a
+ * transaction join the entry which was started by 'begin'.
+ * @param input - The command as it was typed.
+ */
+void Journal::beginEntry(const string &input) {
+    if (depth++ > 0) {
+        addInput(input);
+        return;
+    }
+
+    current.commands = input;
+    current.ops.clear();
+    current.replaced = false;
+}
+
+/**
+ * Adds a line typed in answer to a prompt to the open entry, so that the
+ * history can be entered into the shell again.
+ * @param input - The line typed.
+ */
+void Journal::addInput(const string &input) {
+    if (depth > 0) {
+        current.commands += "\n" + input;
+    }
+}
+
+/**
+ * Ends a call to 'beginEntry'. An entry which did not change the tree is dropped.
+ */
+void Journal::endEntry() {
+    if (depth == 0 || --depth > 0) {
+        return;
+    }
+
+    // Nodes removed after the tree was replaced cannot be undone, so they are
+    // released once the command is complete.
+    for (size_t i = 0; i < discarded.size(); i++) {
+        release(discarded[i]);
+    }
+    discarded.clear();
+
+    if (current.ops.empty() && !current.replaced) {
+        return;
+    }
+
+    // Entries which were undone can no longer be redone once a new change is
+    // made. Their nodes belong to the old document if the tree was replaced.
+    for (size_t i = applied; i < entries.size(); i++) {
+        dropOps(entries[i].ops, !current.replaced);
+    }
+    entries.resize(applied);
+    entries.push_back(JournalEntry());
+    entries.back().commands.swap(current.commands);
+    entries.back().ops.swap(current.ops);
+    entries.back().replaced = current.replaced;
+    applied = entries.size();
+    changes++;
+    change = CHANGE_ENTRY;
+
+    // The operations of entries which can no longer be undone are dropped,
+    // either because the tree they refer to was replaced or because there
+    // are too many entries after them.
+    size_t keepFrom = current.replaced ? applied : (applied > maxUndo ? applied - maxUndo : 0);
+    for (; firstUndo < keepFrom; firstUndo++) {
+        dropOps(entries[firstUndo].ops, !current.replaced);
+    }
+}
+
+/**
+ * Checks if an entry is open, which is the case inside a transaction.
+ * @return - True while an entry is open.
+ */
+bool Journal::isRecording() const {
+    return depth > 0;
+}
+
+/**
+ * Notes that the open entry replaced the whole tree, so it and everything
+ * before it can no longer be undone.
+ */
+void Journal::recordReplace() {
+    // The cached bytes belong to the old document, whose nodes may be released.
+    if (cache != NULL) {
+        cache->clear();
+    }
+    if (depth > 0) {
+        current.replaced = true;
+        dropOps(current.ops, false);
+        discarded.clear();
+    }
+}
+
+/**
+ * Records a node which has just been added to the tree.
+ * @param node - The node added.
+ */
+void Journal::recordInsert(DOMNode* node) {
+    if (view != NULL) {
+        view->preserveChildren(node->getParentNode(), node);
+    }
+    invalidate(node->getParentNode());
+    if (depth == 0 || current.replaced) {
+        return;
+    }
+
+    JournalOp &op = addOp(OP_LINK, node);
+    op.parent = NULL;
+    op.next = NULL;
+    op.hasValue = false;
+}
+
+/**
+ * Records a node which is about to be taken out of the tree.
+ * @param node - The node to be removed.
+ */
+void Journal::recordRemove(DOMNode* node) {
+    if (view != NULL) {
+        view->preserveChildren(node->getParentNode());
+    }
+    invalidate(node->getParentNode());
+    if (depth == 0) {
+        return;
+    }
+    if (current.replaced) {
+        discarded.push_back(node);
+        return;
+    }
+
+    JournalOp &op = addOp(OP_LINK, node);
+    op.parent = node->getParentNode();
+    op.next = node->getNextSibling();
+    op.hasValue = false;
+}
+
+/**
+ * Records an element which has just been renamed.
+ * @param elem - The element, as returned by 'renameNode'.
+ * @param oldName - The name it had before.
+ */
+void Journal::recordRename(DOMNode* elem, const XMLCh* oldName) {
+    if (view != NULL) {
+        view->preserveName(elem, oldName);
+    }
+    invalidate(elem);
+    if (depth == 0 || current.replaced) {
+        return;
+    }
+
+    JournalOp &op = addOp(OP_RENAME, elem);
+    op.parent = NULL;
+    op.next = NULL;
+    copyInto(oldName, op.name);
+    op.hasValue = false;
+}
+
+/**
+ * Records an attribute which is about to be set or removed.
+ * @param elem - The element owning the attribute.
+ * @param name - The name of the attribute.
+ */
+void Journal::recordAttribute(DOMElement* elem, const XMLCh* name) {
+    if (view != NULL) {
+        view->preserveAttributes(elem);
+    }
+    invalidate(elem);
+    if (depth == 0 || current.replaced) {
+        return;
+    }
+
+    JournalOp &op = addOp(OP_ATTRIBUTE, elem);
+    op.parent = NULL;
+    op.next = NULL;
+    copyInto(name, op.name);
+
+    DOMAttr* attNode = elem->getAttributeNode(name);
+    op.hasValue = (attNode != NULL);
+    if (op.hasValue) {
+        copyInto(attNode->getValue(), op.value);
+    }
+}
+
+/**
+ * Adds an operation to the open entry, counting the reference it makes to its node.
+ * @param type - The kind of operation.
+ * @param node - The node the operation refers to.
+ * @return - The new operation, with its other fields still to be filled in.
+ */
+JournalOp& Journal::addOp(JournalOpType type, DOMNode* node) {
+    current.ops.push_back(JournalOp());
+    JournalOp &op = current.ops.back();
+    op.type = type;
+    op.node = node;
+    references[node]++;
+    return op;
+}
+
+/**
+ * Drops a list of operations, releasing each node which is out of the tree
+ * and no longer referred to by any operation.
+ * @param ops - The operations, which are emptied. Passed by reference.
+ * @param releaseNodes - Set if the nodes may be released, which is not the
+ *                       case once the document they belong to was replaced.
+ */
+void Journal::dropOps(vector<JournalOp> &ops, bool releaseNodes) {
+    for (vector<JournalOp>::iterator op = ops.begin(); op != ops.end(); ++op) {
+        unordered_map<DOMNode*, size_t>::iterator count = references.find(op->node);
+        if (count == references.end() || --count->second > 0) {
+            continue;
+        }
+        references.erase(count);
+
+        // A node inside a detached subtree is released along with the subtree.
+        if (releaseNodes && op->node->getParentNode() == NULL) {
+            release(op->node);
+        }
+    }
+    vector<JournalOp>().swap(ops);
+}
+
+/**
+ * Applies an operation, swapping what it stores with the current state of the tree.
+ * @param op - The operation. Passed by reference, since it is updated.
+ * @param index - The lookup index, kept up to date.
+ */
+void Journal::apply(JournalOp &op, NodeIndex &index) {
+    if (op.type == OP_LINK) {
+
+        // A detached node is put back where it was, otherwise it is taken out
+        // and its place is remembered.
+        if (op.node->getParentNode() == NULL) {
+            if (view != NULL) {
+                view->preserveChildren(op.parent);
+            }
+            invalidate(op.parent);
+            op.parent->insertBefore(op.node, op.next);
+            index.addSubtree(op.node);
+        } else {
+            op.parent = op.node->getParentNode();
+            op.next = op.node->getNextSibling();
+            if (view != NULL) {
+                view->preserveChildren(op.parent);
+            }
+            invalidate(op.parent);
+            index.removeSubtree(op.node);
+            op.parent->removeChild(op.node);
+        }
+
+    } else if (op.type == OP_RENAME) {
+        vector<XMLCh> currentName;
+        copyInto(op.node->getNodeName(), currentName);
+        if (view != NULL) {
+            view->preserveName(op.node, &currentName[0]);
+        }
+        invalidate(op.node);
+
+        index.removeElement(static_cast<DOMElement*> (op.node));
+        DOMNode* renamed = op.node->getOwnerDocument()->renameNode(op.node, 0, &op.name[0]);
+        index.addElement(static_cast<DOMElement*> (renamed));
+
+        // The reference moves with the element if it was replaced by a new node.
+        if (renamed != op.node) {
+            references[renamed]++;
+            if (--references[op.node] == 0) {
+                references.erase(op.node);
+            }
+            op.node = renamed;
+        }
+        op.name.swap(currentName);
+
+    } else {
+        DOMElement* elem = static_cast<DOMElement*> (op.node);
+        if (view != NULL) {
+            view->preserveAttributes(elem);
+        }
+        invalidate(elem);
+        DOMAttr* attNode = elem->getAttributeNode(&op.name[0]);
+
+        vector<XMLCh> currentValue;
+        if (attNode != NULL) {
+            copyInto(attNode->getValue(), currentValue);
+        }
+
+        if (op.hasValue) {
+            elem->setAttribute(&op.name[0], &op.value[0]);
+        } else if (attNode != NULL) {
+            elem->removeAttribute(&op.name[0]);
+        }
+        op.hasValue = (attNode != NULL);
+        op.value.swap(currentValue);
+    }
+}
+
+/**
+ * Drops the cached bytes of a node which is changing and of the elements above it.
+ * @param node - The node.
+ */
+void Journal::invalidate(const DOMNode* node) {
+    if (cache != NULL) {
+        cache->invalidate(node);
+    }
+}
+
+/**
+ * Releases a node taken out of the tree, unless the view still needs it.
+ * @param node - The node.
+ */
+void Journal::release(DOMNode* node) {
+    if (cache != NULL) {
+        cache->evict(node);
+    }
+    if (view == NULL || !view->releaseLater(node)) {
+        node->release();
+    }
+}
+
+/**
+ * Gets a one line description of an entry for the messages of 'undo' and 'redo'.
+ * @param entry - The entry.
+ * @return - The commands of the entry, separated by semicolons.
+ */
+string Journal::describe(const JournalEntry &entry) {
+    string description = entry.commands;
+    for (string::size_type pos = description.find('\n'); pos != string::npos; pos = description.find('\n', pos)) {
+        description.replace(pos, 1, "; ");
+    }
+    return description;
+}
+
+/**
+ * Undoes the last entry which has not been undone.
+ * @param index - The lookup index, kept up to date.
+ */
+void Journal::undo(NodeIndex &index) {
+    if (depth > 0) {
+        cout << "Commit the open transaction before using 'undo'." << endl;
+        return;
+    }
+    if (applied <= firstUndo) {
+        cout << "Nothing to undo." << endl;
+        return;
+    }
+
+    JournalEntry &entry = entries[--applied];
+
+    // The index is updated in one pass once every operation has been applied.
+    index.deferUpdates();
+    for (vector<JournalOp>::reverse_iterator op = entry.ops.rbegin(); op != entry.ops.rend(); ++op) {
+        apply(*op, index);
+    }
+    index.applyUpdates();
+    changes++;
+    change = CHANGE_UNDO;
+
+    cout << "Undid '" << describe(entry) << "'." << endl;
+}
+
+/**
+ * Redoes the last entry which was undone.
+ * @param index - The lookup index, kept up to date.
+ */
+void Journal::redo(NodeIndex &index) {
+    if (depth > 0) {
+        cout << "Commit the open transaction before using 'redo'." << endl;
+        return;
+    }
+    if (applied == entries.size()) {
+        cout << "Nothing to redo." << endl;
+        return;
+    }
+
+    JournalEntry &entry = entries[applied++];
+
+    index.deferUpdates();
+    for (vector<JournalOp>::iterator op = entry.ops.begin(); op != entry.ops.end(); ++op) {
+        apply(*op, index);
+    }
+    index.applyUpdates();
+    changes++;
+    change = CHANGE_REDO;
+
+    cout << "Redid '" << describe(entry) << "'." << endl;
+}
+
+/**
+ * Writes the commands of every entry which has not been undone, in the order
+ * they were typed.
+ * @param out - The stream to write to.
+ */
+void Journal::writeHistory(ostream &out) const {
+    for (size_t i = 0; i < applied; i++) {
+        out << entries[i].commands << endl;
+    }
+}
+
+/**
+ * Gets the number of changes made to the journal so far, counting each new
+ * entry, undo and redo, so a caller can tell if a command changed the tree.
+ * @return - The number of changes.
+ */
+size_t Journal::changeCount() const {
+    return changes;
+}
+
+/**
+ * Gets the kind of the last change made to the journal.
+ * @return - The kind of change.
+ */
+JournalChange Journal::lastChange() const {
+    return change;
+}
+
+/**
+ * Gets the position of the entry which was last added, undone or redone.
+ * @return - The position, counting from the oldest entry.
+ */
+size_t Journal::changedPosition() const {
+    return (change == CHANGE_UNDO) ? applied : applied - 1;
+}
+
+/**
+ * Gets the entry which was last added, undone or redone.
+ * @return - The entry.
+ */
+const JournalEntry& Journal::changedEntry() const {
+    return entries[changedPosition()];
+}
+
+/**
+ * Gets the number of entries which have not been undone.
+ * @return - The number of entries.
+ */
+size_t Journal::position() const {
+    return applied;
+}
+
+/**
+ * Gets the number of entries in the journal, including those which have been undone.
+ * @return - The number of entries.
+ */
+size_t Journal::entryCount() const {
+    return entries.size();
+}
@@ -0,0 +1,329 @@
+/* File:   Journal.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the Journal class, which records the changes made by
+ * the editing commands so that they can be undone and redone. Each command is
+ * one entry in the journal, and a bulk command or a transaction is still a single
+ * entry. An entry keeps the command as it was typed and a list of small operations,
+ * each of which can be applied to swap the tree between its state before and after
+ * the change:
+ *
+ *     Link      - A node which was added or removed. Removed subtrees are kept as
+ *                 they are, detached from the tree, rather than being copied.
+ *     Rename    - An element which was renamed, along with its other name.
+ *     Attribute - An attribute which was set or removed, along with its other value.
+ *
+ * Undoing an entry applies its operations from last to first and redoing it applies
+ * them from first to last, so each costs only as much as the command did. Commands
+ * which replace the whole tree, such as 'load', cannot be undone, and nothing
+ * before them can be either.
+ *
+ * A removed subtree belongs to the journal while an entry which can still be undone
+ * or redone refers to it. Once the last such entry is dropped, the subtree is
+ * released if it is still out of the tree, so its memory is reused by the document.
+ * Nodes removed by an entry which replaced the tree are released when it ends.
+ *
+ * While a background export reads the tree, every change the journal records or
+ * applies is first passed to the export's copy-on-write view, and nodes are only
+ * released once the view is closed. Every change also invalidates the cached bytes
+ * of the changed node and the elements above it.
+ *
+ * The typed commands of every entry which has not been undone make up the history
+ * of the session, which can be entered into the shell again to rebuild the tree.
+ */
+
+#ifndef JOURNAL_H
+#define	JOURNAL_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "NodeIndex.h"
+#include "CopyOnWriteView.h"
+#include "SubtreeCache.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+/**
+ * The kinds of operation recorded in the journal.
+ */
+enum JournalOpType {
+    OP_LINK, OP_RENAME, OP_ATTRIBUTE
+};
+
+/**
+ * Structure storing a single recorded operation. Applying it swaps what it
+ * stores with the current state of the tree, so the same operation both
+ * undoes and redoes the change.
+ */
+struct JournalOp {
+    /** The kind of operation. */
+    JournalOpType type;
+
+    /** The node added or removed, the element renamed, or the element owning the attribute. */
+    DOMNode* node;
+
+    /** The parent a removed node is put back into. */
+    DOMNode* parent;
+
+    /** The sibling a removed node is put back in front of, or NULL for the end. */
+    DOMNode* next;
+
+    /** The other name of a renamed element, or the name of the attribute. */
+    vector<XMLCh> name;
+
+    /** Set if the attribute has a value to put back, rather than being removed. */
+    bool hasValue;
+
+    /** The other value of the attribute. */
+    vector<XMLCh> value;
+};
+
+/**
+ * Structure storing a single entry of the journal.
+ */
+struct JournalEntry {
+    /** The commands as they were typed, one per line. */
+    string commands;
+
+    /** The operations, in the order they were made. */
+    vector<JournalOp> ops;
+
+    /** Set if the entry replaced the whole tree. */
+    bool replaced;
+};
+
+/**
+ * The kinds of change made to the journal, as reported by 'lastChange'.
+ */
+enum JournalChange {
+    CHANGE_NONE, CHANGE_ENTRY, CHANGE_UNDO, CHANGE_REDO
+};
+
+class Journal {
+public:
+
+    /**
+     * Custom constructor.
+     * @param nMaxUndo - The number of entries which can be undone. Older entries
+     *                   are kept in the history, but their operations are dropped.
+     */
+    Journal(size_t nMaxUndo = 1000);
+
+    /**
+     * Sets the view which is told about every change before it is made.
+     * @param nView - The view, or NULL for none.
+     */
+    void setView(CopyOnWriteView* nView);
+
+    /**
+     * Sets the cache of written bytes which is invalidated by every change.
+     * @param nCache - The cache, or NULL for none.
+     */
+    void setCache(SubtreeCache* nCache);
+
+    /**
+     * Starts an entry for a command. Calls may be nested, so the commands in a
+     * transaction join the entry which was started by 'begin'.
+     * @param input - The command as it was typed.
+     */
+    void beginEntry(const string &input);
+
+    /**
+     * Adds a line typed in answer to a prompt to the open entry, so that the
+     * history can be entered into the shell again.
+     * @param input - The line typed.
+     */
+    void addInput(const string &input);
+
+    /**
+     * Ends a call to 'beginEntry'. An entry which did not change the tree is dropped.
+     */
+    void endEntry();
+
+    /**
+     * Checks if an entry is open, which is the case inside a transaction.
+     * @return - True while an entry is open.
+     */
+    bool isRecording() const;
+
+    /**
+     * Notes that the open entry replaced the whole tree, so it and everything
+     * before it can no longer be undone.
+     */
+    void recordReplace();
+
+    /**
+     * Records a node which has just been added to the tree.
+     * @param node - The node added.
+     */
+    void recordInsert(DOMNode* node);
+
+    /**
+     * Records a node which is about to be taken out of the tree.
+     * @param node - The node to be removed.
+     */
+    void recordRemove(DOMNode* node);
+
+    /**
+     * Records an element which has just been renamed.
+     * @param elem - The element, as returned by 'renameNode'.
+     * @param oldName - The name it had before.
+     */
+    void recordRename(DOMNode* elem, const XMLCh* oldName);
+
+    /**
+     * Records an attribute which is about to be set or removed.
+     * @param elem - The element owning the attribute.
+     * @param name - The name of the attribute.
+     */
+    void recordAttribute(DOMElement* elem, const XMLCh* name);
+
+    /**
+     * Undoes the last entry which has not been undone.
+     * @param index - The lookup index, kept up to date.
+     */
+    void undo(NodeIndex &index);
+
+    /**
+     * Redoes the last entry which was undone.
+     * @param index - The lookup index, kept up to date.
+     */
+    void redo(NodeIndex &index);
+
+    /**
+     * Writes the commands of every entry which has not been undone, in the order
+     * they were typed.
+     * @param out - The stream to write to.
+     */
+    void writeHistory(ostream &out) const;
+
+    /**
+     * Gets the number of changes made to the journal so far, counting each new
+     * entry, undo and redo, so a caller can tell if a command changed the tree.
+     * @return - The number of changes.
+     */
+    size_t changeCount() const;
+
+    /**
+     * Gets the kind of the last change made to the journal.
+     * @return - The kind of change.
+     */
+    JournalChange lastChange() const;
+
+    /**
+     * Gets the position of the entry which was last added, undone or redone.
+     * @return - The position, counting from the oldest entry.
+     */
+    size_t changedPosition() const;
+
+    /**
+     * Gets the entry which was last added, undone or redone.
+     * @return - The entry.
+     */
+    const JournalEntry& changedEntry() const;
+
+    /**
+     * Gets the number of entries which have not been undone.
+     * @return - The number of entries.
+     */
+    size_t position() const;
+
+    /**
+     * Gets the number of entries in the journal, including those which have been undone.
+     * @return - The number of entries.
+     */
+    size_t entryCount() const;
+
+private:
+
+    /**
+     * Adds an operation to the open entry, counting the reference it makes to its node.
+     * @param type - The kind of operation.
+     * @param node - The node the operation refers to.
+     * @return - The new operation, with its other fields still to be filled in.
+     */
+    JournalOp& addOp(JournalOpType type, DOMNode* node);
+
+    /**
+     * Drops a list of operations, releasing each node which is out of the tree
+     * and no longer referred to by any operation.
+     * @param ops - The operations, which are emptied. Passed by reference.
+     * @param releaseNodes - Set if the nodes may be released, which is not the
+     *                       case once the document they belong to was replaced.
+     */
+    void dropOps(vector<JournalOp> &ops, bool releaseNodes);
+
+    /**
+     * Applies an operation, swapping what it stores with the current state of the tree.
+     * @param op - The operation. Passed by reference, since it is updated.
+     * @param index - The lookup index, kept up to date.
+     */
+    void apply(JournalOp &op, NodeIndex &index);
+
+    /**
+     * Drops the cached bytes of a node which is changing and of the elements above it.
+     * @param node - The node.
+     */
+    void invalidate(const DOMNode* node);
+
+    /**
+     * Releases a node taken out of the tree, unless the view still needs it.
+     * @param node - The node.
+     */
+    void release(DOMNode* node);
+
+    /**
+     * Gets a one line description of an entry for the messages of 'undo' and 'redo'.
+     * @param entry - The entry.
+     * @return - The commands of the entry, separated by semicolons.
+     */
+    static string describe(const JournalEntry &entry);
+
+    /** The entries, oldest first. Those from 'applied' onwards have been undone. */
+    vector<JournalEntry> entries;
+
+    /** The number of entries which have not been undone. */
+    size_t applied;
+
+    /** The first entry which can still be undone. */
+    size_t firstUndo;
+
+    /** The number of entries which can be undone. */
+    size_t maxUndo;
+
+    /** The entry being recorded. */
+    JournalEntry current;
+
+    /** The number of calls to 'beginEntry' not yet matched by 'endEntry'. */
+    int depth;
+
+    /** The number of changes made to the journal so far. */
+    size_t changes;
+
+    /** The kind of the last change made to the journal. */
+    JournalChange change;
+
+    /** The number of operations referring to each node. */
+    unordered_map<DOMNode*, size_t> references;
+
+    /** Nodes removed by the open entry after it replaced the tree, released when it ends. */
+    vector<DOMNode*> discarded;
+
+    /** The view told about every change, or NULL. */
+    CopyOnWriteView* view;
+
+    /** The cache of written bytes invalidated by every change, or NULL. */
+    SubtreeCache* cache;
+};
+
+#endif	/* JOURNAL_H */
+
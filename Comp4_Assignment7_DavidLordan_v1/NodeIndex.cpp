@@ -0,0 +1,699 @@
+/* File:   NodeIndex.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the NodeIndex class, which is used by the editing
+ * commands to find elements by name. The commands always act on the first element
+ * in the document with the given name, which 'getElementsByTagName' finds by
+ * walking the tree from the root every time. The index instead keeps a list of
+ * the elements with each name, sorted in document order, so the first one can
+ * be found straight away. It is built once when a tree is loaded and then kept
+ * up to date by the editing commands as elements are added, renamed and removed.
+ *
+ * Commands may also give a path in place of a name. Paths are compiled once and
+ * kept in a QueryCache. Each step of a path is matched using the list of children
+ * with each name, which is built for an element the first time a path goes
+ * through it. A '//' step below an element takes the run of the list for its name
+ * between the element and the end of its subtree, found by binary search. So the
+ * cost of a path depends on its depth and the elements it matches, and not on
+ * the size of the tree.
+ *
+ * While updates are deferred, for a bulk edit or a transaction, added and removed
+ * elements are only noted. They are merged into the sorted list for their name in
+ * a single pass when that name is next looked up, or when the updates are applied.
+ * If a large share of the tree was added, the index is simply built again instead,
+ * since sorting the new elements into document order would take longer.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include "NodeIndex.h"
+
+/**
+ * Standard constructor. The index starts empty.
+ */
+NodeIndex::NodeIndex() {
+    document = NULL;
+    count = 0;
+    deferDepth = 0;
+    pendingAdds = 0;
+}
+
+/**
+ * Converts an element name to the UTF-8 string used as its key in the index.
+ * The same string is reused for every name to avoid allocating memory.
+ * @param name - The element name.
+ * @return - The key, valid until the next call.
+ */
+const string& NodeIndex::keyOf(const XMLCh* name) {
+    nameKey.clear();
+
+    for (const XMLCh* p = name; *p != 0; p++) {
+        unsigned int ch = *p;
+
+        // Combines a surrogate pair into a single character.
+        if (ch >= 0xD800 && ch <= 0xDBFF && p[1] >= 0xDC00 && p[1] <= 0xDFFF) {
+            ch = 0x10000 + ((ch - 0xD800) << 10) + (p[1] - 0xDC00);
+            p++;
+        }
+
+        if (ch < 0x80) {
+            nameKey += (char) ch;
+        } else if (ch < 0x800) {
+            nameKey += (char) (0xC0 | (ch >> 6));
+            nameKey += (char) (0x80 | (ch & 0x3F));
+        } else if (ch < 0x10000) {
+            nameKey += (char) (0xE0 | (ch >> 12));
+            nameKey += (char) (0x80 | ((ch >> 6) & 0x3F));
+            nameKey += (char) (0x80 | (ch & 0x3F));
+        } else {
+            nameKey += (char) (0xF0 | (ch >> 18));
+            nameKey += (char) (0x80 | ((ch >> 12) & 0x3F));
+            nameKey += (char) (0x80 | ((ch >> 6) & 0x3F));
+            nameKey += (char) (0x80 | (ch & 0x3F));
+        }
+    }
+    return nameKey;
+}
+
+/**
+ * Checks if one element comes before another in the document.
+ * @param first - The element expected to come first.
+ * @param second - The element expected to come second.
+ * @return - True if 'first' comes before 'second'.
+ */
+bool NodeIndex::precedes(const DOMElement* first, const DOMElement* second) {
+    return (first->compareDocumentPosition(second) & DOMNode::DOCUMENT_POSITION_FOLLOWING) != 0;
+}
+
+/**
+ * Checks if an element is below a node in the tree.
+ * @param elem - The element.
+ * @param ancestor - The node it may be below.
+ * @return - True if 'elem' is a descendant of 'ancestor'.
+ */
+bool NodeIndex::isBelow(const DOMElement* elem, const DOMNode* ancestor) {
+    return (ancestor->compareDocumentPosition(elem) & DOMNode::DOCUMENT_POSITION_CONTAINED_BY) != 0;
+}
+
+/**
+ * Empties the index and adds every element of the passed document to it.
+ * @param doc - The document to be indexed.
+ */
+void NodeIndex::build(DOMDocument* doc) {
+    clear();
+    document = doc;
+
+    DOMNode* root = doc->getDocumentElement();
+    DOMNode* node = root;
+
+    // Walks the tree in document order, so each element is simply added to the
+    // end of the list for its name.
+    while (node != NULL) {
+        if (node->getNodeType() == DOMNode::ELEMENT_NODE) {
+            DOMElement* elem = static_cast<DOMElement*> (node);
+            elements[keyOf(elem->getTagName())].push_back(elem);
+            count++;
+
+            if (node->getFirstChild() != NULL) {
+                node = node->getFirstChild();
+                continue;
+            }
+        }
+
+        // Moves on to the next sibling, going back up the tree when there is none.
+        while (node != root && node->getNextSibling() == NULL) {
+            node = node->getParentNode();
+        }
+        node = (node == root) ? NULL : node->getNextSibling();
+    }
+}
+
+/**
+ * Empties the index. The document stays the same, since this is used when
+ * its root is removed.
+ */
+void NodeIndex::clear() {
+    elements.clear();
+    childIndex.clear();
+    pending.clear();
+    pendingAdds = 0;
+    count = 0;
+}
+
+/**
+ * Finds the first element in the document with the passed name, or the
+ * first element matching the passed path.
+ * @param nameOrPath - The name of the element, or a path to it.
+ * @return - The element, or NULL if there is no matching element.
+ */
+DOMElement* NodeIndex::find(const string &nameOrPath) {
+    rebuildIfLarge();
+
+    if (PathQuery::isPath(nameOrPath)) {
+        const PathQuery* query = queries.get(nameOrPath);
+        return (query == NULL || document == NULL) ? NULL : evaluate(*query, NULL);
+    }
+
+    vector<DOMElement*>* list = listFor(nameOrPath);
+
+    if (list == NULL || list->empty()) {
+        return NULL;
+    }
+    return list->front();
+}
+
+/**
+ * Finds every element in the document with the passed name, or every
+ * element matching the passed path.
+ * @param nameOrPath - The name of the elements, or a path to them.
+ * @param matches - The elements found, in document order. Passed by reference.
+ */
+void NodeIndex::findAll(const string &nameOrPath, vector<DOMElement*> &matches) {
+    matches.clear();
+    rebuildIfLarge();
+
+    if (PathQuery::isPath(nameOrPath)) {
+        const PathQuery* query = queries.get(nameOrPath);
+        if (query != NULL && document != NULL) {
+            evaluate(*query, &matches);
+        }
+        return;
+    }
+
+    vector<DOMElement*>* list = listFor(nameOrPath);
+    if (list != NULL) {
+        matches = *list;
+    }
+}
+
+/**
+ * Finds the first element with the passed name below another node, the same
+ * as calling 'getElementsByTagName' on that node.
+ * @param name - The name of the element.
+ * @param ancestor - The node the element must be below.
+ * @return - The element, or NULL if there is no matching element.
+ */
+DOMElement* NodeIndex::findBelow(const string &name, const DOMNode* ancestor) {
+    rebuildIfLarge();
+    vector<DOMElement*>* list = listFor(name);
+
+    if (list == NULL) {
+        return NULL;
+    }
+
+    // The list is in document order, and the elements below the ancestor come
+    // straight after it, so only the first element after the ancestor can be the answer.
+    vector<DOMElement*>::iterator elem = list->begin();
+    const DOMElement* ancestorElem = dynamic_cast<const DOMElement*> (ancestor);
+    if (ancestorElem != NULL) {
+        elem = upper_bound(list->begin(), list->end(), ancestorElem, precedes);
+    }
+    if (elem == list->end()) {
+        return NULL;
+    }
+
+    for (DOMNode* parent = (*elem)->getParentNode(); parent != NULL; parent = parent->getParentNode()) {
+        if (parent == ancestor) {
+            return *elem;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Adds an element to the index. Must be called once the element is in the tree.
+ * @param elem - The element to be added.
+ */
+void NodeIndex::addElement(DOMElement* elem) {
+    count++;
+
+    // The lists of children of the parent are built again when next needed.
+    childIndex.erase(elem->getParentNode());
+
+    // While updates are deferred the element is only noted. If it was removed
+    // under the same name earlier, it is still in the list and nothing changes.
+    if (deferDepth > 0) {
+        PendingChanges &changes = pending[keyOf(elem->getTagName())];
+        if (changes.removed.erase(elem) == 0) {
+            changes.added.insert(elem);
+            pendingAdds++;
+        }
+        return;
+    }
+
+    vector<DOMElement*> &list = elements[keyOf(elem->getTagName())];
+
+    // New elements are usually added at the end of the tree, so the last
+    // position is checked before searching the list.
+    if (list.empty() || precedes(list.back(), elem)) {
+        list.push_back(elem);
+    } else {
+        list.insert(lower_bound(list.begin(), list.end(), elem, precedes), elem);
+    }
+}
+
+/**
+ * Removes an element from the index. Must be called before the element is
+ * renamed or taken out of the tree.
+ * @param elem - The element to be removed.
+ */
+void NodeIndex::removeElement(DOMElement* elem) {
+    childIndex.erase(elem);
+    childIndex.erase(elem->getParentNode());
+
+    // While updates are deferred the element is only noted, unless it was
+    // added during the same deferral in which case it is simply forgotten.
+    if (deferDepth > 0) {
+        PendingChanges &changes = pending[keyOf(elem->getTagName())];
+        if (changes.added.erase(elem) == 0) {
+            changes.removed.insert(elem);
+        } else {
+            pendingAdds--;
+        }
+        count--;
+        return;
+    }
+
+    unordered_map<string, vector<DOMElement*> >::iterator it = elements.find(keyOf(elem->getTagName()));
+
+    if (it == elements.end()) {
+        return;
+    }
+
+    vector<DOMElement*> &list = it->second;
+    vector<DOMElement*>::iterator pos = lower_bound(list.begin(), list.end(), elem, precedes);
+
+    if (pos != list.end() && *pos == elem) {
+        list.erase(pos);
+        count--;
+    }
+}
+
+/**
+ * Adds an element and every element below it to the index. Must be called
+ * once the element is back in the tree.
+ * @param node - The root of the subtree to be added.
+ */
+void NodeIndex::addSubtree(DOMNode* node) {
+    if (node->getNodeType() != DOMNode::ELEMENT_NODE) {
+        return;
+    }
+    addElement(static_cast<DOMElement*> (node));
+
+    for (DOMNode* child = node->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        addSubtree(child);
+    }
+}
+
+/**
+ * Removes an element and every element below it from the index. Must be
+ * called before the element is taken out of the tree.
+ * @param node - The root of the subtree to be removed.
+ */
+void NodeIndex::removeSubtree(DOMNode* node) {
+    removeDescendants(node);
+
+    if (node->getNodeType() == DOMNode::ELEMENT_NODE) {
+        removeElement(static_cast<DOMElement*> (node));
+    }
+}
+
+/**
+ * Removes every element below a node from the index, but not the node itself.
+ * Used before the contents of an element are replaced.
+ * @param node - The node whose descendants are removed.
+ */
+void NodeIndex::removeDescendants(DOMNode* node) {
+    for (DOMNode* child = node->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        if (child->getNodeType() == DOMNode::ELEMENT_NODE) {
+            removeSubtree(child);
+        }
+    }
+}
+
+/**
+ * Gets the children of a node with the passed name, building the lists of
+ * its children if this is the first time they are needed.
+ * @param parent - The element or document whose children are wanted.
+ * @param name - The name of the children, or '*' for every child element.
+ * @return - The children, in document order.
+ */
+const vector<DOMElement*>& NodeIndex::children(const DOMNode* parent, const string &name) {
+    unordered_map<const DOMNode*, unordered_map<string, vector<DOMElement*> > >::iterator it
+            = childIndex.find(parent);
+
+    if (it == childIndex.end()) {
+        it = childIndex.insert(make_pair(parent, unordered_map<string, vector<DOMElement*> >())).first;
+
+        vector<DOMElement*> &all = it->second["*"];
+        for (DOMNode* child = parent->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+            if (child->getNodeType() == DOMNode::ELEMENT_NODE) {
+                DOMElement* elem = static_cast<DOMElement*> (child);
+                it->second[keyOf(elem->getTagName())].push_back(elem);
+                all.push_back(elem);
+            }
+        }
+    }
+
+    unordered_map<string, vector<DOMElement*> >::iterator list = it->second.find(name);
+    return (list == it->second.end()) ? emptyList : list->second;
+}
+
+/**
+ * Gets the elements matched by a step of a path before its predicates are applied.
+ * @param step - The step of the path.
+ * @param context - The node the step starts from.
+ * @param scratch - Used to hold the matches when they are not already stored.
+ * @return - The matches, in document order.
+ */
+const vector<DOMElement*>& NodeIndex::candidates(const PathStep &step, const DOMNode* context,
+        vector<DOMElement*> &scratch) {
+
+    if (!step.descendant) {
+        return children(context, step.name);
+    }
+
+    // Every element with the name is below the document, so the stored list is the answer.
+    if (context == document && step.name != "*") {
+        vector<DOMElement*>* list = listFor(step.name);
+        return (list == NULL) ? emptyList : *list;
+    }
+
+    scratch.clear();
+    if (step.name != "*") {
+        vector<DOMElement*>* list = listFor(step.name);
+        if (list != NULL) {
+
+            // The elements below the context come straight after it in document
+            // order, so they are a single run of the list found by two searches.
+            vector<DOMElement*>::iterator first = list->begin();
+            const DOMElement* contextElem = dynamic_cast<const DOMElement*> (context);
+            if (contextElem != NULL) {
+                first = upper_bound(list->begin(), list->end(), contextElem, precedes);
+            }
+            vector<DOMElement*>::iterator last = lower_bound(first, list->end(), context, isBelow);
+            scratch.assign(first, last);
+        }
+        return scratch;
+    }
+
+    // Any element below the context, found by walking its subtree in document order.
+    const DOMNode* node = context->getFirstChild();
+    while (node != NULL) {
+        if (node->getNodeType() == DOMNode::ELEMENT_NODE) {
+            scratch.push_back(static_cast<DOMElement*> (const_cast<DOMNode*> (node)));
+            if (node->getFirstChild() != NULL) {
+                node = node->getFirstChild();
+                continue;
+            }
+        }
+        while (node != context && node->getNextSibling() == NULL) {
+            node = node->getParentNode();
+        }
+        node = (node == context) ? NULL : node->getNextSibling();
+    }
+    return scratch;
+}
+
+/**
+ * Finds the first element, or every element, matching a compiled path.
+ * @param query - The compiled path.
+ * @param all - If not NULL, every matching element is stored here in document order.
+ * @return - The first matching element, or NULL if there is none.
+ */
+DOMElement* NodeIndex::evaluate(const PathQuery &query, vector<DOMElement*>* all) {
+    if (query.filters.empty()) {
+        return evaluateSteps(query, all);
+    }
+
+    // The predicates after round brackets count every match of the path in
+    // document order, so every match has to be found first.
+    vector<DOMElement*> matches;
+    if (evaluateSteps(query, &matches) == NULL) {
+        return NULL;
+    }
+    filterMatches(matches, query.filters.begin(), query.filters.end());
+    if (matches.empty()) {
+        return NULL;
+    }
+
+    if (all != NULL) {
+        all->insert(all->end(), matches.begin(), matches.end());
+    }
+    return matches.front();
+}
+
+/**
+ * Applies predicates in order to a list of matches, keeping the matches
+ * which pass every predicate. A position counts the matches left by the
+ * predicates before it.
+ * @param matches - The matches, in document order. Passed by reference.
+ * @param first - The first predicate to apply.
+ * @param last - The predicate after the last one to apply.
+ */
+void NodeIndex::filterMatches(vector<DOMElement*> &matches, vector<PathPredicate>::const_iterator first,
+        vector<PathPredicate>::const_iterator last) {
+
+    for (vector<PathPredicate>::const_iterator predicate = first; predicate != last && !matches.empty(); ++predicate) {
+        if (predicate->position != 0) {
+            DOMElement* match = (predicate->position <= matches.size())
+                    ? matches[predicate->position - 1] : NULL;
+            matches.clear();
+            if (match != NULL) {
+                matches.push_back(match);
+            }
+            continue;
+        }
+
+        // Keeps only the matches with the attribute, and the value if one was given.
+        vector<DOMElement*>::iterator kept = matches.begin();
+        for (vector<DOMElement*>::iterator match = matches.begin(); match != matches.end(); ++match) {
+            DOMAttr* att = (*match)->getAttributeNode(&predicate->attName[0]);
+            if (att != NULL && (!predicate->hasValue
+                    || XMLString::equals(att->getValue(), &predicate->attValue[0]))) {
+                *kept++ = *match;
+            }
+        }
+        matches.erase(kept, matches.end());
+    }
+}
+
+/**
+ * Finds the first element, or every element, matching the steps of a compiled
+ * path, leaving out the predicates after a path in round brackets.
+ * @param query - The compiled path.
+ * @param all - If not NULL, every matching element is stored here in document order.
+ * @return - The first matching element, or NULL if there is none.
+ */
+DOMElement* NodeIndex::evaluateSteps(const PathQuery &query, vector<DOMElement*>* all) {
+    vector<const DOMNode*> contexts(1, document);
+    vector<const DOMNode*> next;
+    vector<DOMElement*> scratch;
+    vector<DOMElement*> matches;
+    vector<DOMElement*> siblings;
+    unordered_set<const DOMNode*> parents;
+
+    // Set if the matches are already in document order, which is the case when
+    // the last step starts from a single context.
+    bool ordered = false;
+
+    for (vector<PathStep>::const_iterator step = query.steps.begin(); step != query.steps.end(); ++step) {
+        ordered = (contexts.size() == 1);
+
+        // Only the first match of the last step is needed from each context,
+        // unless every match was asked for.
+        bool last = (step + 1 == query.steps.end()) && all == NULL;
+        next.clear();
+
+        bool hasPosition = false;
+        for (vector<PathPredicate>::const_iterator predicate = step->predicates.begin();
+                predicate != step->predicates.end(); ++predicate) {
+            hasPosition = hasPosition || predicate->position != 0;
+        }
+
+        for (vector<const DOMNode*>::iterator context = contexts.begin(); context != contexts.end(); ++context) {
+            const vector<DOMElement*> &found = candidates(*step, *context, scratch);
+            vector<PathPredicate>::const_iterator predicate = step->predicates.begin();
+
+            if (step->descendant && hasPosition) {
+
+                // As in XPath, a position counts among the children of the same
+                // parent, so the predicates are applied to the matching children
+                // of each parent of a match in turn.
+                matches.clear();
+                parents.clear();
+                for (vector<DOMElement*>::const_iterator elem = found.begin(); elem != found.end(); ++elem) {
+                    const DOMNode* parent = (*elem)->getParentNode();
+                    if (parents.insert(parent).second) {
+                        siblings = children(parent, step->name);
+                        filterMatches(siblings, step->predicates.begin(), step->predicates.end());
+                        matches.insert(matches.end(), siblings.begin(), siblings.end());
+                    }
+                }
+
+                // The children of a parent may come after those of a parent nested inside it.
+                if (parents.size() > 1) {
+                    sort(matches.begin(), matches.end(), precedes);
+                }
+                predicate = step->predicates.end();
+            } else if (predicate != step->predicates.end() && predicate->position != 0) {
+
+                // A leading position picks its match straight from the list, which
+                // avoids copying the list when it is long.
+                matches.clear();
+                if (predicate->position <= found.size()) {
+                    matches.push_back(found[predicate->position - 1]);
+                }
+                ++predicate;
+            } else if (predicate == step->predicates.end() && last) {
+                matches.clear();
+                if (!found.empty()) {
+                    matches.push_back(found.front());
+                }
+            } else {
+                matches = found;
+            }
+            filterMatches(matches, predicate, step->predicates.end());
+
+            if (last && matches.size() > 1) {
+                matches.resize(1);
+            }
+            next.insert(next.end(), matches.begin(), matches.end());
+        }
+
+        contexts.swap(next);
+        if (contexts.empty()) {
+            return NULL;
+        }
+    }
+
+    // The matches from different contexts may not be in document order, and
+    // when contexts are nested the same element may be matched more than once.
+    if (all != NULL) {
+        for (vector<const DOMNode*>::iterator match = contexts.begin(); match != contexts.end(); ++match) {
+            all->push_back(static_cast<DOMElement*> (const_cast<DOMNode*> (*match)));
+        }
+        if (!ordered) {
+            sort(all->begin(), all->end(), precedes);
+            all->erase(unique(all->begin(), all->end()), all->end());
+        }
+        return all->front();
+    }
+
+    DOMElement* first = static_cast<DOMElement*> (const_cast<DOMNode*> (contexts.front()));
+    for (vector<const DOMNode*>::iterator match = contexts.begin() + 1; match != contexts.end(); ++match) {
+        DOMElement* elem = static_cast<DOMElement*> (const_cast<DOMNode*> (*match));
+        if (precedes(elem, first)) {
+            first = elem;
+        }
+    }
+    return first;
+}
+
+/**
+ * Applies deferred updates to the list of elements with one name.
+ * @param list - The list to update, in document order.
+ * @param changes - The elements added to and removed from the list.
+ */
+void NodeIndex::applyChanges(vector<DOMElement*> &list, const PendingChanges &changes) {
+
+    // The removed elements are no longer in the tree, so they cannot be found
+    // by their position. A few are searched for, otherwise the whole list is
+    // checked against them in one pass.
+    if (!changes.removed.empty() && changes.removed.size() <= 16) {
+        for (unordered_set<DOMElement*>::const_iterator elem = changes.removed.begin();
+                elem != changes.removed.end(); ++elem) {
+            vector<DOMElement*>::iterator pos = std::find(list.begin(), list.end(), *elem);
+            if (pos != list.end()) {
+                list.erase(pos);
+            }
+        }
+    } else if (!changes.removed.empty()) {
+        vector<DOMElement*>::iterator kept = list.begin();
+        for (vector<DOMElement*>::iterator elem = list.begin(); elem != list.end(); ++elem) {
+            if (changes.removed.count(*elem) == 0) {
+                *kept++ = *elem;
+            }
+        }
+        list.erase(kept, list.end());
+    }
+
+    // The added elements are sorted on their own and then merged into the list,
+    // rather than each being inserted into the list separately.
+    if (!changes.added.empty()) {
+        vector<DOMElement*> added(changes.added.begin(), changes.added.end());
+        sort(added.begin(), added.end(), precedes);
+
+        vector<DOMElement*> merged;
+        merged.reserve(list.size() + added.size());
+        merge(list.begin(), list.end(), added.begin(), added.end(), back_inserter(merged), precedes);
+        list.swap(merged);
+    }
+}
+
+/**
+ * Gets the list of elements with the passed name, first applying any
+ * deferred updates to it.
+ * @param name - The name of the elements.
+ * @return - The list, or NULL if there are no elements with that name.
+ */
+vector<DOMElement*>* NodeIndex::listFor(const string &name) {
+    unordered_map<string, PendingChanges>::iterator changes = pending.find(name);
+
+    if (changes != pending.end()) {
+        pendingAdds -= changes->second.added.size();
+        applyChanges(elements[name], changes->second);
+        pending.erase(changes);
+    }
+
+    unordered_map<string, vector<DOMElement*> >::iterator it = elements.find(name);
+    return (it == elements.end()) ? NULL : &it->second;
+}
+
+/**
+ * Starts deferring updates. Calls may be nested, the updates are applied
+ * once every call has been matched by a call to 'applyUpdates'.
+ */
+void NodeIndex::deferUpdates() {
+    deferDepth++;
+}
+
+/**
+ * Ends a call to 'deferUpdates', applying the deferred updates if it was
+ * the outermost call.
+ */
+void NodeIndex::applyUpdates() {
+    if (deferDepth == 0 || --deferDepth > 0) {
+        return;
+    }
+
+    rebuildIfLarge();
+    for (unordered_map<string, PendingChanges>::iterator changes = pending.begin();
+            changes != pending.end(); ++changes) {
+        applyChanges(elements[changes->first], changes->second);
+    }
+    pending.clear();
+    pendingAdds = 0;
+}
+
+/**
+ * Checks if so many elements were added while updates were deferred that
+ * building the index again is quicker than sorting them in. If so, the
+ * index is built again, which also applies every other deferred update.
+ */
+void NodeIndex::rebuildIfLarge() {
+    if (pendingAdds > 64 && pendingAdds > count / 64 && document != NULL) {
+        build(document);
+    }
+}
+
+/**
+ * Gets the number of elements in the index.
+ * @return - The number of elements.
+ */
+size_t NodeIndex::size() const {
+    return count;
+}
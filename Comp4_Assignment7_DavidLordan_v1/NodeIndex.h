@@ -0,0 +1,281 @@
+/* File:   NodeIndex.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the NodeIndex class, which is used by the editing
+ * commands to find elements by name. The commands always act on the first element
+ * in the document with the given name, which 'getElementsByTagName' finds by
+ * walking the tree from the root every time. The index instead keeps a list of
+ * the elements with each name, sorted in document order, so the first one can
+ * be found straight away. It is built once when a tree is loaded and then kept
+ * up to date by the editing commands as elements are added, renamed and removed.
+ *
+ * Commands may also give a path in place of a name. Paths are compiled once and
+ * kept in a QueryCache. Each step of a path is matched using the list of children
+ * with each name, which is built for an element the first time a path goes
+ * through it. A '//' step below an element takes the run of the list for its name
+ * between the element and the end of its subtree, found by binary search. So the
+ * cost of a path depends on its depth and the elements it matches, and not on
+ * the size of the tree.
+ *
+ * While updates are deferred, for a bulk edit or a transaction, added and removed
+ * elements are only noted. They are merged into the sorted list for their name in
+ * a single pass when that name is next looked up, or when the updates are applied.
+ * If a large share of the tree was added, the index is simply built again instead,
+ * since sorting the new elements into document order would take longer.
+ */
+
+#ifndef NODEINDEX_H
+#define	NODEINDEX_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "PathQuery.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+/**
+ * Structure storing the changes to the list of elements with one name which
+ * have not been applied yet, while updates are deferred.
+ */
+struct PendingChanges {
+    /** Elements added since the list was last updated. */
+    unordered_set<DOMElement*> added;
+
+    /** Elements removed since the list was last updated. */
+    unordered_set<DOMElement*> removed;
+};
+
+class NodeIndex {
+public:
+
+    /**
+     * Standard constructor. The index starts empty.
+     */
+    NodeIndex();
+
+    /**
+     * Empties the index and adds every element of the passed document to it.
+     * @param doc - The document to be indexed.
+     */
+    void build(DOMDocument* doc);
+
+    /**
+     * Empties the index. The document stays the same, since this is used when
+     * its root is removed.
+     */
+    void clear();
+
+    /**
+     * Finds the first element in the document with the passed name, or the
+     * first element matching the passed path.
+     * @param nameOrPath - The name of the element, or a path to it.
+     * @return - The element, or NULL if there is no matching element.
+     */
+    DOMElement* find(const string &nameOrPath);
+
+    /**
+     * Finds every element in the document with the passed name, or every
+     * element matching the passed path.
+     * @param nameOrPath - The name of the elements, or a path to them.
+     * @param matches - The elements found, in document order. Passed by reference.
+     */
+    void findAll(const string &nameOrPath, vector<DOMElement*> &matches);
+
+    /**
+     * Finds the first element with the passed name below another node, the same
+     * as calling 'getElementsByTagName' on that node.
+     * @param name - The name of the element.
+     * @param ancestor - The node the element must be below.
+     * @return - The element, or NULL if there is no matching element.
+     */
+    DOMElement* findBelow(const string &name, const DOMNode* ancestor);
+
+    /**
+     * Adds an element to the index. Must be called once the element is in the tree.
+     * @param elem - The element to be added.
+     */
+    void addElement(DOMElement* elem);
+
+    /**
+     * Removes an element from the index. Must be called before the element is
+     * renamed or taken out of the tree.
+     * @param elem - The element to be removed.
+     */
+    void removeElement(DOMElement* elem);
+
+    /**
+     * Adds an element and every element below it to the index. Must be called
+     * once the element is back in the tree.
+     * @param node - The root of the subtree to be added.
+     */
+    void addSubtree(DOMNode* node);
+
+    /**
+     * Removes an element and every element below it from the index. Must be
+     * called before the element is taken out of the tree.
+     * @param node - The root of the subtree to be removed.
+     */
+    void removeSubtree(DOMNode* node);
+
+    /**
+     * Removes every element below a node from the index, but not the node itself.
+     * Used before the contents of an element are replaced.
+     * @param node - The node whose descendants are removed.
+     */
+    void removeDescendants(DOMNode* node);
+
+    /**
+     * Starts deferring updates. Calls may be nested, the updates are applied
+     * once every call has been matched by a call to 'applyUpdates'.
+     */
+    void deferUpdates();
+
+    /**
+     * Ends a call to 'deferUpdates', applying the deferred updates if it was
+     * the outermost call.
+     */
+    void applyUpdates();
+
+    /**
+     * Gets the number of elements in the index.
+     * @return - The number of elements.
+     */
+    size_t size() const;
+
+private:
+
+    /**
+     * Converts an element name to the UTF-8 string used as its key in the index.
+     * The same string is reused for every name to avoid allocating memory.
+     * @param name - The element name.
+     * @return - The key, valid until the next call.
+     */
+    const string& keyOf(const XMLCh* name);
+
+    /**
+     * Checks if one element comes before another in the document.
+     * @param first - The element expected to come first.
+     * @param second - The element expected to come second.
+     * @return - True if 'first' comes before 'second'.
+     */
+    static bool precedes(const DOMElement* first, const DOMElement* second);
+
+    /**
+     * Checks if an element is below a node in the tree.
+     * @param elem - The element.
+     * @param ancestor - The node it may be below.
+     * @return - True if 'elem' is a descendant of 'ancestor'.
+     */
+    static bool isBelow(const DOMElement* elem, const DOMNode* ancestor);
+
+    /**
+     * Finds the first element, or every element, matching a compiled path.
+     * @param query - The compiled path.
+     * @param all - If not NULL, every matching element is stored here in document order.
+     * @return - The first matching element, or NULL if there is none.
+     */
+    DOMElement* evaluate(const PathQuery &query, vector<DOMElement*>* all);
+
+    /**
+     * Finds the first element, or every element, matching the steps of a compiled
+     * path, leaving out the predicates after a path in round brackets.
+     * @param query - The compiled path.
+     * @param all - If not NULL, every matching element is stored here in document order.
+     * @return - The first matching element, or NULL if there is none.
+     */
+    DOMElement* evaluateSteps(const PathQuery &query, vector<DOMElement*>* all);
+
+    /**
+     * Applies predicates in order to a list of matches, keeping the matches
+     * which pass every predicate. A position counts the matches left by the
+     * predicates before it.
+     * @param matches - The matches, in document order. Passed by reference.
+     * @param first - The first predicate to apply.
+     * @param last - The predicate after the last one to apply.
+     */
+    static void filterMatches(vector<DOMElement*> &matches, vector<PathPredicate>::const_iterator first,
+            vector<PathPredicate>::const_iterator last);
+
+    /**
+     * Gets the list of elements with the passed name, first applying any
+     * deferred updates to it.
+     * @param name - The name of the elements.
+     * @return - The list, or NULL if there are no elements with that name.
+     */
+    vector<DOMElement*>* listFor(const string &name);
+
+    /**
+     * Checks if so many elements were added while updates were deferred that
+     * building the index again is quicker than sorting them in. If so, the
+     * index is built again, which also applies every other deferred update.
+     */
+    void rebuildIfLarge();
+
+    /**
+     * Applies deferred updates to the list of elements with one name.
+     * @param list - The list to update, in document order.
+     * @param changes - The elements added to and removed from the list.
+     */
+    static void applyChanges(vector<DOMElement*> &list, const PendingChanges &changes);
+
+    /**
+     * Gets the children of a node with the passed name, building the lists of
+     * its children if this is the first time they are needed.
+     * @param parent - The element or document whose children are wanted.
+     * @param name - The name of the children, or '*' for every child element.
+     * @return - The children, in document order.
+     */
+    const vector<DOMElement*>& children(const DOMNode* parent, const string &name);
+
+    /**
+     * Gets the elements matched by a step of a path before its predicates are applied.
+     * @param step - The step of the path.
+     * @param context - The node the step starts from.
+     * @param scratch - Used to hold the matches when they are not already stored.
+     * @return - The matches, in document order.
+     */
+    const vector<DOMElement*>& candidates(const PathStep &step, const DOMNode* context,
+            vector<DOMElement*> &scratch);
+
+    /** The document that was indexed. */
+    DOMDocument* document;
+
+    /** The elements with each name, in document order. */
+    unordered_map<string, vector<DOMElement*> > elements;
+
+    /** The children of an element or the document, stored under each name and under '*'. */
+    unordered_map<const DOMNode*, unordered_map<string, vector<DOMElement*> > > childIndex;
+
+    /** The compiled paths. */
+    QueryCache queries;
+
+    /** Returned when there are no matching children. */
+    vector<DOMElement*> emptyList;
+
+    /** The deferred updates to the list of elements with each name. */
+    unordered_map<string, PendingChanges> pending;
+
+    /** The number of calls to 'deferUpdates' not yet matched by 'applyUpdates'. */
+    int deferDepth;
+
+    /** The number of added elements in the deferred updates. */
+    size_t pendingAdds;
+
+    /** Reused to hold the key of the element being looked up. */
+    string nameKey;
+
+    /** The number of elements in the index. */
+    size_t count;
+};
+
+#endif	/* NODEINDEX_H */
+
@@ -0,0 +1,136 @@
+/* File:   OutputContext.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ * 
+ * This is the implementation file for the OutputContext class, which holds everything
+ * the shell needs to print and export the tree. It is created once when the
+ * shell starts and reused by every 'print' and 'export' command, rather than
+ * creating and releasing a new serializer, output and format target each time.
+ * 
+ * Trees are written by the UTF8Writer whenever possible. The Xerces serializer
+ * is only created the first time a tree contains a node the writer does not
+ * support, and its output goes into the same buffered sink.
+ */
+
+#include "OutputContext.h"
+
+/**
+ * Format target which passes the output of the Xerces serializer to a sink,
+ * so that it is written to the console or a file in the same way as the UTF8Writer.
+ */
+class SinkFormatTarget : public XMLFormatTarget {
+public:
+
+    /**
+     * Custom constructor. 
+     * @param outSink - The sink to which the serializer's output is passed.
+     */
+    SinkFormatTarget(OutputSink &outSink) : sink(outSink) {
+    }
+
+    /**
+     * Called by the serializer with each piece of its output.
+     * @param toWrite - The bytes to write. 
+     * @param count - The number of bytes. 
+     * The formatter that produced the bytes is not used.
+     */
+    virtual void writeChars(const XMLByte * const toWrite, const XMLSize_t count,
+            XMLFormatter * const /*formatter*/) {
+        sink.write((const char*) toWrite, count);
+    }
+
+private:
+
+    /** The sink to which the serializer's output is passed. */
+    OutputSink &sink;
+};
+
+/**
+ * Standard constructor. The serializer is not created until it is first needed.
+ */
+OutputContext::OutputContext() {
+    serializer = NULL;
+    output = NULL;
+    target = NULL;
+    serializerDeclaration = false;
+    writer.setCache(&cache);
+}
+
+/**
+ * Standard destructor. Releases the serializer if it is still held.
+ */
+OutputContext::~OutputContext() {
+    release();
+}
+
+/**
+ * Gets the buffered output shared by every command. 
+ * @return - The sink, which writes to the console unless a file is open.
+ */
+OutputSink& OutputContext::getSink() {
+    return sink;
+}
+
+/**
+ * Gets the cache of bytes written for large elements, which must be told
+ * about every change made to the tree.
+ * @return - The cache.
+ */
+SubtreeCache& OutputContext::getCache() {
+    return cache;
+}
+
+/**
+ * Writes a node in an XML format to the sink. 
+ * @param doc - The document containing the node.
+ * @param node - The node to be written, either the document or an element.
+ * @param xmlDeclaration - Whether a document starts with the XML declaration.
+ */
+void OutputContext::writeXML(DOMDocument* doc, DOMNode* node, bool xmlDeclaration) {
+
+    if (writer.canWrite(node)) {
+        writer.write(node, xmlDeclaration, sink);
+        return;
+    }
+
+    // The serializer and its output are created once and kept for later commands. 
+    if (serializer == NULL) {
+        DOMImplementation * impl = doc->getImplementation();
+        serializer = ((DOMImplementationLS*) impl)->createLSSerializer();
+        output = ((DOMImplementationLS*) impl)->createLSOutput();
+        target = new SinkFormatTarget(sink);
+        output->setByteStream(target);
+
+        DOMConfiguration* serializerConfig = serializer->getDomConfig();
+        serializerConfig->setParameter(XMLUni::fgDOMWRTFormatPrettyPrint, true);
+        serializerConfig->setParameter(XMLUni::fgDOMXMLDeclaration, xmlDeclaration);
+        serializerDeclaration = xmlDeclaration;
+    }
+
+    // The XML declaration is the only setting that differs between commands.
+    if (serializerDeclaration != xmlDeclaration) {
+        serializer->getDomConfig()->setParameter(XMLUni::fgDOMXMLDeclaration, xmlDeclaration);
+        serializerDeclaration = xmlDeclaration;
+    }
+
+    serializer->write(node, output);
+}
+
+/**
+ * Releases the serializer and its output. Must be called before the XML
+ * platform utilities are closed.
+ */
+void OutputContext::release() {
+    sink.close();
+
+    if (serializer != NULL) {
+        output->release();
+        serializer->release();
+        delete target;
+        serializer = NULL;
+        output = NULL;
+        target = NULL;
+    }
+}
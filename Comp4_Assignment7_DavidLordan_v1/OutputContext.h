@@ -0,0 +1,102 @@
+/* File:   OutputContext.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ * 
+ * This is the header file for the OutputContext class, which holds everything
+ * the shell needs to print and export the tree. It is created once when the
+ * shell starts and reused by every 'print' and 'export' command, rather than
+ * creating and releasing a new serializer, output and format target each time.
+ * 
+ * Trees are written by the UTF8Writer whenever possible. The Xerces serializer
+ * is only created the first time a tree contains a node the writer does not
+ * support, and its output goes into the same buffered sink.
+ * 
+ * The writer keeps the bytes of large elements in a SubtreeCache, which the journal
+ * invalidates as the tree changes, so repeated prints and exports of a tree which
+ * has barely changed only walk the parts which did.
+ */
+
+#ifndef OUTPUTCONTEXT_H
+#define	OUTPUTCONTEXT_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include "OutputSink.h"
+#include "UTF8Writer.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class OutputContext {
+public:
+
+    /**
+     * Standard constructor. The serializer is not created until it is first needed.
+     */
+    OutputContext();
+
+    /**
+     * Standard destructor. Releases the serializer if it is still held.
+     */
+    virtual ~OutputContext();
+
+    /**
+     * Gets the buffered output shared by every command. 
+     * @return - The sink, which writes to the console unless a file is open.
+     */
+    OutputSink& getSink();
+
+    /**
+     * Gets the cache of bytes written for large elements, which must be told
+     * about every change made to the tree.
+     * @return - The cache.
+     */
+    SubtreeCache& getCache();
+
+    /**
+     * Writes a node in an XML format to the sink. 
+     * @param doc - The document containing the node.
+     * @param node - The node to be written, either the document or an element.
+     * @param xmlDeclaration - Whether a document starts with the XML declaration.
+     */
+    void writeXML(DOMDocument* doc, DOMNode* node, bool xmlDeclaration);
+
+    /**
+     * Releases the serializer and its output. Must be called before the XML
+     * platform utilities are closed.
+     */
+    void release();
+
+private:
+
+    /** Copying a context would release the serializer twice, so it is not allowed. */
+    OutputContext(const OutputContext& orig);
+    OutputContext& operator=(const OutputContext& orig);
+
+    /** The buffered output shared by every command. */
+    OutputSink sink;
+
+    /** Writes trees straight to the sink. */
+    UTF8Writer writer;
+
+    /** The bytes written by the writer for large elements. */
+    SubtreeCache cache;
+
+    /** The Xerces serializer, created the first time it is needed. */
+    DOMLSSerializer* serializer;
+
+    /** The serializer's output, which writes into the sink. */
+    DOMLSOutput* output;
+
+    /** Format target passing the serializer's output to the sink. */
+    XMLFormatTarget* target;
+
+    /** The XML declaration setting last given to the serializer. */
+    bool serializerDeclaration;
+};
+
+#endif	/* OUTPUTCONTEXT_H */
+
@@ -0,0 +1,177 @@
+/* File:   OutputSink.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ * 
+ * This is the implementation file for the OutputSink class, which collects the text
+ * written by the tree-walker in a large buffer. The buffer is only written to
+ * the console, or to a file, once it is full or the output is complete, rather
+ * than flushing every line. The indentation used for each level of the tree
+ * is built once and reused. Files may be compressed as they are written.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "OutputSink.h"
+
+/** The most space set aside for the buffer up front. Larger buffers grow as needed. */
+static const size_t MAX_RESERVED = 1 << 20;
+
+/**
+ * Custom constructor. The sink writes to the console until a file is opened.
+ * @param nBlockSize - The number of bytes collected before they are written. Defaults to 64 KB.
+ */
+OutputSink::OutputSink(size_t nBlockSize) : compressedStream(&compressed) {
+    blockSize = nBlockSize;
+    buffer.reserve(blockSize < MAX_RESERVED ? blockSize : MAX_RESERVED);
+    indentation.assign(3 * 16, ' ');
+    out = &cout;
+}
+
+/**
+ * Standard destructor. Writes anything left in the buffer and closes any open file.
+ */
+OutputSink::~OutputSink() {
+    close();
+}
+
+/**
+ * Sends all following output to a file in place of the console.
+ * @param strPath - The name of the file to write.
+ * @param compression - The way the file is compressed. Defaults to no compression.
+ * @return - False if the file could not be opened, in which case the console is still used.
+ */
+bool OutputSink::open(const string &strPath, Compression compression) {
+    close();
+
+    // A compressed file is compressed on its own thread as the buffer is written to it.
+    if (compression != NO_COMPRESSION) {
+        if (!compressed.open(strPath, compression)) {
+            return false;
+        }
+        compressedStream.clear();
+        out = &compressedStream;
+        return true;
+    }
+
+    file.open(strPath.c_str(), ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    out = &file;
+    return true;
+}
+
+/**
+ * Writes anything left in the buffer and closes the open file. All following
+ * output is sent to the console again.
+ * @return - False if the file could not be written in full.
+ */
+bool OutputSink::close() {
+    flush();
+
+    bool written = !out->fail();
+    if (file.is_open()) {
+        file.close();
+        written = written && !file.fail();
+    }
+    if (compressed.isOpen()) {
+        written = compressed.close() && written;
+    }
+    out = &cout;
+    return written;
+}
+
+/**
+ * Writes everything in the buffer to the console or file.
+ */
+void OutputSink::flush() {
+    if (!buffer.empty()) {
+        out->write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    out->flush();
+}
+
+/**
+ * Moves the text collected so far out of the buffer, rather than writing it.
+ * A sink whose block size is never reached keeps all of its output in memory
+ * until it is taken.
+ * @param text - The string which receives the text. Passed by reference.
+ */
+void OutputSink::take(string &text) {
+    text.swap(buffer);
+    buffer.clear();
+}
+
+/**
+ * Adds text to the buffer.
+ * @param text - The text to add.
+ * @param length - The number of characters of text to add.
+ */
+void OutputSink::write(const char* text, size_t length) {
+    buffer.append(text, length);
+
+    // The buffer is only written out once a whole block has been collected. 
+    if (buffer.size() >= blockSize) {
+        out->write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+/**
+ * Adds a string to the buffer.
+ * @param text - The string to add.
+ */
+void OutputSink::write(const string &text) {
+    write(text.data(), text.size());
+}
+
+/**
+ * Adds a single character to the buffer.
+ * @param c - The character to add.
+ */
+void OutputSink::write(char c) {
+    write(&c, 1);
+}
+
+/**
+ * Transcodes a Xerces string and adds it to the buffer.
+ * @param text - The Xerces string to add.
+ */
+void OutputSink::write(const XMLCh* text) {
+    char* transcoded = XMLString::transcode(text);
+    if (transcoded != NULL) {
+        write(transcoded, strlen(transcoded));
+        XMLString::release(&transcoded);
+    }
+}
+
+/**
+ * Adds a number to the buffer.
+ * @param number - The number to add.
+ */
+void OutputSink::writeNumber(unsigned long long number) {
+    char digits[24];
+    int length = snprintf(digits, sizeof (digits), "%llu", number);
+    write(digits, length);
+}
+
+/**
+ * Adds the indentation for a level of the tree to the buffer.
+ * @param level - The level of the tree.
+ * @param width - The number of spaces per level. Defaults to 3.
+ */
+void OutputSink::indent(int level, int width) {
+    if (level <= 0) {
+        return;
+    }
+
+    // The spaces are only added to when a deeper level than ever before is reached.
+    size_t length = (size_t) level * width;
+    if (indentation.size() < length) {
+        indentation.resize(length, ' ');
+    }
+    write(indentation.data(), length);
+}
@@ -0,0 +1,137 @@
+/* File:   OutputSink.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ * 
+ * This is the header file for the OutputSink class, which collects the text
+ * written by the tree-walker in a large buffer. The buffer is only written to
+ * the console, or to a file, once it is full or the output is complete, rather
+ * than flushing every line. The indentation used for each level of the tree
+ * is built once and reused. Files may be compressed as they are written.
+ */
+
+#ifndef OUTPUTSINK_H
+#define	OUTPUTSINK_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "CompressedFile.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class OutputSink {
+public:
+
+    /**
+     * Custom constructor. The sink writes to the console until a file is opened.
+     * @param nBlockSize - The number of bytes collected before they are written. Defaults to 64 KB.
+     */
+    OutputSink(size_t nBlockSize = 1 << 16);
+
+    /**
+     * Standard destructor. Writes anything left in the buffer and closes any open file.
+     */
+    virtual ~OutputSink();
+
+    /**
+     * Sends all following output to a file in place of the console.
+     * @param strPath - The name of the file to write.
+     * @param compression - The way the file is compressed. Defaults to no compression.
+     * @return - False if the file could not be opened, in which case the console is still used.
+     */
+    bool open(const string &strPath, Compression compression = NO_COMPRESSION);
+
+    /**
+     * Writes anything left in the buffer and closes the open file. All following
+     * output is sent to the console again.
+     * @return - False if the file could not be written in full.
+     */
+    bool close();
+
+    /**
+     * Writes everything in the buffer to the console or file.
+     */
+    void flush();
+
+    /**
+     * Moves the text collected so far out of the buffer, rather than writing it.
+     * A sink whose block size is never reached keeps all of its output in memory
+     * until it is taken.
+     * @param text - The string which receives the text. Passed by reference.
+     */
+    void take(string &text);
+
+    /**
+     * Adds text to the buffer.
+     * @param text - The text to add.
+     * @param length - The number of characters of text to add.
+     */
+    void write(const char* text, size_t length);
+
+    /**
+     * Adds a string to the buffer.
+     * @param text - The string to add.
+     */
+    void write(const string &text);
+
+    /**
+     * Adds a single character to the buffer.
+     * @param c - The character to add.
+     */
+    void write(char c);
+
+    /**
+     * Transcodes a Xerces string and adds it to the buffer.
+     * @param text - The Xerces string to add.
+     */
+    void write(const XMLCh* text);
+
+    /**
+     * Adds a number to the buffer.
+     * @param number - The number to add.
+     */
+    void writeNumber(unsigned long long number);
+
+    /**
+     * Adds the indentation for a level of the tree to the buffer.
+     * @param level - The level of the tree.
+     * @param width - The number of spaces per level. Defaults to 3.
+     */
+    void indent(int level, int width = 3);
+
+private:
+
+    /** Copying a sink would write its buffer twice, so it is not allowed. */
+    OutputSink(const OutputSink& orig);
+    OutputSink& operator=(const OutputSink& orig);
+
+    /** The number of bytes collected before they are written. */
+    size_t blockSize;
+
+    /** The text waiting to be written. */
+    string buffer;
+
+    /** Spaces for the deepest level indented so far, shared by every level. */
+    string indentation;
+
+    /** The file being written, if one is open. */
+    ofstream file;
+
+    /** The compressed file being written, if one is open. */
+    CompressedFile compressed;
+
+    /** Stream which writes to 'compressed'. */
+    ostream compressedStream;
+
+    /** Where the buffer is written, either the console or the open file. */
+    ostream* out;
+};
+
+#endif	/* OUTPUTSINK_H */
+
@@ -0,0 +1,188 @@
+/* File:   ParallelExport.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the ParallelExport class, which writes a tree to
+ * an XML file on several threads. Shards of the root's children are written into memory
+ * in parallel, then each is written into the file at the offset it ends up at.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits>
+#include <thread>
+#include "ParallelExport.h"
+
+/** The number of shards made for each thread, so the work stays balanced. */
+static const size_t SHARDS_PER_THREAD = 8;
+
+/** The block size of a sink which keeps all of its output in memory. */
+static const size_t IN_MEMORY = numeric_limits<size_t>::max();
+
+/**
+ * Custom constructor.
+ * @param nThreads - The number of threads to use, or 0 for one per core. No
+ *                   more threads are used than there are cores.
+ */
+ParallelExport::ParallelExport(unsigned int nThreads) : next(0), supported(true), stored(true) {
+    unsigned int cores = thread::hardware_concurrency();
+    threads = nThreads;
+    if (threads == 0 || (cores > 0 && threads > cores)) {
+        threads = cores;
+    }
+    if (threads == 0) {
+        threads = 1;
+    }
+    usedThreads = threads;
+}
+
+/**
+ * Writes a document to a file on several threads.
+ * @param doc - The document.
+ * @param fileName - The path of the file.
+ * @return - Whether the file was written, could not be written this way, or
+ *           could not be created.
+ */
+ParallelResult ParallelExport::write(const DOMDocument* doc, const string &fileName) {
+    const DOMNode* root = doc->getFirstChild();
+    if (root == NULL || root->getNodeType() != DOMNode::ELEMENT_NODE
+            || root->getNextSibling() != NULL || root->getFirstChild() == NULL
+            || !UTF8Writer::canWriteDocument(doc)) {
+        return PARALLEL_UNSUPPORTED;
+    }
+
+    // Splits the root's children into shards with about the same number of children.
+    children.clear();
+    for (DOMNode* child = root->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        children.push_back(child);
+    }
+    size_t shards = min(children.size(), threads * SHARDS_PER_THREAD);
+
+    // A thread without a shard of its own would have nothing to write.
+    usedThreads = (unsigned int) min(shards, (size_t) threads);
+
+    UTF8Writer writer;
+    starts.clear();
+    whiteSpace.clear();
+    for (size_t i = 0; i < shards; i++) {
+        size_t first = i * children.size() / shards;
+        starts.push_back(first);
+        whiteSpace.push_back(first == 0 ? 0 : writer.trailingWhiteSpace(children[first - 1]));
+    }
+    starts.push_back(children.size());
+
+    // The head and tail are written here, and the shards between them on every thread.
+    parts.assign(shards + 2, string());
+    OutputSink sink(IN_MEMORY);
+    writer.writeHead(root, true, sink);
+    sink.take(parts.front());
+    writer.writeTail(root, sink);
+    sink.take(parts.back());
+
+    next = 0;
+    supported = true;
+    vector<thread> workers;
+    for (unsigned int i = 1; i < usedThreads; i++) {
+        workers.push_back(thread(&ParallelExport::writeShards, this));
+    }
+    writeShards();
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+
+    vector<const DOMNode*>().swap(children);
+    if (!supported) {
+        vector<string>().swap(parts);
+        return PARALLEL_UNSUPPORTED;
+    }
+
+    // Each part goes straight after the ones before it.
+    offsets.resize(parts.size());
+    size_t total = 0;
+    for (size_t i = 0; i < parts.size(); i++) {
+        offsets[i] = total;
+        total += parts[i].size();
+    }
+
+    int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        vector<string>().swap(parts);
+        return PARALLEL_FAILED;
+    }
+
+    next = 0;
+    stored = (ftruncate(fd, total) == 0);
+    workers.clear();
+    for (unsigned int i = 1; i < usedThreads; i++) {
+        workers.push_back(thread(&ParallelExport::storeShards, this, fd));
+    }
+    storeShards(fd);
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+
+    if (::close(fd) != 0) {
+        stored = false;
+    }
+    vector<string>().swap(parts);
+    return stored ? PARALLEL_WRITTEN : PARALLEL_FAILED;
+}
+
+/**
+ * Gets the number of threads used by the last write, which is never more
+ * than the number of shards.
+ * @return - The number of threads.
+ */
+unsigned int ParallelExport::getThreads() const {
+    return usedThreads;
+}
+
+/**
+ * Gets the number of shards the root's children were split into by the last write.
+ * @return - The number of shards.
+ */
+size_t ParallelExport::getShards() const {
+    return starts.empty() ? 0 : starts.size() - 1;
+}
+
+/**
+ * Writes shards into memory until there are none left. Runs on each thread.
+ */
+void ParallelExport::writeShards() {
+    UTF8Writer writer;
+    OutputSink sink(IN_MEMORY);
+
+    size_t shard;
+    while (supported && (shard = next++) < starts.size() - 1) {
+        if (!writer.writeChildren(&children[starts[shard]], starts[shard + 1] - starts[shard], whiteSpace[shard], sink)) {
+            supported = false;
+        }
+        sink.take(parts[shard + 1]);
+    }
+}
+
+/**
+ * Writes the shards into the file until there are none left. Runs on each thread.
+ * @param fd - The file, already created.
+ */
+void ParallelExport::storeShards(int fd) {
+    size_t part;
+    while (stored && (part = next++) < parts.size()) {
+        const char* data = parts[part].data();
+        size_t left = parts[part].size();
+        off_t offset = offsets[part];
+
+        while (left > 0) {
+            ssize_t count = pwrite(fd, data, left, offset);
+            if (count <= 0) {
+                stored = false;
+                return;
+            }
+            data += count;
+            left -= count;
+            offset += count;
+        }
+    }
+}
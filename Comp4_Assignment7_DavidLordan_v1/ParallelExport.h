@@ -0,0 +1,121 @@
+/* File:   ParallelExport.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the ParallelExport class, which writes a large tree to an
+ * XML file on several threads at once. The root's children are split into shards of
+ * consecutive children, several per thread so that threads which finish early take
+ * on more. Each thread writes whole shards into memory with its own UTF8Writer.
+ * Once every shard is written, its place in the file follows from the sizes of
+ * those before it, and the threads write the shards into the file at those offsets.
+ *
+ * The file holds the same bytes as 'export' would write. The only state which passes
+ * from one of the root's children to the next is the whitespace ending the last text,
+ * so each shard starts from the 'trailingWhiteSpace' of the child before it.
+ *
+ * Only trees whose root is the document's only child, and which hold nothing but
+ * elements and text, can be written this way. The whole file is held in memory
+ * while it is written.
+ */
+
+#ifndef PARALLELEXPORT_H
+#define	PARALLELEXPORT_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "UTF8Writer.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+/**
+ * The results of writing a tree on several threads.
+ */
+enum ParallelResult {
+    PARALLEL_WRITTEN, PARALLEL_UNSUPPORTED, PARALLEL_FAILED
+};
+
+class ParallelExport {
+public:
+
+    /**
+     * Custom constructor.
+     * @param nThreads - The number of threads to use, or 0 for one per core. No
+     *                   more threads are used than there are cores.
+     */
+    ParallelExport(unsigned int nThreads = 0);
+
+    /**
+     * Writes a document to a file on several threads.
+     * @param doc - The document.
+     * @param fileName - The path of the file.
+     * @return - Whether the file was written, could not be written this way, or
+     *           could not be created.
+     */
+    ParallelResult write(const DOMDocument* doc, const string &fileName);
+
+    /**
+     * Gets the number of threads used by the last write, which is never more
+     * than the number of shards.
+     * @return - The number of threads.
+     */
+    unsigned int getThreads() const;
+
+    /**
+     * Gets the number of shards the root's children were split into by the last write.
+     * @return - The number of shards.
+     */
+    size_t getShards() const;
+
+private:
+
+    /**
+     * Writes shards into memory until there are none left. Runs on each thread.
+     */
+    void writeShards();
+
+    /**
+     * Writes the shards into the file until there are none left. Runs on each thread.
+     * @param fd - The file, already created.
+     */
+    void storeShards(int fd);
+
+    /** The number of threads to use. */
+    unsigned int threads;
+
+    /** The number of threads used by the last write. */
+    unsigned int usedThreads;
+
+    /** The root's children. */
+    vector<const DOMNode*> children;
+
+    /** The position of the first child of each shard, followed by the number of children. */
+    vector<size_t> starts;
+
+    /** The 'trailingWhiteSpace' of the child before each shard. */
+    vector<unsigned int> whiteSpace;
+
+    /** The bytes of each part of the file: the head, each shard, then the tail. */
+    vector<string> parts;
+
+    /** The position of each part in the file. */
+    vector<size_t> offsets;
+
+    /** The next shard or part to be taken by a thread. */
+    atomic<size_t> next;
+
+    /** Cleared by a thread which finds a node it cannot write. */
+    atomic<bool> supported;
+
+    /** Cleared by a thread which cannot write to the file. */
+    atomic<bool> stored;
+};
+
+#endif	/* PARALLELEXPORT_H */
+
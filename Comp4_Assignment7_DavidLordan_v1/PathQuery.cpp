@@ -0,0 +1,253 @@
+/* File:   PathQuery.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the PathQuery class, which lets the shell commands
+ * address an element with a path instead of a bare name. A path is compiled into
+ * its steps once and kept in a QueryCache under the text of the path. The compiled
+ * steps are run against the document by the NodeIndex.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include "PathQuery.h"
+
+/**
+ * Helper function to transcode a string into a null terminated array of XMLCh.
+ * @param input - The string to transcode.
+ * @param output - The transcoded string. Passed by reference.
+ */
+static void transcodeInto(const string &input, vector<XMLCh> &output) {
+    XMLCh* xInput = XMLString::transcode(input.c_str());
+    output.assign(xInput, xInput + XMLString::stringLen(xInput) + 1);
+    XMLString::release(&xInput);
+}
+
+/**
+ * Helper function to read the predicate between a pair of square brackets.
+ * @param text - The text between the brackets.
+ * @param predicate - The predicate read. Passed by reference.
+ * @param error - A description of what is wrong with the predicate. Passed by reference.
+ * @return - False if the predicate is not valid.
+ */
+static bool compilePredicate(const string &text, PathPredicate &predicate, string &error) {
+    predicate.position = 0;
+    predicate.hasValue = false;
+
+    // A number keeps only the match in that position.
+    if (!text.empty() && text.find_first_not_of("0123456789") == string::npos) {
+        predicate.position = strtoul(text.c_str(), NULL, 10);
+        if (predicate.position == 0) {
+            error = "positions start at 1";
+            return false;
+        }
+        return true;
+    }
+
+    if (text.size() < 2 || text[0] != '@') {
+        error = "a predicate must be a position or an attribute";
+        return false;
+    }
+
+    string::size_type equals = text.find('=');
+    string name = text.substr(1, equals == string::npos ? string::npos : equals - 1);
+    if (name.empty()) {
+        error = "missing attribute name";
+        return false;
+    }
+    transcodeInto(name, predicate.attName);
+
+    // The value may be written with or without quotes.
+    if (equals != string::npos) {
+        string value = text.substr(equals + 1);
+        if (value.size() >= 2 && (value[0] == '"' || value[0] == '\'')) {
+            if (value[value.size() - 1] != value[0]) {
+                error = "unmatched quote";
+                return false;
+            }
+            value = value.substr(1, value.size() - 2);
+        }
+        predicate.hasValue = true;
+        transcodeInto(value, predicate.attValue);
+    }
+    return true;
+}
+
+/**
+ * Helper function to find a closing bracket, passing over any quoted text so
+ * that an attribute value may hold brackets.
+ * @param expression - The path.
+ * @param pos - The position to start looking from.
+ * @param closing - The bracket to find.
+ * @return - The position of the bracket, or npos if there is none outside quotes.
+ */
+static string::size_type findClosing(const string &expression, string::size_type pos, char closing) {
+    char quote = 0;
+    for (; pos < expression.size(); pos++) {
+        char c = expression[pos];
+        if (quote != 0) {
+            if (c == quote) {
+                quote = 0;
+            }
+        } else if (c == '"' || c == '\'') {
+            quote = c;
+        } else if (c == closing) {
+            return pos;
+        }
+    }
+    return string::npos;
+}
+
+/**
+ * Helper function to read the predicates in square brackets following a step.
+ * @param expression - The path.
+ * @param pos - The position of the first '[', moved past the last ']'. Passed by reference.
+ * @param predicates - The predicates read are added here. Passed by reference.
+ * @param error - A description of what is wrong with a predicate. Passed by reference.
+ * @return - False if a predicate is not valid.
+ */
+static bool compilePredicates(const string &expression, string::size_type &pos,
+        vector<PathPredicate> &predicates, string &error) {
+    while (pos < expression.size() && expression[pos] == '[') {
+        string::size_type close = findClosing(expression, pos, ']');
+        if (close == string::npos) {
+            error = "missing ']'";
+            return false;
+        }
+
+        PathPredicate predicate;
+        if (!compilePredicate(expression.substr(pos + 1, close - pos - 1), predicate, error)) {
+            return false;
+        }
+        predicates.push_back(predicate);
+        pos = close + 1;
+    }
+    return true;
+}
+
+/**
+ * Checks if a node name given to a command is a path rather than a bare name.
+ * @param expression - The name given to the command.
+ * @return - True if it is a path.
+ */
+bool PathQuery::isPath(const string &expression) {
+    return expression.find_first_of("/[*(") != string::npos;
+}
+
+/**
+ * Compiles a path into its steps.
+ * @param expression - The path.
+ * @param error - A description of what is wrong with the path. Passed by reference.
+ * @return - False if the path is not valid.
+ */
+bool PathQuery::compile(const string &expression, string &error) {
+    steps.clear();
+    filters.clear();
+    string::size_type pos = 0;
+
+    // Predicates after a path in round brackets count every match of the path.
+    if (!expression.empty() && expression[0] == '(') {
+        if (expression.compare(1, 1, "(") == 0) {
+            error = "round brackets cannot be nested";
+            return false;
+        }
+        string::size_type close = findClosing(expression, 1, ')');
+        if (close == string::npos) {
+            error = "missing ')'";
+            return false;
+        }
+        if (!compile(expression.substr(1, close - 1), error)) {
+            return false;
+        }
+
+        pos = close + 1;
+        if (!compilePredicates(expression, pos, filters, error)) {
+            return false;
+        }
+        if (pos != expression.size()) {
+            error = "expected '[' after ')'";
+            return false;
+        }
+        return true;
+    }
+
+    while (pos < expression.size()) {
+        PathStep step;
+
+        // A path which does not start with a '/' is searched for anywhere in
+        // the document, the same as a bare name.
+        if (expression.compare(pos, 2, "//") == 0) {
+            step.descendant = true;
+            pos += 2;
+        } else if (expression[pos] == '/') {
+            step.descendant = false;
+            pos++;
+        } else if (pos == 0) {
+            step.descendant = true;
+        } else {
+            error = "expected '/'";
+            return false;
+        }
+
+        string::size_type end = expression.find_first_of("/[", pos);
+        if (end == string::npos) {
+            end = expression.size();
+        }
+        step.name = expression.substr(pos, end - pos);
+        pos = end;
+
+        if (step.name.empty()) {
+            error = "missing element name";
+            return false;
+        }
+
+        if (!compilePredicates(expression, pos, step.predicates, error)) {
+            return false;
+        }
+        steps.push_back(step);
+    }
+
+    if (steps.empty()) {
+        error = "empty path";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Custom constructor.
+ * @param nMaxQueries - The number of compiled paths kept before the cache is emptied.
+ */
+QueryCache::QueryCache(size_t nMaxQueries) {
+    maxQueries = nMaxQueries;
+}
+
+/**
+ * Gets the compiled form of a path, compiling it if it is not in the cache.
+ * If the path is not valid the user is informed.
+ * @param expression - The path.
+ * @return - The compiled path, or NULL if it is not valid.
+ */
+const PathQuery* QueryCache::get(const string &expression) {
+    unordered_map<string, PathQuery>::iterator it = queries.find(expression);
+
+    if (it != queries.end()) {
+        return &it->second;
+    }
+
+    PathQuery query;
+    string error;
+    if (!query.compile(expression, error)) {
+        cout << "Invalid path '" << expression << "': " << error << "." << endl;
+        return NULL;
+    }
+
+    // The shell only ever uses a handful of paths, so rather than tracking which
+    // were used last the whole cache is emptied once it is full.
+    if (queries.size() >= maxQueries) {
+        queries.clear();
+    }
+    return &queries.insert(make_pair(expression, query)).first->second;
+}
@@ -0,0 +1,127 @@
+/* File:   PathQuery.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the PathQuery class, which lets the shell commands
+ * address an element with a path instead of a bare name. A path is a list of
+ * steps, each one an element name or '*', separated by '/' to go down to a child
+ * or by '//' to go down to a descendant at any depth. Each step may be followed
+ * by predicates in square brackets, either a position such as '[2]', an attribute
+ * that must be present such as '[@id]', or an attribute value such as '[@id="2"]'.
+ * As in XPath, a position counts the matches of its step among the children of
+ * the same parent, so '//Campus[2]' is every Campus element which is the second
+ * Campus child of its parent. A whole path may be put in round brackets and
+ * followed by predicates which apply to all of its matches in document order,
+ * so '(//Campus)[2]' is the second Campus element in the document. For example:
+ *
+ *     /CS_Degree/Fall_14/Algorithms/Grade
+ *     //Campus[2]
+ *     (//Campus)[2]
+ *     //Fall_14/Algorithms[@Graduate="true"][1]
+ *
+ * A path is compiled into its steps once and kept in a QueryCache under the
+ * text of the path, so that running the same command again does not parse it again.
+ */
+
+#ifndef PATHQUERY_H
+#define	PATHQUERY_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+/**
+ * Structure storing a single predicate of a path step.
+ */
+struct PathPredicate {
+    /** The position of the match to keep, counting from 1. 0 for an attribute test. */
+    size_t position;
+
+    /** The name of the attribute that must be present. */
+    vector<XMLCh> attName;
+
+    /** Set if the attribute must also have a particular value. */
+    bool hasValue;
+
+    /** The value the attribute must have. */
+    vector<XMLCh> attValue;
+};
+
+/**
+ * Structure storing a single step of a path.
+ */
+struct PathStep {
+    /** Set if the step matches descendants at any depth rather than only children. */
+    bool descendant;
+
+    /** The element name to match, or '*' for any element. */
+    string name;
+
+    /** The predicates, applied in order to the matches of the step. */
+    vector<PathPredicate> predicates;
+};
+
+class PathQuery {
+public:
+
+    /**
+     * Checks if a node name given to a command is a path rather than a bare name.
+     * @param expression - The name given to the command.
+     * @return - True if it is a path.
+     */
+    static bool isPath(const string &expression);
+
+    /**
+     * Compiles a path into its steps.
+     * @param expression - The path.
+     * @param error - A description of what is wrong with the path. Passed by reference.
+     * @return - False if the path is not valid.
+     */
+    bool compile(const string &expression, string &error);
+
+    /** The steps of the path, in order from the document down. */
+    vector<PathStep> steps;
+
+    /**
+     * The predicates after a path in round brackets, applied in order to every
+     * match of the path in document order. Empty for a path without brackets.
+     */
+    vector<PathPredicate> filters;
+};
+
+class QueryCache {
+public:
+
+    /**
+     * Custom constructor.
+     * @param nMaxQueries - The number of compiled paths kept before the cache is emptied.
+     */
+    QueryCache(size_t nMaxQueries = 256);
+
+    /**
+     * Gets the compiled form of a path, compiling it if it is not in the cache.
+     * If the path is not valid the user is informed.
+     * @param expression - The path.
+     * @return - The compiled path, or NULL if it is not valid.
+     */
+    const PathQuery* get(const string &expression);
+
+private:
+
+    /** The compiled paths, stored under the text of the path. */
+    unordered_map<string, PathQuery> queries;
+
+    /** The number of compiled paths kept before the cache is emptied. */
+    size_t maxQueries;
+};
+
+#endif	/* PATHQUERY_H */
+
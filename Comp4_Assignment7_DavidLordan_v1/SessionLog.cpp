@@ -0,0 +1,257 @@
+/* File:   SessionLog.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the SessionLog class, which keeps the work done in
+ * the shell safe from a crash. Changes are appended to a log file, which is synced
+ * in batches, and a binary snapshot of the tree is written whenever replaying the
+ * log would take longer than reading a snapshot.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "SessionLog.h"
+#include "Snapshot.h"
+
+/** The number of changed nodes which are always logged before a snapshot is written. */
+static const size_t MIN_SNAPSHOT_OPS = 1024;
+
+/**
+ * Custom constructor.
+ * @param nDirectory - The folder holding the log and snapshot files.
+ * @param nSyncEvery - The number of records written before the log is synced.
+ * @param nSyncSeconds - The longest time a record waits before the log is synced.
+ * @param nMaxRecords - The number of records logged before a snapshot is written.
+ */
+SessionLog::SessionLog(string nDirectory, size_t nSyncEvery, double nSyncSeconds, size_t nMaxRecords) {
+    logName = nDirectory + "/session.log";
+    snapshotName = nDirectory + "/session.snap";
+    syncEvery = nSyncEvery;
+    syncSeconds = nSyncSeconds;
+    maxRecords = nMaxRecords;
+    fd = -1;
+    sequence = 0;
+    seenChanges = 0;
+    snapshotPosition = 0;
+    snapshotEntries = 0;
+    opsSinceSnapshot = 0;
+    records = 0;
+    unsynced = 0;
+}
+
+/**
+ * Reads the files left by a session which did not quit properly, replacing
+ * the document with the latest snapshot.
+ * @param impl - The DOM implementation used to create the document.
+ * @param doc - The document, replaced if there was a snapshot. Passed by reference.
+ * @param index - The lookup index, rebuilt for the restored document.
+ * @param commands - The commands logged after the snapshot, one per line. Passed by reference.
+ * @return - True if there was a session to recover.
+ */
+bool SessionLog::recover(DOMImplementation* impl, DOMDocument* &doc, NodeIndex &index, string &commands) {
+    bool hasLog = (access(logName.c_str(), F_OK) == 0);
+    bool hasSnapshot = (access(snapshotName.c_str(), F_OK) == 0);
+
+    if (!hasLog && !hasSnapshot) {
+        return false;
+    }
+
+    // Starts from the snapshot, if there is a valid one.
+    unsigned long long snapshotSequence = 0;
+    DOMDocument* restored = NULL;
+    if (Snapshot::read(impl, snapshotName, restored, snapshotSequence)) {
+        doc->release();
+        doc = restored;
+        index.build(doc);
+    } else if (hasSnapshot) {
+        cout << "The snapshot '" << snapshotName << "' is not valid and was not used." << endl;
+    }
+    sequence = snapshotSequence;
+
+    ifstream file(logName.c_str(), ios::binary);
+    stringstream contents;
+    contents << file.rdbuf();
+    string log = contents.str();
+
+    // Reads each record, skipping those already in the snapshot and stopping
+    // at one which was cut short.
+    size_t nRecords = 0;
+    string::size_type pos = 0;
+    while (pos < log.size() && log[pos] == '#') {
+        string::size_type lineEnd = log.find('\n', pos);
+        if (lineEnd == string::npos) {
+            break;
+        }
+
+        char* numberEnd;
+        unsigned long long number = strtoull(log.c_str() + pos + 1, &numberEnd, 10);
+        size_t length = strtoul(numberEnd, NULL, 10);
+        string::size_type start = lineEnd + 1;
+        if (start + length >= log.size() || log[start + length] != '\n') {
+            break;
+        }
+
+        if (number > sequence) {
+            commands.append(log, start, length);
+            commands += '\n';
+            sequence = number;
+            nRecords++;
+        }
+        pos = start + length + 1;
+    }
+
+    cout << "The last session did not quit properly. Restoring it from '" << snapshotName
+            << "' and " << nRecords << " logged commands." << endl;
+    return true;
+}
+
+/**
+ * Starts logging, with a snapshot of the current tree.
+ * @param doc - The document.
+ * @param journal - The journal whose changes are logged.
+ */
+void SessionLog::start(DOMDocument* doc, const Journal &journal) {
+    fd = ::open(logName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        cout << "Could not open the session log '" << logName
+                << "'. Changes will not be recovered after a crash." << endl;
+        return;
+    }
+
+    seenChanges = journal.changeCount();
+    snapshot(doc, journal);
+}
+
+/**
+ * Logs the change made by a command, if it made one. Called after every command.
+ * @param doc - The document.
+ * @param journal - The journal holding the change.
+ * @param index - The lookup index, used for the size of the tree.
+ */
+void SessionLog::record(DOMDocument* doc, const Journal &journal, NodeIndex &index) {
+    if (fd < 0) {
+        return;
+    }
+
+    // Records still waiting from an earlier command are synced once they have
+    // waited long enough.
+    if (unsynced > 0 && chrono::duration<double>(chrono::steady_clock::now() - firstUnsynced).count() >= syncSeconds) {
+        sync();
+    }
+
+    if (journal.changeCount() == seenChanges) {
+        return;
+    }
+    size_t nChanges = journal.changeCount() - seenChanges;
+    seenChanges = journal.changeCount();
+
+    // A change which replaced the tree, which undid an entry from before the
+    // snapshot, or which redid an entry that was not logged after it, such as
+    // one already undone when the snapshot was written, cannot be replayed.
+    const JournalEntry &entry = journal.changedEntry();
+    if (nChanges > 1 || entry.replaced || journal.changedPosition() < snapshotPosition
+            || (journal.lastChange() == CHANGE_REDO && journal.changedPosition() < snapshotEntries)) {
+        snapshot(doc, journal);
+        return;
+    }
+
+    // A new entry replaces every undone entry, so those after it are all logged.
+    if (journal.lastChange() == CHANGE_ENTRY) {
+        snapshotEntries = min(snapshotEntries, journal.changedPosition());
+    }
+
+    if (journal.lastChange() == CHANGE_UNDO) {
+        append("undo");
+    } else if (journal.lastChange() == CHANGE_REDO) {
+        append("redo");
+    } else {
+        append(entry.commands);
+    }
+
+    // Once replaying the log would change more nodes than there are in the
+    // tree, or would run too many commands, reading a snapshot is quicker.
+    opsSinceSnapshot += entry.ops.size();
+    if (++records >= maxRecords || opsSinceSnapshot > max(MIN_SNAPSHOT_OPS, index.size())) {
+        snapshot(doc, journal);
+    }
+}
+
+/**
+ * Ends the session when the shell quits properly, syncing the log and then
+ * removing the log and snapshot since there is nothing to recover.
+ */
+void SessionLog::finish() {
+    if (fd < 0) {
+        return;
+    }
+
+    sync();
+    ::close(fd);
+    fd = -1;
+    unlink(logName.c_str());
+    unlink(snapshotName.c_str());
+}
+
+/**
+ * Writes a snapshot of the tree and starts the log again.
+ * @param doc - The document.
+ * @param journal - The journal, whose position is noted.
+ */
+void SessionLog::snapshot(DOMDocument* doc, const Journal &journal) {
+    if (Snapshot::write(doc, snapshotName, sequence) == 0) {
+        cout << "Could not write the snapshot '" << snapshotName << "'. The log is kept instead." << endl;
+        return;
+    }
+
+    // Every record is in the snapshot, so the log starts again.
+    if (ftruncate(fd, 0) != 0) {
+        cout << "Could not empty the session log '" << logName << "'." << endl;
+    }
+    unsynced = 0;
+    opsSinceSnapshot = 0;
+    records = 0;
+    snapshotPosition = journal.position();
+    snapshotEntries = journal.entryCount();
+}
+
+/**
+ * Appends a record to the log, syncing it once enough records are waiting.
+ * @param commands - The commands making up the record.
+ */
+void SessionLog::append(const string &commands) {
+    ostringstream record;
+    record << '#' << ++sequence << ' ' << commands.size() << '\n' << commands << '\n';
+    string bytes = record.str();
+
+    // The record is written in one call, so it reaches the file even if the
+    // shell crashes straight after.
+    if (::write(fd, bytes.data(), bytes.size()) != static_cast<ssize_t> (bytes.size())) {
+        cout << "Could not write to the session log '" << logName
+                << "'. Changes will not be recovered after a crash." << endl;
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    if (unsynced++ == 0) {
+        firstUnsynced = chrono::steady_clock::now();
+    }
+    if (unsynced >= syncEvery) {
+        sync();
+    }
+}
+
+/**
+ * Syncs the records written to the log to disk.
+ */
+void SessionLog::sync() {
+    if (unsynced > 0) {
+        fdatasync(fd);
+        unsynced = 0;
+    }
+}
@@ -0,0 +1,155 @@
+/* File:   SessionLog.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the SessionLog class, which keeps the work done in the shell
+ * safe from a crash. Every change recorded in the journal is appended to a log file
+ * as the commands which made it, and from time to time a binary snapshot of the
+ * whole tree is written, after which the log starts again. If the shell is started
+ * after it did not quit properly, the latest snapshot is read and the commands
+ * logged after it are entered again, which restores the tree as it was.
+ *
+ * Each logged record is a header line holding its number and length, followed
+ * by the commands. A record cut short by a crash is simply ignored. Records are
+ * written to the file straight away but only synced to disk in batches, once
+ * enough of them are waiting or, at the next command, once the first of them
+ * has waited long enough, since syncing is far slower than writing.
+ *
+ * A snapshot is written after a command which replaces the tree, such as 'load',
+ * once the commands logged since the last snapshot have changed more nodes than
+ * there are in the tree, and once a set number of commands have been logged. The
+ * time taken to recover therefore depends on the size of the snapshot and not on
+ * the length of the session. Commands which undo entries from before the last
+ * snapshot, or redo entries which were not logged since, are not logged, a
+ * snapshot is written instead.
+ */
+
+#ifndef SESSIONLOG_H
+#define	SESSIONLOG_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <string>
+#include <chrono>
+#include "NodeIndex.h"
+#include "Journal.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class SessionLog {
+public:
+
+    /**
+     * Custom constructor.
+     * @param nDirectory - The folder holding the log and snapshot files.
+     * @param nSyncEvery - The number of records written before the log is synced.
+     * @param nSyncSeconds - The longest time a record waits before the log is synced.
+     * @param nMaxRecords - The number of records logged before a snapshot is written.
+     */
+    SessionLog(string nDirectory = "dist", size_t nSyncEvery = 32, double nSyncSeconds = 0.1, size_t nMaxRecords = 1000);
+
+    /**
+     * Reads the files left by a session which did not quit properly, replacing
+     * the document with the latest snapshot.
+     * @param impl - The DOM implementation used to create the document.
+     * @param doc - The document, replaced if there was a snapshot. Passed by reference.
+     * @param index - The lookup index, rebuilt for the restored document.
+     * @param commands - The commands logged after the snapshot, one per line. Passed by reference.
+     * @return - True if there was a session to recover.
+     */
+    bool recover(DOMImplementation* impl, DOMDocument* &doc, NodeIndex &index, string &commands);
+
+    /**
+     * Starts logging, with a snapshot of the current tree.
+     * @param doc - The document.
+     * @param journal - The journal whose changes are logged.
+     */
+    void start(DOMDocument* doc, const Journal &journal);
+
+    /**
+     * Logs the change made by a command, if it made one. Called after every command.
+     * @param doc - The document.
+     * @param journal - The journal holding the change.
+     * @param index - The lookup index, used for the size of the tree.
+     */
+    void record(DOMDocument* doc, const Journal &journal, NodeIndex &index);
+
+    /**
+     * Ends the session when the shell quits properly, syncing the log and then
+     * removing the log and snapshot since there is nothing to recover.
+     */
+    void finish();
+
+private:
+
+    /**
+     * Writes a snapshot of the tree and starts the log again.
+     * @param doc - The document.
+     * @param journal - The journal, whose position is noted.
+     */
+    void snapshot(DOMDocument* doc, const Journal &journal);
+
+    /**
+     * Appends a record to the log, syncing it once enough records are waiting.
+     * @param commands - The commands making up the record.
+     */
+    void append(const string &commands);
+
+    /**
+     * Syncs the records written to the log to disk.
+     */
+    void sync();
+
+    /** The name of the log file. */
+    string logName;
+
+    /** The name of the snapshot file. */
+    string snapshotName;
+
+    /** The log file, or -1 while not logging. */
+    int fd;
+
+    /** The number of the last record written. */
+    unsigned long long sequence;
+
+    /** The number of journal changes already logged. */
+    size_t seenChanges;
+
+    /** The journal position when the last snapshot was written. */
+    size_t snapshotPosition;
+
+    /**
+     * The number of journal entries, undone or not, when the last snapshot was
+     * written, lowered when a logged entry replaces undone ones. Entries below
+     * it are not in the log, so redoing one cannot be replayed.
+     */
+    size_t snapshotEntries;
+
+    /** The number of nodes changed by the commands logged since the last snapshot. */
+    size_t opsSinceSnapshot;
+
+    /** The number of records logged since the last snapshot. */
+    size_t records;
+
+    /** The number of records logged before a snapshot is written. */
+    size_t maxRecords;
+
+    /** The number of records written but not yet synced. */
+    size_t unsynced;
+
+    /** The time the first record not yet synced was written. */
+    chrono::steady_clock::time_point firstUnsynced;
+
+    /** The number of records written before the log is synced. */
+    size_t syncEvery;
+
+    /** The longest time a record waits before the log is synced. */
+    double syncSeconds;
+};
+
+#endif	/* SESSIONLOG_H */
+
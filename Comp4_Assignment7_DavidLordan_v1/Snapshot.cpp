@@ -0,0 +1,352 @@
+/* File:   Snapshot.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the Snapshot class, which saves the whole DOM tree
+ * to a binary file and reads it back. The tree is written in document order through
+ * a buffer, walking it without recursion, and read back into a new document.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include "Snapshot.h"
+
+/** The characters at the start of every snapshot. */
+static const char MAGIC[] = "A7SNAP01";
+
+/** The size of the buffer used to write a snapshot. */
+static const size_t BUFFER_SIZE = 1 << 16;
+
+/**
+ * Structure used to write a snapshot to a file through a buffer.
+ */
+struct SnapshotWriter {
+    /** The file being written. */
+    int fd;
+
+    /** The bytes not yet written to the file. */
+    vector<char> buffer;
+
+    /** The number of bytes written so far. */
+    size_t written;
+
+    /** Set if a write to the file failed. */
+    bool failed;
+};
+
+/**
+ * Helper function to write the buffered bytes to the file.
+ * @param out - The writer. Passed by reference.
+ */
+static void flush(SnapshotWriter &out) {
+    const char* data = out.buffer.data();
+    size_t length = out.buffer.size();
+
+    while (length > 0 && !out.failed) {
+        ssize_t count = ::write(out.fd, data, length);
+        if (count < 0) {
+            out.failed = true;
+        } else {
+            data += count;
+            length -= count;
+        }
+    }
+    out.buffer.clear();
+}
+
+/**
+ * Helper function to add bytes to the snapshot.
+ * @param out - The writer. Passed by reference.
+ * @param data - The bytes to add.
+ * @param length - The number of bytes.
+ */
+static void put(SnapshotWriter &out, const void* data, size_t length) {
+    if (out.buffer.size() + length > BUFFER_SIZE) {
+        flush(out);
+    }
+    const char* bytes = static_cast<const char*> (data);
+    out.buffer.insert(out.buffer.end(), bytes, bytes + length);
+    out.written += length;
+}
+
+/**
+ * Helper function to add a one byte tag to the snapshot.
+ * @param out - The writer. Passed by reference.
+ * @param tag - The tag.
+ */
+static void putTag(SnapshotWriter &out, char tag) {
+    put(out, &tag, 1);
+}
+
+/**
+ * Helper function to add a string to the snapshot, as its length followed by its characters.
+ * @param out - The writer. Passed by reference.
+ * @param text - The string, which may be NULL for an empty string.
+ */
+static void putString(SnapshotWriter &out, const XMLCh* text) {
+    unsigned int length = (text == NULL) ? 0 : XMLString::stringLen(text);
+    put(out, &length, sizeof (length));
+    put(out, text, length * sizeof (XMLCh));
+}
+
+/**
+ * Helper function to sync the directory holding a file, so that a file which
+ * was just renamed keeps its new name after a crash.
+ * @param fileName - The name of the file.
+ */
+static void syncDirectory(const string &fileName) {
+    string::size_type slash = fileName.rfind('/');
+    string directory = (slash == string::npos) ? "." : fileName.substr(0, slash);
+
+    int fd = ::open(directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+}
+
+/**
+ * Writes a snapshot of a document. The snapshot is written to a temporary
+ * file and synced to disk before taking the place of the old one, so a crash
+ * part way through leaves the old snapshot as it was.
+ * @param doc - The document to be saved.
+ * @param fileName - The name of the snapshot file.
+ * @param sequence - The number of the last logged command already in the tree.
+ * @return - The size of the snapshot in bytes, or 0 if it could not be written.
+ */
+size_t Snapshot::write(DOMDocument* doc, const string &fileName, unsigned long long sequence) {
+    string tempName = fileName + ".tmp";
+
+    SnapshotWriter out;
+    out.fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    out.written = 0;
+    out.failed = (out.fd < 0);
+    if (out.failed) {
+        return 0;
+    }
+    out.buffer.reserve(BUFFER_SIZE);
+
+    put(out, MAGIC, 8);
+    put(out, &sequence, sizeof (sequence));
+
+    // Walks the tree in document order, writing an 'e' each time the walk
+    // leaves an element.
+    DOMNode* node = doc->getFirstChild();
+    while (node != NULL) {
+        switch (node->getNodeType()) {
+            case DOMNode::ELEMENT_NODE:
+            {
+                putTag(out, 'E');
+                putString(out, node->getNodeName());
+
+                DOMNamedNodeMap* attributes = node->getAttributes();
+                unsigned int nAttributes = (attributes == NULL) ? 0 : attributes->getLength();
+                put(out, &nAttributes, sizeof (nAttributes));
+                for (unsigned int i = 0; i < nAttributes; i++) {
+                    DOMAttr* attNode = static_cast<DOMAttr*> (attributes->item(i));
+                    putString(out, attNode->getName());
+                    putString(out, attNode->getValue());
+                }
+
+                if (node->getFirstChild() != NULL) {
+                    node = node->getFirstChild();
+                    continue;
+                }
+                putTag(out, 'e');
+                break;
+            }
+            case DOMNode::TEXT_NODE:
+                putTag(out, 'T');
+                putString(out, node->getNodeValue());
+                break;
+            case DOMNode::CDATA_SECTION_NODE:
+                putTag(out, 'D');
+                putString(out, node->getNodeValue());
+                break;
+            case DOMNode::COMMENT_NODE:
+                putTag(out, 'C');
+                putString(out, node->getNodeValue());
+                break;
+            case DOMNode::PROCESSING_INSTRUCTION_NODE:
+                putTag(out, 'P');
+                putString(out, node->getNodeName());
+                putString(out, node->getNodeValue());
+                break;
+            default:
+                // Document types and other nodes are not kept.
+                break;
+        }
+
+        // Moves on to the next sibling, closing each element the walk goes back up through.
+        while (node != NULL && node->getNextSibling() == NULL) {
+            node = node->getParentNode();
+            if (node == doc) {
+                node = NULL;
+            } else {
+                putTag(out, 'e');
+            }
+        }
+        if (node != NULL) {
+            node = node->getNextSibling();
+        }
+    }
+
+    putTag(out, 'Z');
+    flush(out);
+
+    // The new snapshot only takes the place of the old one once it is on disk.
+    bool ok = !out.failed && fsync(out.fd) == 0;
+    ::close(out.fd);
+    if (!ok || rename(tempName.c_str(), fileName.c_str()) != 0) {
+        unlink(tempName.c_str());
+        return 0;
+    }
+    syncDirectory(fileName);
+    return out.written;
+}
+
+/**
+ * Structure used to read a snapshot from memory.
+ */
+struct SnapshotReader {
+    /** The next byte to read. */
+    const char* pos;
+
+    /** The end of the snapshot. */
+    const char* end;
+};
+
+/**
+ * Helper function to take bytes from the snapshot.
+ * @param in - The reader. Passed by reference.
+ * @param data - Where the bytes are copied to.
+ * @param length - The number of bytes.
+ * @return - False if the snapshot ends first.
+ */
+static bool get(SnapshotReader &in, void* data, size_t length) {
+    if (static_cast<size_t> (in.end - in.pos) < length) {
+        return false;
+    }
+    memcpy(data, in.pos, length);
+    in.pos += length;
+    return true;
+}
+
+/**
+ * Helper function to take a string from the snapshot.
+ * @param in - The reader. Passed by reference.
+ * @param text - The null terminated string. Passed by reference.
+ * @return - False if the snapshot ends first.
+ */
+static bool getString(SnapshotReader &in, vector<XMLCh> &text) {
+    unsigned int length;
+    if (!get(in, &length, sizeof (length)) || static_cast<size_t> (in.end - in.pos) < length * sizeof (XMLCh)) {
+        return false;
+    }
+    text.resize(length + 1);
+    get(in, text.data(), length * sizeof (XMLCh));
+    text[length] = chNull;
+    return true;
+}
+
+/**
+ * Reads a snapshot into a new document.
+ * @param impl - The DOM implementation used to create the document.
+ * @param fileName - The name of the snapshot file.
+ * @param doc - The new document. Passed by reference.
+ * @param sequence - The number of the last logged command in the snapshot. Passed by reference.
+ * @return - False if there is no snapshot or it is not valid.
+ */
+bool Snapshot::read(DOMImplementation* impl, const string &fileName, DOMDocument* &doc, unsigned long long &sequence) {
+    FILE* file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        return false;
+    }
+
+    // The whole snapshot is read in one go.
+    vector<char> bytes;
+    char block[BUFFER_SIZE];
+    size_t count;
+    while ((count = fread(block, 1, sizeof (block), file)) > 0) {
+        bytes.insert(bytes.end(), block, block + count);
+    }
+    fclose(file);
+
+    SnapshotReader in;
+    in.pos = bytes.data();
+    in.end = bytes.data() + bytes.size();
+
+    char magic[8];
+    if (!get(in, magic, 8) || memcmp(magic, MAGIC, 8) != 0 || !get(in, &sequence, sizeof (sequence))) {
+        return false;
+    }
+
+    doc = impl->createDocument();
+    DOMNode* parent = doc;
+    vector<XMLCh> name;
+    vector<XMLCh> value;
+    bool valid = false;
+    char tag;
+
+    while (get(in, &tag, 1)) {
+        if (tag == 'Z') {
+            valid = (parent == doc);
+            break;
+        }
+
+        if (tag == 'E') {
+            unsigned int nAttributes;
+            if (!getString(in, name) || !get(in, &nAttributes, sizeof (nAttributes))) {
+                break;
+            }
+            DOMElement* elem = doc->createElement(name.data());
+            parent->appendChild(elem);
+
+            unsigned int i = 0;
+            for (; i < nAttributes && getString(in, name) && getString(in, value); i++) {
+                elem->setAttribute(name.data(), value.data());
+            }
+            if (i < nAttributes) {
+                break;
+            }
+            parent = elem;
+
+        } else if (tag == 'e') {
+            if (parent == doc) {
+                break;
+            }
+            parent = parent->getParentNode();
+
+        } else if (tag == 'P') {
+            if (!getString(in, name) || !getString(in, value)) {
+                break;
+            }
+            parent->appendChild(doc->createProcessingInstruction(name.data(), value.data()));
+
+        } else if (tag == 'T' || tag == 'D' || tag == 'C') {
+            if (!getString(in, value)) {
+                break;
+            }
+            if (tag == 'T') {
+                parent->appendChild(doc->createTextNode(value.data()));
+            } else if (tag == 'D') {
+                parent->appendChild(doc->createCDATASection(value.data()));
+            } else {
+                parent->appendChild(doc->createComment(value.data()));
+            }
+
+        } else {
+            break;
+        }
+    }
+
+    if (!valid) {
+        doc->release();
+        doc = NULL;
+    }
+    return valid;
+}
@@ -0,0 +1,64 @@
+/* File:   Snapshot.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the Snapshot class, which saves the whole DOM tree to a
+ * binary file and reads it back. It is used by the session log to recover the shell
+ * after a crash. Reading a snapshot does not need the XML parser: each node is
+ * stored as a one byte tag followed by its strings, each string being a length
+ * and the raw XMLCh characters, so the tree is rebuilt with one pass over the file.
+ *
+ *     Header  - The characters "A7SNAP01" and the number of the last logged
+ *               command already in the tree, as 8 bytes.
+ *     'E'     - An element: its name, the number of attributes, then the name
+ *               and value of each, then its children and finally an 'e'.
+ *     'T' 'D' - A text or CDATA section node and its content.
+ *     'C'     - A comment and its content.
+ *     'P'     - A processing instruction, its target and its data.
+ *     'Z'     - The end of the snapshot.
+ *
+ * Numbers and characters are stored in the byte order of the machine, since
+ * a snapshot is only read back by the shell which wrote it.
+ */
+
+#ifndef SNAPSHOT_H
+#define	SNAPSHOT_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <string>
+#include <vector>
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class Snapshot {
+public:
+
+    /**
+     * Writes a snapshot of a document. The snapshot is written to a temporary
+     * file and synced to disk before taking the place of the old one, so a crash
+     * part way through leaves the old snapshot as it was.
+     * @param doc - The document to be saved.
+     * @param fileName - The name of the snapshot file.
+     * @param sequence - The number of the last logged command already in the tree.
+     * @return - The size of the snapshot in bytes, or 0 if it could not be written.
+     */
+    static size_t write(DOMDocument* doc, const string &fileName, unsigned long long sequence);
+
+    /**
+     * Reads a snapshot into a new document.
+     * @param impl - The DOM implementation used to create the document.
+     * @param fileName - The name of the snapshot file.
+     * @param doc - The new document. Passed by reference.
+     * @param sequence - The number of the last logged command in the snapshot. Passed by reference.
+     * @return - False if there is no snapshot or it is not valid.
+     */
+    static bool read(DOMImplementation* impl, const string &fileName, DOMDocument* &doc, unsigned long long &sequence);
+};
+
+#endif	/* SNAPSHOT_H */
+
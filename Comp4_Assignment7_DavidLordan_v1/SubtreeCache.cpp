@@ -0,0 +1,163 @@
+/* File:   SubtreeCache.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the SubtreeCache class, which keeps the bytes
+ * written for large elements until something below them changes. Each entry holds
+ * its own bytes and the places its cached children are spliced in.
+ */
+
+#include "SubtreeCache.h"
+
+/**
+ * Custom constructor.
+ * @param nMinBytes - The fewest bytes of its own an element needs to be cached. Defaults to 256.
+ * @param nMaxBytes - The most bytes kept in total. Defaults to 256 MB.
+ */
+SubtreeCache::SubtreeCache(size_t nMinBytes, size_t nMaxBytes) {
+    minBytes = nMinBytes;
+    maxBytes = nMaxBytes;
+    totalBytes = 0;
+}
+
+/**
+ * Finds the entry of an element, if it was written at the same depth and
+ * after the same whitespace.
+ * @param elem - The element.
+ * @param level - The depth it is being written at.
+ * @param whiteSpace - The trailing whitespace of the text written before it.
+ * @return - The entry, or NULL if there is none which can be used.
+ */
+const CachedSubtree* SubtreeCache::find(const DOMNode* elem, unsigned int level, unsigned int whiteSpace) const {
+    if (entries.empty()) {
+        return NULL;
+    }
+
+    unordered_map<const DOMNode*, CachedSubtree>::const_iterator entry = entries.find(elem);
+    if (entry == entries.end() || entry->second.level != level || entry->second.enterWhiteSpace != whiteSpace) {
+        return NULL;
+    }
+    return &entry->second;
+}
+
+/**
+ * Checks if an element has an entry, whatever it was written after.
+ * @param elem - The element.
+ * @return - True if there is an entry.
+ */
+bool SubtreeCache::contains(const DOMNode* elem) const {
+    return !entries.empty() && entries.count(elem) > 0;
+}
+
+/**
+ * Checks if an element has enough bytes of its own to be kept, and if there is room for them.
+ * @param length - The number of bytes.
+ * @return - True if they should be kept.
+ */
+bool SubtreeCache::wants(size_t length) const {
+    return length >= minBytes && totalBytes + length <= maxBytes;
+}
+
+/**
+ * Makes a new entry for an element. Any entry it had is replaced, which
+ * drops the entries above it since they were spliced from the old one.
+ * @param elem - The element.
+ * @return - The entry, to be filled in. Its bytes are counted by 'added'.
+ */
+CachedSubtree& SubtreeCache::add(const DOMNode* elem) {
+    if (contains(elem)) {
+        invalidate(elem);
+    }
+    return entries[elem];
+}
+
+/**
+ * Counts the bytes of an entry which has been filled in.
+ * @param entry - The entry.
+ */
+void SubtreeCache::added(const CachedSubtree &entry) {
+    totalBytes += entry.bytes.size();
+}
+
+/**
+ * Writes an entry, along with the entries of its cached children, to a sink.
+ * @param entry - The entry.
+ * @param sink - The buffered output to which the bytes are written.
+ */
+void SubtreeCache::write(const CachedSubtree &entry, OutputSink &sink) const {
+    size_t written = 0;
+
+    // A child's entry is always there while its parent's is, since changing
+    // the child drops the parent's entry too.
+    for (size_t i = 0; i < entry.splices.size(); i++) {
+        sink.write(entry.bytes.data() + written, entry.splices[i].first - written);
+        write(entries.find(entry.splices[i].second)->second, sink);
+        written = entry.splices[i].first;
+    }
+    sink.write(entry.bytes.data() + written, entry.bytes.size() - written);
+}
+
+/**
+ * Drops the entries of a node which is about to change and of every element above it.
+ * @param node - The node.
+ */
+void SubtreeCache::invalidate(const DOMNode* node) {
+    // An element which is too small to be cached may still be inside one which
+    // is, so the whole chain up to the document is checked.
+    for (; node != NULL && !entries.empty(); node = node->getParentNode()) {
+        erase(node);
+    }
+}
+
+/**
+ * Drops the entries of every element in a subtree which is about to be released.
+ * @param node - The root of the subtree.
+ */
+void SubtreeCache::evict(const DOMNode* node) {
+    if (entries.empty() || node->getNodeType() != DOMNode::ELEMENT_NODE) {
+        return;
+    }
+
+    erase(node);
+    for (DOMNode* child = node->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        evict(child);
+    }
+}
+
+/**
+ * Drops every entry.
+ */
+void SubtreeCache::clear() {
+    entries.clear();
+    totalBytes = 0;
+}
+
+/**
+ * Gets the number of elements cached.
+ * @return - The number of entries.
+ */
+size_t SubtreeCache::size() const {
+    return entries.size();
+}
+
+/**
+ * Gets the number of bytes kept.
+ * @return - The number of bytes.
+ */
+size_t SubtreeCache::bytes() const {
+    return totalBytes;
+}
+
+/**
+ * Drops an entry, if there is one.
+ * @param elem - The element.
+ */
+void SubtreeCache::erase(const DOMNode* elem) {
+    unordered_map<const DOMNode*, CachedSubtree>::iterator entry = entries.find(elem);
+    if (entry != entries.end()) {
+        totalBytes -= entry->second.bytes.size();
+        entries.erase(entry);
+    }
+}
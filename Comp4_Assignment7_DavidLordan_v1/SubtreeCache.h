@@ -0,0 +1,167 @@
+/* File:   SubtreeCache.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the SubtreeCache class, which keeps the UTF-8 bytes the
+ * UTF8Writer wrote for each large element, so that printing or exporting a tree
+ * which has barely changed copies most of it from memory rather than walking it.
+ *
+ * An element's bytes are only the same when it is written at the same depth and
+ * after the same trailing whitespace, so both are kept with them. Each byte is kept
+ * once: an element's entry holds its own text with gaps where cached children go,
+ * and writing the entry fills each gap from the child's entry. Elements smaller
+ * than the minimum size are not kept on their own, but inside their parent's bytes.
+ *
+ * Whenever a node is changed, the journal invalidates it and every element above
+ * it, so an entry is only ever used while nothing below it has changed. Removed
+ * subtrees keep their entries, which are still right if they are put back, until
+ * they are released. Replacing the document clears the cache.
+ */
+
+#ifndef SUBTREECACHE_H
+#define	SUBTREECACHE_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "OutputSink.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+/**
+ * Structure storing the bytes written for one element.
+ */
+struct CachedSubtree {
+    /** The depth the element was written at. */
+    unsigned int level;
+
+    /** The trailing whitespace of the text written before the element. */
+    unsigned int enterWhiteSpace;
+
+    /** The trailing whitespace of the last text written inside the element. */
+    unsigned int exitWhiteSpace;
+
+    /** The number of new lines written. */
+    int lines;
+
+    /** The bytes written, less those of cached children. */
+    string bytes;
+
+    /** The position in 'bytes' of each cached child, in order. */
+    vector<pair<size_t, const DOMNode*> > splices;
+};
+
+class SubtreeCache {
+public:
+
+    /**
+     * Custom constructor.
+     * @param nMinBytes - The fewest bytes of its own an element needs to be cached. Defaults to 256.
+     * @param nMaxBytes - The most bytes kept in total. Defaults to 256 MB.
+     */
+    SubtreeCache(size_t nMinBytes = 256, size_t nMaxBytes = 1 << 28);
+
+    /**
+     * Finds the entry of an element, if it was written at the same depth and
+     * after the same whitespace.
+     * @param elem - The element.
+     * @param level - The depth it is being written at.
+     * @param whiteSpace - The trailing whitespace of the text written before it.
+     * @return - The entry, or NULL if there is none which can be used.
+     */
+    const CachedSubtree* find(const DOMNode* elem, unsigned int level, unsigned int whiteSpace) const;
+
+    /**
+     * Checks if an element has an entry, whatever it was written after.
+     * @param elem - The element.
+     * @return - True if there is an entry.
+     */
+    bool contains(const DOMNode* elem) const;
+
+    /**
+     * Checks if an element has enough bytes of its own to be kept, and if there is room for them.
+     * @param length - The number of bytes.
+     * @return - True if they should be kept.
+     */
+    bool wants(size_t length) const;
+
+    /**
+     * Makes a new entry for an element. Any entry it had is replaced, which
+     * drops the entries above it since they were spliced from the old one.
+     * @param elem - The element.
+     * @return - The entry, to be filled in. Its bytes are counted by 'added'.
+     */
+    CachedSubtree& add(const DOMNode* elem);
+
+    /**
+     * Counts the bytes of an entry which has been filled in.
+     * @param entry - The entry.
+     */
+    void added(const CachedSubtree &entry);
+
+    /**
+     * Writes an entry, along with the entries of its cached children, to a sink.
+     * @param entry - The entry.
+     * @param sink - The buffered output to which the bytes are written.
+     */
+    void write(const CachedSubtree &entry, OutputSink &sink) const;
+
+    /**
+     * Drops the entries of a node which is about to change and of every element above it.
+     * @param node - The node.
+     */
+    void invalidate(const DOMNode* node);
+
+    /**
+     * Drops the entries of every element in a subtree which is about to be released.
+     * @param node - The root of the subtree.
+     */
+    void evict(const DOMNode* node);
+
+    /**
+     * Drops every entry.
+     */
+    void clear();
+
+    /**
+     * Gets the number of elements cached.
+     * @return - The number of entries.
+     */
+    size_t size() const;
+
+    /**
+     * Gets the number of bytes kept.
+     * @return - The number of bytes.
+     */
+    size_t bytes() const;
+
+private:
+
+    /**
+     * Drops an entry, if there is one.
+     * @param elem - The element.
+     */
+    void erase(const DOMNode* elem);
+
+    /** The entry of each cached element. */
+    unordered_map<const DOMNode*, CachedSubtree> entries;
+
+    /** The fewest bytes of its own an element needs to be cached. */
+    size_t minBytes;
+
+    /** The most bytes kept in total. */
+    size_t maxBytes;
+
+    /** The number of bytes kept. */
+    size_t totalBytes;
+};
+
+#endif	/* SUBTREECACHE_H */
+
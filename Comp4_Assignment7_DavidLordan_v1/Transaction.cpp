@@ -0,0 +1,94 @@
+/* File:   Transaction.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the implementation file for the Transaction class, which groups a run of editing
+ * commands between 'begin' and 'commit'. Each command still changes the tree as
+ * soon as it is entered, but the lookup index only notes the changes and sorts
+ * them in when a name is next looked up or at the commit. The messages the
+ * commands would print are collected and printed together at the commit.
+ */
+
+#include "Transaction.h"
+
+/**
+ * Standard constructor. No transaction is open to start with.
+ */
+Transaction::Transaction() {
+    open = false;
+    commands = 0;
+    console = NULL;
+}
+
+/**
+ * Opens a transaction.
+ * @param index - The lookup index, whose updates are deferred until the commit.
+ */
+void Transaction::begin(NodeIndex &index) {
+    if (open) {
+        cout << "A transaction is already open. Use 'commit' to close it." << endl;
+        return;
+    }
+
+    index.deferUpdates();
+    open = true;
+    commands = 0;
+    messages.str("");
+    started = chrono::steady_clock::now();
+
+    cout << "Started a transaction. Changes are made as they are entered and "
+            "reported on 'commit'." << endl;
+}
+
+/**
+ * Closes the open transaction, applying the deferred index updates and
+ * printing the messages of every command in it.
+ * @param index - The lookup index.
+ */
+void Transaction::commit(NodeIndex &index) {
+    if (!open) {
+        cout << "There is no open transaction. Use 'begin' to start one." << endl;
+        return;
+    }
+
+    index.applyUpdates();
+    open = false;
+
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - started;
+
+    // The collected messages are written in one go.
+    cout << messages.str();
+    cout << "Committed " << commands << " commands in " << elapsed.count() << " seconds." << endl;
+    messages.str("");
+}
+
+/**
+ * Checks if a transaction is open.
+ * @return - True between 'begin' and 'commit'.
+ */
+bool Transaction::isOpen() const {
+    return open;
+}
+
+/**
+ * Called before an editing command. If a transaction is open the messages
+ * printed by the command are collected instead of shown.
+ */
+void Transaction::startCommand() {
+    if (open) {
+        commands++;
+        console = cout.rdbuf(messages.rdbuf());
+    }
+}
+
+/**
+ * Called after an editing command, to show messages on the console again.
+ */
+void Transaction::endCommand() {
+    if (console != NULL) {
+        cout.rdbuf(console);
+        console = NULL;
+    }
+}
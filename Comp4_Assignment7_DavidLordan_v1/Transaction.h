@@ -0,0 +1,81 @@
+/* File:   Transaction.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ *
+ * This is the header file for the Transaction class, which groups a run of editing
+ * commands between 'begin' and 'commit'. Each command still changes the tree as
+ * soon as it is entered, but the lookup index only notes the changes and sorts
+ * them in when a name is next looked up or at the commit. The messages the
+ * commands would print are collected and printed together at the commit.
+ */
+
+#ifndef TRANSACTION_H
+#define	TRANSACTION_H
+
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include "NodeIndex.h"
+
+using namespace std;
+
+class Transaction {
+public:
+
+    /**
+     * Standard constructor. No transaction is open to start with.
+     */
+    Transaction();
+
+    /**
+     * Opens a transaction.
+     * @param index - The lookup index, whose updates are deferred until the commit.
+     */
+    void begin(NodeIndex &index);
+
+    /**
+     * Closes the open transaction, applying the deferred index updates and
+     * printing the messages of every command in it.
+     * @param index - The lookup index.
+     */
+    void commit(NodeIndex &index);
+
+    /**
+     * Checks if a transaction is open.
+     * @return - True between 'begin' and 'commit'.
+     */
+    bool isOpen() const;
+
+    /**
+     * Called before an editing command. If a transaction is open the messages
+     * printed by the command are collected instead of shown.
+     */
+    void startCommand();
+
+    /**
+     * Called after an editing command, to show messages on the console again.
+     */
+    void endCommand();
+
+private:
+
+    /** Set between 'begin' and 'commit'. */
+    bool open;
+
+    /** The number of editing commands in the open transaction. */
+    int commands;
+
+    /** The messages collected from the commands in the open transaction. */
+    ostringstream messages;
+
+    /** The console output, kept while the messages of a command are collected. */
+    streambuf* console;
+
+    /** The time at which the open transaction started. */
+    chrono::steady_clock::time_point started;
+};
+
+#endif	/* TRANSACTION_H */
+
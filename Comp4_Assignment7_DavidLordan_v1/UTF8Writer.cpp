@@ -0,0 +1,676 @@
+/* File:   UTF8Writer.cpp
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ * 
+ * This is the implementation file for the UTF8Writer class, which writes a DOM structure
+ * as UTF-8 XML without going through the Xerces serializer. The tree is walked
+ * once and each name and value is converted from the Xerces UTF-16 strings straight
+ * into the buffer of an OutputSink. When pretty printing, the output follows the
+ * same layout rules as the Xerces serializer, so that the two produce the same bytes.
+ * 
+ * Only documents, elements and text are written this way. Any other type of node,
+ * such as a comment or a DTD, is left to the Xerces serializer.
+ *
+ * When a view is passed, children, names and attributes are read through it rather
+ * than from the nodes, and the view is told about every node so it can hand the tree
+ * back to the shell between nodes.
+ *
+ * While writing with a cache, every byte is also collected in a pending buffer. When
+ * an element ends, its bytes are moved into the cache if there are enough of them,
+ * leaving a splice in its parent's bytes, or are left in place for its parent.
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include "UTF8Writer.h"
+
+
+/**
+ * Tables marking which ASCII characters are escaped in names, in element content
+ * and in attribute values. These match the Xerces 'NoEscapes', 'CharEscapes' and
+ * 'AttrEscapes'.
+ */
+static bool noEscapes[128];
+static bool charEscapes[128];
+static bool attrEscapes[128];
+
+/**
+ * Fills the escape tables the first time a writer is created. 
+ */
+static void buildEscapeTables() {
+    static bool built = false;
+
+    if (!built) {
+        charEscapes['&'] = charEscapes['<'] = charEscapes['>'] = charEscapes['\r'] = true;
+        attrEscapes['&'] = attrEscapes['<'] = attrEscapes['"'] = true;
+        attrEscapes['\n'] = attrEscapes['\r'] = attrEscapes['\t'] = true;
+        built = true;
+    }
+}
+
+/**
+ * Custom constructor. 
+ * @param bPrettyPrint - Whether new lines and indentation are added, as with
+ *                       the Xerces 'format-pretty-print' parameter. Defaults to true.
+ */
+UTF8Writer::UTF8Writer(bool bPrettyPrint) {
+    prettyPrint = bPrettyPrint;
+    currentLine = 0;
+    lastWhiteSpace = 0;
+    out = NULL;
+    view = NULL;
+    skipped = false;
+    cache = NULL;
+    capturing = false;
+    buildEscapeTables();
+}
+
+/**
+ * Sets whether new lines and indentation are added. 
+ * @param bPrettyPrint - True to pretty print the output.
+ */
+void UTF8Writer::setPrettyPrint(bool bPrettyPrint) {
+    if (cache != NULL && prettyPrint != bPrettyPrint) {
+        cache->clear();
+    }
+    prettyPrint = bPrettyPrint;
+}
+
+/**
+ * Sets the cache which keeps the bytes written for large elements. It is not
+ * used when the tree is read through a view.
+ * @param nCache - The cache, or NULL for none.
+ */
+void UTF8Writer::setCache(SubtreeCache* nCache) {
+    cache = nCache;
+}
+
+/**
+ * Gets the document a node belongs to.
+ * @param node - The node, which may be the document itself.
+ * @return - The document, or NULL if the node is not in one.
+ */
+static const DOMDocument* documentOf(const DOMNode* node) {
+    if (node->getNodeType() == DOMNode::DOCUMENT_NODE) {
+        return static_cast<const DOMDocument*> (node);
+    }
+    return node->getOwnerDocument();
+}
+
+/**
+ * Checks that every node below the passed node is a type this writer supports,
+ * and that its document is written as UTF-8 XML 1.0. 
+ * Elements in the cache were written before, so they are not checked again.
+ * @param node - The node to be written. 
+ * @return - False if the Xerces serializer must be used instead.
+ */
+bool UTF8Writer::canWrite(const DOMNode* node) const {
+    const DOMDocument* doc = documentOf(node);
+    return (doc == NULL || canWriteDocument(doc)) && canWriteNodes(node);
+}
+
+/**
+ * Checks that a document is written by the Xerces serializer as UTF-8 XML 1.0,
+ * which is the only output this writer produces. The serializer takes the
+ * encoding from the document it was read from, and escapes text differently
+ * for XML 1.1.
+ * @param doc - The document.
+ * @return - False if the Xerces serializer must be used instead.
+ */
+bool UTF8Writer::canWriteDocument(const DOMDocument* doc) {
+    const XMLCh* version = doc->getXmlVersion();
+    if (version != NULL && *version != 0 && !XMLString::equals(version, XMLUni::fgVersion1_0)) {
+        return false;
+    }
+
+    // The serializer uses the encoding the document was read in, or else the one
+    // its declaration named, and only writes UTF-8 for a document with neither.
+    const XMLCh* encoding = doc->getInputEncoding();
+    if (encoding == NULL || *encoding == 0) {
+        encoding = doc->getXmlEncoding();
+    }
+    return encoding == NULL || *encoding == 0 || XMLString::equals(encoding, XMLUni::fgUTF8EncodingString);
+}
+
+/**
+ * Checks that every node below the passed node is a type this writer supports. 
+ * Elements in the cache were written before, so they are not checked again.
+ * @param node - The node to be written. 
+ * @return - False if the Xerces serializer must be used instead.
+ */
+bool UTF8Writer::canWriteNodes(const DOMNode* node) const {
+    switch (node->getNodeType()) {
+        case DOMNode::DOCUMENT_NODE:
+        case DOMNode::ELEMENT_NODE:
+            if (cache != NULL && cache->contains(node)) {
+                return true;
+            }
+            for (DOMNode* child = node->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+                if (!canWriteNodes(child)) {
+                    return false;
+                }
+            }
+            return true;
+
+        case DOMNode::TEXT_NODE:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Writes a node and all of its children to a sink. 
+ * @param node - The document or element to be written. 
+ * @param xmlDeclaration - Whether a document starts with the XML declaration.
+ * @param sink - The buffered output to which the XML is written. 
+ * @param nView - The view the tree is read through, with its lock held, or
+ *                NULL to read the tree directly. Defaults to NULL.
+ * @return - False if a node of a type this writer does not support was skipped.
+ */
+bool UTF8Writer::write(const DOMNode* node, bool xmlDeclaration, OutputSink &sink, CopyOnWriteView* nView) {
+    const DOMDocument* doc = documentOf(node);
+    if (doc != NULL && !canWriteDocument(doc)) {
+        return false;
+    }
+
+    out = &sink;
+    view = nView;
+    currentLine = 0;
+    lastWhiteSpace = 0;
+    skipped = false;
+    capturing = false;
+
+    if (xmlDeclaration && node->getNodeType() == DOMNode::DOCUMENT_NODE) {
+        writeDeclaration(doc);
+    }
+    capturing = (cache != NULL && view == NULL);
+    processNode(node, 0);
+
+    // Bytes outside any cached element are only needed while it is written.
+    pending.clear();
+    pendingSplices.clear();
+    capturing = false;
+    out = NULL;
+    view = NULL;
+    return !skipped;
+}
+
+/**
+ * Writes the start of a document up to the end of the root's start tag, for a
+ * document whose root's children are written separately by 'writeChildren',
+ * such as on several threads at once.
+ * @param root - The root element, which must have children.
+ * @param xmlDeclaration - Whether the document starts with the XML declaration.
+ * @param sink - The buffered output to which the XML is written. 
+ */
+void UTF8Writer::writeHead(const DOMNode* root, bool xmlDeclaration, OutputSink &sink) {
+    out = &sink;
+    currentLine = 0;
+    lastWhiteSpace = 0;
+    capturing = false;
+
+    if (xmlDeclaration) {
+        writeDeclaration(root->getOwnerDocument());
+    }
+    writeStartTag(root, 0);
+    put('>');
+    out = NULL;
+}
+
+/**
+ * Writes a run of the root's children exactly as they appear when the whole
+ * document is written. 
+ * @param children - The children, in order.
+ * @param count - The number of children.
+ * @param whiteSpace - The 'trailingWhiteSpace' of the child before the first,
+ *                     or 0 for the root's first child.
+ * @param sink - The buffered output to which the XML is written. 
+ * @return - False if a node of a type this writer does not support was skipped.
+ */
+bool UTF8Writer::writeChildren(const DOMNode* const* children, size_t count, unsigned int whiteSpace, OutputSink &sink) {
+    out = &sink;
+    currentLine = 0;
+    lastWhiteSpace = whiteSpace;
+    skipped = false;
+    capturing = false;
+
+    for (size_t i = 0; i < count; i++) {
+        processNode(children[i], 1);
+    }
+
+    out = NULL;
+    return !skipped;
+}
+
+/**
+ * Writes the end of a document after the root's last child. 
+ * @param root - The root element.
+ * @param sink - The buffered output to which the XML is written. 
+ */
+void UTF8Writer::writeTail(const DOMNode* root, OutputSink &sink) {
+    out = &sink;
+    lastWhiteSpace = 0;
+    capturing = false;
+
+    // The end tag has a line of its own if any child is an element, since
+    // each element starts on a new line.
+    bool ownLine = false;
+    for (DOMNode* child = root->getFirstChild(); child != NULL && prettyPrint; child = child->getNextSibling()) {
+        if (child->getNodeType() == DOMNode::ELEMENT_NODE) {
+            ownLine = true;
+            break;
+        }
+    }
+    writeEndTag(root, 0, ownLine);
+    printNewLine();
+    out = NULL;
+}
+
+/**
+ * Gets the number of spaces a node leaves to count towards the indentation of
+ * whatever is written after it, as 'lastWhiteSpace' would be once it is written.
+ * @param node - The node.
+ * @return - The number of spaces.
+ */
+unsigned int UTF8Writer::trailingWhiteSpace(const DOMNode* node) const {
+    if (!prettyPrint) {
+        return 0;
+    }
+
+    if (node->getNodeType() == DOMNode::TEXT_NODE) {
+        return trailingSpaces(node->getNodeValue());
+    }
+
+    // An element's end tag is indented on its own line, using up the spaces, if
+    // it has any element children. Otherwise its last text is what is left.
+    unsigned int spaces = 0;
+    for (DOMNode* child = node->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        if (child->getNodeType() == DOMNode::ELEMENT_NODE) {
+            return 0;
+        }
+        spaces = trailingWhiteSpace(child);
+    }
+    return spaces;
+}
+
+/**
+ * Writes the XML declaration the Xerces serializer writes for a document,
+ * with the version and standalone flag of the document.
+ * @param doc - The document.
+ */
+void UTF8Writer::writeDeclaration(const DOMDocument* doc) {
+    const XMLCh* version = doc->getXmlVersion();
+
+    put("<?xml version=\"", 15);
+    writeText((version != NULL && *version != 0) ? version : XMLUni::fgVersion1_0, noEscapes);
+    put("\" encoding=\"UTF-8\" standalone=\"", 31);
+    if (doc->getXmlStandalone()) {
+        put("yes\" ?>", 7);
+    } else {
+        put("no\" ?>", 6);
+    }
+}
+
+/**
+ * Writes a single node, and recursively its children, in the same way as the
+ * Xerces serializer. 
+ * @param node - The node to be written.
+ * @param level - The depth of the node below the node being written.
+ */
+void UTF8Writer::processNode(const DOMNode* node, unsigned int level) {
+    if (view != NULL) {
+        view->visit();
+    }
+
+    switch (node->getNodeType()) {
+
+            // Elements start on a new line, with an extra blank line before those
+            // directly below the node being written. The end tag only gets its
+            // own line if the element's children took up more than one line.
+        case DOMNode::ELEMENT_NODE:
+        {
+            // An element which has not changed since it was last written at this
+            // depth, after the same whitespace, is copied from the cache.
+            size_t start = pending.size();
+            size_t spliceStart = pendingSplices.size();
+            int startLine = currentLine;
+            unsigned int startWhiteSpace = lastWhiteSpace;
+            if (capturing) {
+                const CachedSubtree* entry = cache->find(node, level, lastWhiteSpace);
+                if (entry != NULL) {
+                    cache->write(*entry, *out);
+                    currentLine += entry->lines;
+                    lastWhiteSpace = entry->exitWhiteSpace;
+                    pendingSplices.push_back(make_pair(start, node));
+                    break;
+                }
+            }
+
+            int nodeLine = writeStartTag(node, level);
+
+            DOMNode* child = getNextChild(node, NULL, 0);
+            if (child != NULL) {
+                put('>');
+
+                for (size_t i = 1; child != NULL; i++) {
+                    processNode(child, level + 1);
+                    child = getNextChild(node, child, i);
+                }
+
+                writeEndTag(node, level, nodeLine != currentLine);
+            } else {
+                put("/>", 2);
+            }
+
+            if (capturing) {
+                keep(node, level, start, spliceStart, startLine, startWhiteSpace);
+            }
+            break;
+        }
+
+            // Text is written as it is, escaped. Any spaces following the last new
+            // line of the text count towards the indentation of the next line.
+        case DOMNode::TEXT_NODE:
+        {
+            const XMLCh* value = node->getNodeValue();
+
+            if (prettyPrint) {
+                lastWhiteSpace = trailingSpaces(value);
+            }
+            writeText(value, charEscapes);
+            break;
+        }
+
+            // The document's children are written at the same level, followed by a new line. 
+        case DOMNode::DOCUMENT_NODE:
+        {
+            DOMNode* child = getNextChild(node, NULL, 0);
+            for (size_t i = 1; child != NULL; i++) {
+                processNode(child, level);
+                child = getNextChild(node, child, i);
+            }
+            printNewLine();
+            break;
+        }
+
+        default:
+            skipped = true;
+            break;
+    }
+}
+
+/**
+ * Writes the new lines and indentation before an element, and its start tag
+ * without the closing bracket.
+ * @param elem - The element.
+ * @param level - The depth of the element.
+ * @return - The line the start tag is on.
+ */
+int UTF8Writer::writeStartTag(const DOMNode* elem, unsigned int level) {
+    if (level == 1) {
+        printNewLine();
+    }
+    printNewLine();
+    printIndent(level);
+
+    int nodeLine = currentLine;
+
+    put('<');
+    writeText(getName(elem), noEscapes);
+
+    if (view != NULL) {
+        for (XMLSize_t i = 0; i < view->getAttributeCount(elem); i++) {
+            put(' ');
+            writeText(view->getAttributeName(elem, i), noEscapes);
+            put("=\"", 2);
+            writeText(view->getAttributeValue(elem, i), attrEscapes);
+            put('"');
+        }
+    } else {
+        DOMNamedNodeMap* attributes = elem->getAttributes();
+        for (XMLSize_t i = 0; i < attributes->getLength(); i++) {
+            DOMNode* att = attributes->item(i);
+            put(' ');
+            writeText(att->getNodeName(), noEscapes);
+            put("=\"", 2);
+            writeText(att->getNodeValue(), attrEscapes);
+            put('"');
+        }
+    }
+    return nodeLine;
+}
+
+/**
+ * Writes the end tag of an element which has children.
+ * @param elem - The element.
+ * @param level - The depth of the element.
+ * @param ownLine - Set if its children took up more than one line, so the
+ *                  end tag goes on a line of its own.
+ */
+void UTF8Writer::writeEndTag(const DOMNode* elem, unsigned int level, bool ownLine) {
+    if (ownLine) {
+        printNewLine();
+        printIndent(level);
+    }
+    put("</", 2);
+    writeText(getName(elem), noEscapes);
+    put('>');
+}
+
+/**
+ * Counts the spaces following the last new line of a text value, which count
+ * towards the indentation of the next line.
+ * @param value - The text.
+ * @return - The number of spaces, or 0 if the text does not end with a new
+ *           line followed by spaces.
+ */
+unsigned int UTF8Writer::trailingSpaces(const XMLCh* value) {
+    XMLSize_t count = XMLString::stringLen(value);
+    XMLSize_t i = count;
+    while (i > 0 && value[i - 1] == chSpace) {
+        i--;
+    }
+    if (i > 0 && i < count && value[i - 1] == chLF) {
+        return (unsigned int) (count - i);
+    }
+    return 0;
+}
+
+/**
+ * Gets the next child of a node, through the view if there is one.
+ * @param parent - The node whose children are being written.
+ * @param previous - The child written before this one, or NULL for the first child.
+ * @param position - The number of children written so far.
+ * @return - The next child, or NULL if there are no more.
+ */
+DOMNode* UTF8Writer::getNextChild(const DOMNode* parent, const DOMNode* previous, size_t position) {
+    if (view != NULL) {
+        return view->getNextChild(parent, previous, position);
+    }
+    return (previous == NULL) ? parent->getFirstChild() : previous->getNextSibling();
+}
+
+/**
+ * Gets the name of a node, through the view if there is one.
+ * @param node - The node.
+ * @return - The name.
+ */
+const XMLCh* UTF8Writer::getName(const DOMNode* node) {
+    return (view != NULL) ? view->getName(node) : node->getNodeName();
+}
+
+/**
+ * Keeps the bytes just written for an element in the cache if there are enough
+ * of them, otherwise they stay part of its parent's bytes.
+ * @param elem - The element.
+ * @param level - The depth it was written at.
+ * @param start - The position of its bytes in 'pending'.
+ * @param spliceStart - The position of its cached children in 'pendingSplices'.
+ * @param startLine - The number of new lines written before it.
+ * @param startWhiteSpace - The trailing whitespace of the text written before it.
+ */
+void UTF8Writer::keep(const DOMNode* elem, unsigned int level, size_t start, size_t spliceStart,
+        int startLine, unsigned int startWhiteSpace) {
+    if (!cache->wants(pending.size() - start)) {
+        return;
+    }
+
+    CachedSubtree &entry = cache->add(elem);
+    entry.level = level;
+    entry.enterWhiteSpace = startWhiteSpace;
+    entry.exitWhiteSpace = lastWhiteSpace;
+    entry.lines = currentLine - startLine;
+    entry.bytes.assign(pending, start, string::npos);
+    entry.splices.assign(pendingSplices.begin() + spliceStart, pendingSplices.end());
+    for (size_t i = 0; i < entry.splices.size(); i++) {
+        entry.splices[i].first -= start;
+    }
+    cache->added(entry);
+
+    // The parent's bytes now hold a splice in place of the element's.
+    pending.resize(start);
+    pendingSplices.resize(spliceStart);
+    pendingSplices.push_back(make_pair(start, elem));
+}
+
+/**
+ * Adds text to the sink, and to the bytes being collected for the cache.
+ * @param text - The text to add.
+ * @param length - The number of characters of text to add.
+ */
+void UTF8Writer::put(const char* text, size_t length) {
+    out->write(text, length);
+    if (capturing) {
+        pending.append(text, length);
+    }
+}
+
+/**
+ * Adds a single character to the sink, and to the bytes being collected for the cache.
+ * @param c - The character to add.
+ */
+void UTF8Writer::put(char c) {
+    out->write(c);
+    if (capturing) {
+        pending += c;
+    }
+}
+
+/**
+ * Starts a new line when pretty printing. 
+ */
+void UTF8Writer::printNewLine() {
+    if (prettyPrint) {
+        currentLine++;
+        put('\n');
+    }
+}
+
+/**
+ * Adds two spaces per level when pretty printing, less any spaces already
+ * ending the previous text node. 
+ * @param level - The depth of the node being indented.
+ */
+void UTF8Writer::printIndent(unsigned int level) {
+    if (prettyPrint) {
+        if (lastWhiteSpace != 0) {
+            unsigned int indentLevel = lastWhiteSpace / 2;
+            lastWhiteSpace = 0;
+            level = (indentLevel >= level) ? 0 : level - indentLevel;
+        }
+        out->indent(level, 2);
+        if (capturing) {
+            pending.append(2 * level, ' ');
+        }
+    }
+}
+
+/**
+ * Converts a Xerces string to UTF-8 and adds it to the sink, replacing each
+ * character marked in the escape table with a reference.
+ * @param text - The Xerces string to write. 
+ * @param escapes - Table marking which ASCII characters must be escaped.
+ */
+void UTF8Writer::writeText(const XMLCh* text, const bool* escapes) {
+    if (text == NULL) {
+        return;
+    }
+
+    XMLSize_t length = XMLString::stringLen(text);
+    XMLSize_t i = 0;
+
+    // The text is converted into a small buffer which is passed to the sink whenever
+    // it fills, leaving room for the longest reference.
+    char chunk[512];
+    size_t used = 0;
+
+    while (i < length) {
+        if (used > sizeof (chunk) - 16) {
+            put(chunk, used);
+            used = 0;
+        }
+
+        // Four characters are checked at once. If all four are ASCII from '@' up,
+        // none of them can need escaping and each is copied as a single byte.
+        if (length - i >= 4) {
+            uint64_t four;
+            memcpy(&four, text + i, sizeof (four));
+            if ((four & 0xFF80FF80FF80FF80ULL) == 0
+                    && ((four + 0x0040004000400040ULL) & 0x0080008000800080ULL) == 0x0080008000800080ULL) {
+                chunk[used++] = (char) text[i];
+                chunk[used++] = (char) text[i + 1];
+                chunk[used++] = (char) text[i + 2];
+                chunk[used++] = (char) text[i + 3];
+                i += 4;
+                continue;
+            }
+        }
+
+        XMLCh c = text[i++];
+
+        if (c < 0x80) {
+            if (!escapes[c]) {
+                chunk[used++] = (char) c;
+            } else if (c == '&') {
+                memcpy(chunk + used, "&amp;", 5);
+                used += 5;
+            } else if (c == '<') {
+                memcpy(chunk + used, "&lt;", 4);
+                used += 4;
+            } else if (c == '>') {
+                memcpy(chunk + used, "&gt;", 4);
+                used += 4;
+            } else if (c == '"') {
+                memcpy(chunk + used, "&quot;", 6);
+                used += 6;
+            } else {
+                // Control characters are written as hexadecimal character references. 
+                used += snprintf(chunk + used, 16, "&#x%X;", (unsigned int) c);
+            }
+        } else if (c < 0x800) {
+            chunk[used++] = (char) (0xC0 | (c >> 6));
+            chunk[used++] = (char) (0x80 | (c & 0x3F));
+        } else if (c >= 0xD800 && c < 0xDC00 && i < length
+                && text[i] >= 0xDC00 && text[i] < 0xE000) {
+            // A surrogate pair is joined into a single four byte character. 
+            uint32_t cp = 0x10000 + (((uint32_t) c - 0xD800) << 10) + (text[i++] - 0xDC00);
+            chunk[used++] = (char) (0xF0 | (cp >> 18));
+            chunk[used++] = (char) (0x80 | ((cp >> 12) & 0x3F));
+            chunk[used++] = (char) (0x80 | ((cp >> 6) & 0x3F));
+            chunk[used++] = (char) (0x80 | (cp & 0x3F));
+        } else {
+            chunk[used++] = (char) (0xE0 | (c >> 12));
+            chunk[used++] = (char) (0x80 | ((c >> 6) & 0x3F));
+            chunk[used++] = (char) (0x80 | (c & 0x3F));
+        }
+    }
+
+    if (used > 0) {
+        put(chunk, used);
+    }
+}
@@ -0,0 +1,273 @@
+/* File:   UTF8Writer.h
+ * Author: David Lordan, UMass Lowell Computer Science
+ * david_lordan@student.uml.edu
+ *
+ * Created on October 19th, 2026.
+ * 
+ * This is the header file for the UTF8Writer class, which writes a DOM structure
+ * as UTF-8 XML without going through the Xerces serializer. The tree is walked
+ * once and each name and value is converted from the Xerces UTF-16 strings straight
+ * into the buffer of an OutputSink. When pretty printing, the output follows the
+ * same layout rules as the Xerces serializer, so that the two produce the same bytes.
+ * 
+ * Only documents, elements and text are written this way. Any other type of node,
+ * such as a comment or a DTD, is left to the Xerces serializer. So are documents
+ * which the serializer would not write as UTF-8 XML 1.0, such as one loaded from
+ * a file in another encoding.
+ *
+ * The tree may also be read through a CopyOnWriteView, which writes it as it was when
+ * the view was opened even while it is being changed on another thread.
+ *
+ * Given a SubtreeCache, the bytes written for each large element are kept, and an
+ * element which has not changed since it was last written at the same depth is
+ * copied from the cache rather than walked again.
+ */
+
+#ifndef UTF8WRITER_H
+#define	UTF8WRITER_H
+
+/* Includes the necessary Xerces libraries and standard libraries. */
+#include <xercesc/dom/DOM.hpp>
+#include "OutputSink.h"
+#include "CopyOnWriteView.h"
+#include "SubtreeCache.h"
+
+/* Uses the Xerces and std namespace.*/
+XERCES_CPP_NAMESPACE_USE
+        using namespace std;
+
+class UTF8Writer {
+public:
+
+    /**
+     * Custom constructor. 
+     * @param bPrettyPrint - Whether new lines and indentation are added, as with
+     *                       the Xerces 'format-pretty-print' parameter. Defaults to true.
+     */
+    UTF8Writer(bool bPrettyPrint = true);
+
+    /**
+     * Checks that every node below the passed node is a type this writer supports. 
+     * Elements in the cache were written before, so they are not checked again.
+     * @param node - The node to be written. 
+     * @return - False if the Xerces serializer must be used instead.
+     */
+    bool canWrite(const DOMNode* node) const;
+
+    /**
+     * Checks that a document is written by the Xerces serializer as UTF-8 XML 1.0,
+     * which is the only output this writer produces. The serializer takes the
+     * encoding from the document it was read from, and escapes text differently
+     * for XML 1.1.
+     * @param doc - The document.
+     * @return - False if the Xerces serializer must be used instead.
+     */
+    static bool canWriteDocument(const DOMDocument* doc);
+
+    /**
+     * Writes a node and all of its children to a sink. 
+     * @param node - The document or element to be written. 
+     * @param xmlDeclaration - Whether a document starts with the XML declaration.
+     * @param sink - The buffered output to which the XML is written. 
+     * @param nView - The view the tree is read through, with its lock held, or
+     *                NULL to read the tree directly. Defaults to NULL.
+     * @return - False if a node of a type this writer does not support was skipped.
+     */
+    bool write(const DOMNode* node, bool xmlDeclaration, OutputSink &sink, CopyOnWriteView* nView = NULL);
+
+    /**
+     * Writes the start of a document up to the end of the root's start tag, for a
+     * document whose root's children are written separately by 'writeChildren',
+     * such as on several threads at once.
+     * @param root - The root element, which must have children.
+     * @param xmlDeclaration - Whether the document starts with the XML declaration.
+     * @param sink - The buffered output to which the XML is written. 
+     */
+    void writeHead(const DOMNode* root, bool xmlDeclaration, OutputSink &sink);
+
+    /**
+     * Writes a run of the root's children exactly as they appear when the whole
+     * document is written. 
+     * @param children - The children, in order.
+     * @param count - The number of children.
+     * @param whiteSpace - The 'trailingWhiteSpace' of the child before the first,
+     *                     or 0 for the root's first child.
+     * @param sink - The buffered output to which the XML is written. 
+     * @return - False if a node of a type this writer does not support was skipped.
+     */
+    bool writeChildren(const DOMNode* const* children, size_t count, unsigned int whiteSpace, OutputSink &sink);
+
+    /**
+     * Writes the end of a document after the root's last child. 
+     * @param root - The root element.
+     * @param sink - The buffered output to which the XML is written. 
+     */
+    void writeTail(const DOMNode* root, OutputSink &sink);
+
+    /**
+     * Gets the number of spaces a node leaves to count towards the indentation of
+     * whatever is written after it, as 'lastWhiteSpace' would be once it is written.
+     * @param node - The node.
+     * @return - The number of spaces.
+     */
+    unsigned int trailingWhiteSpace(const DOMNode* node) const;
+
+    /**
+     * Sets whether new lines and indentation are added. 
+     * @param bPrettyPrint - True to pretty print the output.
+     */
+    void setPrettyPrint(bool bPrettyPrint);
+
+    /**
+     * Sets the cache which keeps the bytes written for large elements. It is not
+     * used when the tree is read through a view.
+     * @param nCache - The cache, or NULL for none.
+     */
+    void setCache(SubtreeCache* nCache);
+
+private:
+
+    /**
+     * Checks that every node below the passed node is a type this writer supports. 
+     * @param node - The node to be written. 
+     * @return - False if the Xerces serializer must be used instead.
+     */
+    bool canWriteNodes(const DOMNode* node) const;
+
+    /**
+     * Writes the XML declaration the Xerces serializer writes for a document,
+     * with the version and standalone flag of the document.
+     * @param doc - The document.
+     */
+    void writeDeclaration(const DOMDocument* doc);
+
+    /**
+     * Writes a single node, and recursively its children, in the same way as the
+     * Xerces serializer. 
+     * @param node - The node to be written.
+     * @param level - The depth of the node below the node being written.
+     */
+    void processNode(const DOMNode* node, unsigned int level);
+
+    /**
+     * Writes the new lines and indentation before an element, and its start tag
+     * without the closing bracket.
+     * @param elem - The element.
+     * @param level - The depth of the element.
+     * @return - The line the start tag is on.
+     */
+    int writeStartTag(const DOMNode* elem, unsigned int level);
+
+    /**
+     * Writes the end tag of an element which has children.
+     * @param elem - The element.
+     * @param level - The depth of the element.
+     * @param ownLine - Set if its children took up more than one line, so the
+     *                  end tag goes on a line of its own.
+     */
+    void writeEndTag(const DOMNode* elem, unsigned int level, bool ownLine);
+
+    /**
+     * Counts the spaces following the last new line of a text value, which count
+     * towards the indentation of the next line.
+     * @param value - The text.
+     * @return - The number of spaces, or 0 if the text does not end with a new
+     *           line followed by spaces.
+     */
+    static unsigned int trailingSpaces(const XMLCh* value);
+
+    /**
+     * Gets the next child of a node, through the view if there is one.
+     * @param parent - The node whose children are being written.
+     * @param previous - The child written before this one, or NULL for the first child.
+     * @param position - The number of children written so far.
+     * @return - The next child, or NULL if there are no more.
+     */
+    DOMNode* getNextChild(const DOMNode* parent, const DOMNode* previous, size_t position);
+
+    /**
+     * Gets the name of a node, through the view if there is one.
+     * @param node - The node.
+     * @return - The name.
+     */
+    const XMLCh* getName(const DOMNode* node);
+
+    /**
+     * Keeps the bytes just written for an element in the cache if there are enough
+     * of them, otherwise they stay part of its parent's bytes.
+     * @param elem - The element.
+     * @param level - The depth it was written at.
+     * @param start - The position of its bytes in 'pending'.
+     * @param spliceStart - The position of its cached children in 'pendingSplices'.
+     * @param startLine - The number of new lines written before it.
+     * @param startWhiteSpace - The trailing whitespace of the text written before it.
+     */
+    void keep(const DOMNode* elem, unsigned int level, size_t start, size_t spliceStart,
+            int startLine, unsigned int startWhiteSpace);
+
+    /**
+     * Adds text to the sink, and to the bytes being collected for the cache.
+     * @param text - The text to add.
+     * @param length - The number of characters of text to add.
+     */
+    void put(const char* text, size_t length);
+
+    /**
+     * Adds a single character to the sink, and to the bytes being collected for the cache.
+     * @param c - The character to add.
+     */
+    void put(char c);
+
+    /**
+     * Starts a new line when pretty printing. 
+     */
+    void printNewLine();
+
+    /**
+     * Adds two spaces per level when pretty printing, less any spaces already
+     * ending the previous text node. 
+     * @param level - The depth of the node being indented.
+     */
+    void printIndent(unsigned int level);
+
+    /**
+     * Converts a Xerces string to UTF-8 and adds it to the sink, replacing each
+     * character marked in the escape table with a reference.
+     * @param text - The Xerces string to write. 
+     * @param escapes - Table marking which ASCII characters must be escaped.
+     */
+    void writeText(const XMLCh* text, const bool* escapes);
+
+    /** Whether new lines and indentation are added. */
+    bool prettyPrint;
+
+    /** The number of new lines written so far. */
+    int currentLine;
+
+    /** The number of spaces ending the last text node, following a new line. */
+    unsigned int lastWhiteSpace;
+
+    /** The sink being written to. */
+    OutputSink* out;
+
+    /** The view the tree is read through, or NULL. */
+    CopyOnWriteView* view;
+
+    /** Set if a node of a type this writer does not support was skipped. */
+    bool skipped;
+
+    /** The cache of bytes written for large elements, or NULL. */
+    SubtreeCache* cache;
+
+    /** Set while the bytes written are collected for the cache. */
+    bool capturing;
+
+    /** The bytes written for elements which are still open, less those already cached. */
+    string pending;
+
+    /** The position in 'pending' of each cached element written inside an open element. */
+    vector<pair<size_t, const DOMNode*> > pendingSplices;
+};
+
+#endif	/* UTF8WRITER_H */
+
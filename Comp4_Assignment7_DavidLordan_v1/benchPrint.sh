@@ -0,0 +1,51 @@
+#!/bin/bash
+# File:   benchPrint.sh
+# Author: David Lordan, UMass Lowell Computer Science
+# david_lordan@student.uml.edu
+#
+# Created on October 19th, 2026.
+#
+# Times the shell printing a small tree over and over, which is mostly the cost
+# of setting up the output for each 'print' command. A root with 20 children,
+# each with an attribute, is built and then printed the passed number of times,
+# with the output sent to /dev/null. Each shell passed is timed on the same
+# commands, so an older build can be compared against the current one.
+#
+# Usage: ./benchPrint.sh <shell> [<shell> ...] [-n <prints>]
+#        The number of prints defaults to 100000.
+
+prints=100000
+shells=()
+while [ $# -gt 0 ]; do
+    if [ "$1" = "-n" ]; then
+        prints=$2
+        shift 2
+    else
+        shells+=("$1")
+        shift
+    fi
+done
+
+if [ ${#shells[@]} -eq 0 ]; then
+    echo "Usage: $0 <shell> [<shell> ...] [-n <prints>]" >&2
+    exit 1
+fi
+
+commands=$(mktemp)
+trap 'rm -f "$commands"' EXIT
+
+{
+    echo "add element null root hello"
+    for i in $(seq 1 20); do
+        echo "add element root c$i v$i"
+        echo "add attribute c$i a$i x$i"
+    done
+    yes print | head -n "$prints"
+    echo "quit"
+} > "$commands"
+
+TIMEFORMAT="%R s"
+for shell in "${shells[@]}"; do
+    echo -n "$shell, $prints prints: "
+    time "$shell" < "$commands" > /dev/null
+done
@@ -0,0 +1,47 @@
+#!/bin/bash
+# File:   checkDeclarations.sh
+# Author: David Lordan, UMass Lowell Computer Science
+# david_lordan@student.uml.edu
+#
+# Created on October 19th, 2026.
+#
+# Checks that a loaded file is exported with the same bytes as the Xerces
+# serializer writes for it, whatever its XML declaration. Each file in the
+# checkDeclarations folder is loaded into the shell and exported with 'export',
+# 'export parallel' and 'export background', and every export is compared with
+# the file's '.expected' output. The files differ only in their declarations:
+# none at all, standalone="yes", version 1.1 and ISO-8859-1.
+#
+# Usage: ./checkDeclarations.sh <shell>
+
+if [ $# -ne 1 ]; then
+    echo "Usage: $0 <shell>" >&2
+    exit 1
+fi
+
+shell=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+files=$(cd "$(dirname "$0")" && pwd)/checkDeclarations
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cd "$work" && mkdir dist
+
+failed=0
+for input in "$files"/*.xml; do
+    name=$(basename "$input" .xml)
+    printf 'load %s\nexport whole\nexport parallel shards 2\nexport background behind\nquit\n' "$input" \
+            | "$shell" > /dev/null
+
+    for export in whole shards behind; do
+        if ! cmp -s "$files/$name.expected" "dist/$export.xml"; then
+            echo "'export' of $name.xml as '$export' differs from $name.expected." >&2
+            failed=1
+        fi
+    done
+    rm -f dist/*
+done
+
+if [ $failed -eq 0 ]; then
+    echo "Every export matched the Xerces serializer."
+fi
+exit $failed
@@ -0,0 +1,68 @@
+#!/bin/bash
+# File:   checkShell.sh
+# Author: David Lordan, UMass Lowell Computer Science
+# david_lordan@student.uml.edu
+#
+# Created on October 19th, 2026.
+#
+# Checks the shell against the output it is expected to give. A tree is built
+# with the editing commands, printed, searched by name and by path, edited and
+# exported, and everything the shell prints, followed by the exported file, is
+# compared with checkShell.expected. The shell is run in an empty folder so no
+# session log or earlier export is picked up.
+#
+# Usage: ./checkShell.sh <shell>
+
+if [ $# -ne 1 ]; then
+    echo "Usage: $0 <shell>" >&2
+    exit 1
+fi
+
+shell=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+expected=$(cd "$(dirname "$0")" && pwd)/checkShell.expected
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+cd "$work" && mkdir dist
+
+"$shell" > output.txt <<'COMMANDS'
+add element null root hello
+add element root child1 c1
+add element root child2 c2
+add attribute child1 color red
+add attribute child1 size big
+add element child2 grand g
+print
+print list
+print list child1
+print child2
+rename element child2 kid2 newc
+rename attribute child1 color hue
+blue
+print list
+remove attribute child1 size
+remove element root kid2
+print list
+add element root a a1
+add element root b b1
+add element a b b2
+add attribute b id 7
+print /root/a
+print //b
+print (//b)[2]
+print //b[@id="7"]
+print list //nothere
+remove all element //b
+print
+export out1
+print list nothere
+quit
+COMMANDS
+cat dist/out1.xml >> output.txt
+
+if diff "$expected" output.txt; then
+    echo "The shell gave the expected output."
+else
+    echo "The shell output differs from checkShell.expected." >&2
+    exit 1
+fi
@@ -13,7 +13,7 @@
  * user various options for tree manipulation. All basic commands are parsed with
  * regular expressions to extract keywords and variable reflecting the meaning of the user's input. 
  * 
- * There are seven basic commands:
+ * There are fourteen basic commands:
  * 
  * Help: Displays a list of all basic commands, their use, and proper syntax. 
  * 
@@ -28,15 +28,52 @@
  *        command along with 'list' the tree is displayed in a custom format using the 'TreeWalker' class.
  * 
  * Export: Allows the user to export the entire DOM structure as an XML file with a specific name.
- *         The file is stored in the project's distribution folder.
+ *         The file is stored in the project's distribution folder. Using the export command
+ *         along with 'list' exports the tree, or a sub-tree, in the 'TreeWalker' format.
+ *         Using it along with 'background' writes the file on a worker thread while
+ *         other commands are entered, reading the tree through a copy-on-write view
+ *         so the file holds the tree as it was when the export started. Using it
+ *         along with 'parallel' splits the root's children between several threads,
+ *         and along with 'gzip' or 'zstd' compresses the file as it is written.
+ * 
+ * Add, remove and rename also have bulk forms, used by following the command with
+ * 'all', which act on every element matching a name or path at once. 
+ * 
+ * Begin and Commit: Group a run of editing commands. The changes are made straight
+ *       away, but the messages from each command are shown together on 'commit'.
+ * 
+ * Undo and Redo: Undo the last change to the tree, or redo the last change undone.
+ *       Every change is recorded in a journal, which keeps removed subtrees so
+ *       that they can be put back.
+ * 
+ * History: Lists the commands which made the current tree, which can be entered
+ *          again to rebuild it. 
+ * 
+ * Load: Allows the user to load an existing XML file in place of the current tree.
+ *       The file is read with the Xerces DOM parser, after which the index used by
+ *       the editing commands to find elements is built. 
+ * 
+ * Compact: Copies the tree into a new document and releases the old one, giving back
+ *          the memory kept by Xerces for removed nodes. Changes made before it
+ *          cannot be undone.
  * 
  * Quit: Exits the program. 
+ * 
+ * Every change to the tree is also written to a log in the distribution folder, along
+ * with a snapshot of the tree from time to time. If the program does not quit properly,
+ * the session is restored from them the next time it starts.
+ * 
+ * Xerces allocates its memory through an arena memory manager, which keeps blocks
+ * of a few sizes in large chunks. Starting the program with '--memory default' uses
+ * the default memory manager instead, and '--huge-pages' backs the arena with huge pages.
  */
 
 /* Includes the necessary Xerces libraries and Xerces namespace. */
 #include <xercesc/dom/DOM.hpp>
 #include <xercesc/framework/StdOutFormatTarget.hpp>
 #include <iostream>
+#include <sstream>
+#include <chrono>
 #include "xercesc/dom/DOMTreeWalker.hpp"
 
 #include <string.h>
@@ -45,6 +82,12 @@
 /*Inludes custom source files for various program functions.*/
 #include "outputOptions.h"
 #include "treeManipulation.h"
+#include "DocumentLoader.h"
+#include "Transaction.h"
+#include "Journal.h"
+#include "SessionLog.h"
+#include "ArenaMemoryManager.h"
+#include "BackgroundExport.h"
 
 /* Includes the boost regular expressions library*/
 #include <boost/regex.hpp>
@@ -64,7 +107,7 @@ XERCES_CPP_NAMESPACE_USE
 void parseInput(string input, string &command, string &selector, string &parentName, string &childOrAtt, string &contentOrVal) {
 
     //Creates a regEx used to check for basic commands. 
-    const boost::regex reBasic("(print|export|add|remove|help|rename|quit).*");
+    const boost::regex reBasic("(print|export|add|remove|help|rename|load|compact|begin|commit|undo|redo|history|quit).*");
 
     // Used to continue parsing if the basic command is valid. 
     bool valid = true;
@@ -82,23 +125,70 @@ void parseInput(string input, string &command, string &selector, string &parentN
         selector = what[1];
 
         if (selector.empty()) {
-            boost::regex reSubtreeRoot("print\\s(\\w*)");
+            boost::regex reSubtreeRoot("print\\s(\\S*)");
             boost::regex_search(input, what, reSubtreeRoot);
             parentName = what[1];
         } else {
-            boost::regex reSubtreeRoot("print\\slist\\s(\\w*)");
+            boost::regex reSubtreeRoot("print\\slist\\s(\\S*)");
             boost::regex_search(input, what, reSubtreeRoot);
             parentName = what[1];
         }
     }
 
     // Parses export command to extract a selector which will be used as a file name. 
+    // A file name following the 'list' keyword exports the tree in the list format,
+    // from an optional subtree root, and one following 'background' exports it on
+    // a worker thread. One following 'parallel' may be followed by a number of threads,
+    // and one following 'gzip' or 'zstd' exports a compressed file. 
     if (command == "export") {
-        boost::regex reExportFile("export\\s(\\w*).*");
-        boost::regex_search(input, what, reExportFile);
-        selector = what[1];
+        boost::regex reExportList("export\\slist\\s(\\w*)\\s?(\\S*).*");
+        boost::regex reExportBackground("export\\sbackground\\s(\\w*).*");
+        boost::regex reExportParallel("export\\sparallel\\s(\\w*)\\s?(\\S*).*");
+        boost::regex reExportCompressed("export\\s(gzip|zstd)\\s(\\w*).*");
+        if (boost::regex_search(input, what, reExportList)) {
+            selector = "list";
+            childOrAtt = what[1];
+            parentName = what[2];
+        } else if (boost::regex_search(input, what, reExportBackground)) {
+            selector = "background";
+            childOrAtt = what[1];
+        } else if (boost::regex_search(input, what, reExportParallel)) {
+            selector = "parallel";
+            childOrAtt = what[1];
+            contentOrVal = what[2];
+        } else if (boost::regex_search(input, what, reExportCompressed)) {
+            selector = what[1];
+            childOrAtt = what[2];
+        } else {
+            boost::regex reExportFile("export\\s(\\w*).*");
+            boost::regex_search(input, what, reExportFile);
+            selector = what[1];
+        }
     }
 
+    // Parses a load command for the file name, which may include a path, and
+    // the options which follow it.
+    if (command == "load") {
+        boost::regex reLoadFile("load\\s+(\\S+)(.*)");
+        if (boost::regex_search(input, what, reLoadFile)) {
+            childOrAtt = what[1];
+            contentOrVal = what[2];
+        }
+    }
+
+    // Parses the bulk forms of add, remove and rename, which act on every
+    // element matching a name or path. The command is changed to 'addall',
+    // 'removeall' or 'renameall' so it is not parsed again below.
+    if (command == "add" || command == "remove" || command == "rename") {
+        boost::regex reBulk("(add|remove|rename)\\sall\\s(element|attribute)\\s(\\S*)\\s?(\\w*)\\s?(\\w*).*");
+        if (boost::regex_search(input, what, reBulk)) {
+            command = what[1] + "all";
+            selector = what[2];
+            parentName = what[3];
+            childOrAtt = what[4];
+            contentOrVal = what[5];
+        }
+    }
 
     //Parses add, remove, and rename commands and extracts the necessary variables for each,
     // such as parent name, element or attribute selector, child or attribute name,
@@ -118,12 +208,14 @@ void parseInput(string input, string &command, string &selector, string &parentN
         }
 
         if (valid) {
-            boost::regex reParentNode(".*" + selector + "\\s(\\w*).*");
+            // The parent may be a path, so it is quoted with '\Q' and '\E' when
+            // used to find the name that follows it.
+            boost::regex reParentNode(".*" + selector + "\\s(\\S*).*");
             if (boost::regex_search(input, what, reParentNode)) {
                 parentName = what[1];
             }
 
-            boost::regex reChildOrAtt(".*" + parentName + "\\s(\\w*).*");
+            boost::regex reChildOrAtt(".*\\Q" + parentName + "\\E\\s(\\w*).*");
             if (boost::regex_search(input, what, reChildOrAtt)) {
                 childOrAtt = what[1];
             }
@@ -160,7 +252,7 @@ string getUserInput() {
         cin.ignore(-1);
 
         //Checks that the first word of the input is a valid basic command. 
-        const boost::regex reAdd("(add|print|quit|export|remove|rename|help).*");
+        const boost::regex reAdd("(add|print|quit|export|remove|rename|help|load|compact|begin|commit|undo|redo|history).*");
 
         if (boost::regex_match(input, reAdd)) {
             cont = false;
@@ -192,8 +284,9 @@ void clearVars(string &parentName, string &childOrAtt, string &contentOrVal) {
  * of the user's commands. Calls the appropriate function to match the basic command
  * given and passes it the necessary variables. When the loop is ended the program
  * terminates. 
+ * @param manager - The memory manager used by Xerces, or NULL for the default.
  */
-void userTree() {
+void userTree(MemoryManager* manager) {
 
     /**Strings which are used to store parsed user input. The are passed to most program
      functions by reference and are essentially global variables, though only defined in
@@ -206,8 +299,36 @@ void userTree() {
     string inputString = "";//Used to store command lines taken from the user
     string command = "";//Used to store the basic command taken from the user input
 
+    // Output context used to print and export the tree, created once and reused
+    // for every command.
+    OutputContext context;
+
+    // Loader used to read XML files, keeping its parser between loads, and the
+    // index used by the editing commands to find elements by name.
+    DocumentLoader loader;
+    NodeIndex index;
+
+    // Groups editing commands between 'begin' and 'commit'.
+    Transaction transaction;
+
+    // Records the changes to the tree so they can be undone.
+    Journal journal;
+
+    // Logs the changes to the tree so they can be recovered after a crash.
+    SessionLog session;
+
+    // Writes the tree on a worker thread. Every change recorded by the journal is
+    // passed to its view first, and the view is locked while a command runs.
+    BackgroundExport exporter;
+    CopyOnWriteView &view = exporter.getView();
+    journal.setView(&view);
+
+    // The bytes written for large elements are kept by the output context until
+    // the journal records a change below them.
+    journal.setCache(&context.getCache());
+
     // Starts the XML platform utilities, allow for the use of several Xerces features. 
-    XMLPlatformUtils::Initialize();
+    XMLPlatformUtils::Initialize(XMLUni::fgXercescDefaultLocale, 0, 0, manager);
 
     // Creates a DOM implementation object. Taken from the Xeces DOMPrint sample program.
     XMLCh tempStr[3] = {chLatin_L, chLatin_S, chNull};
@@ -216,30 +337,92 @@ void userTree() {
     //Creates an empty document which will store the DOM structure.
     DOMDocument* doc = impl->createDocument();
 
+    // Indexes the empty document, so that paths can be looked up in a tree
+    // built by the editing commands as well as one that was loaded.
+    index.build(doc);
+
+    // Restores the last session if it did not quit properly. The logged commands
+    // are entered again as if typed by the user, with their messages hidden.
+    string recovered;
+    istringstream replayInput;
+    ostringstream replayOutput;
+    streambuf* userInput = NULL;
+    streambuf* userOutput = NULL;
+    chrono::steady_clock::time_point replayStarted = chrono::steady_clock::now();
+
+    bool replaying = session.recover(impl, doc, index, recovered);
+    if (replaying) {
+        replayInput.str(recovered);
+        userInput = cin.rdbuf(replayInput.rdbuf());
+        userOutput = cout.rdbuf(replayOutput.rdbuf());
+    } else {
+        session.start(doc, journal);
+    }
+
     // Begins for loop which is the program cycle. 
     while (inputString != "quit") {
 
+        // Once the logged commands have been entered, input comes from the user again.
+        if (replaying) {
+            replayOutput.str("");
+            if (replayInput.peek() == EOF) {
+                cin.rdbuf(userInput);
+                cout.rdbuf(userOutput);
+                replaying = false;
+                session.start(doc, journal);
+
+                chrono::duration<double> elapsed = chrono::steady_clock::now() - replayStarted;
+                cout << "Restored the last session in " << elapsed.count() << " seconds." << endl;
+            }
+        }
+
+        // Reports a background export which has finished.
+        view.lock();
+        exporter.poll();
+        view.unlock();
+
         // Gets the user input.
         inputString = getUserInput();
 
+        // The tree is shared with any background export until the command is done.
+        view.lock();
         if (command != "quit") {
             // Parses the user input and extracts various pieces of information, such as the
             // new command, selector, and node information.
             parseInput(inputString, command, selector, parentName, childOrAtt, contentOrVal);
 
+            // Editing commands, and commands which replace the tree, are recorded
+            // in the journal.
+            bool editing = (command == "add" || command == "remove" || command == "rename"
+                    || command == "addall" || command == "removeall" || command == "renameall"
+                    || command == "load" || command == "compact");
+            DOMDocument* oldDoc = doc;
+            if (editing) {
+                journal.beginEntry(inputString);
+            }
+
+            // Inside a transaction the messages from editing commands are kept until
+            // the commit. Renaming an attribute asks the user for a value, so its
+            // messages are always shown.
+            if (command == "add" || command == "remove" || command == "addall"
+                    || command == "removeall" || command == "renameall"
+                    || (command == "rename" && selector == "element")) {
+                transaction.startCommand();
+            }
+
             // Applies the appropriate function the appropriate command.
             if (command == "add") {
                 // Checks if the user wishes to add a root element or basic element.
                 if (parentName == "null") {
-                    addRoot(doc, childOrAtt, contentOrVal);
+                    addRoot(doc, childOrAtt, contentOrVal, index, journal);
                 } else {
-                    addNode(doc, selector, parentName, childOrAtt, contentOrVal);
+                    addNode(doc, selector, parentName, childOrAtt, contentOrVal, index, journal);
                 }
             }
 
             //Calls the removeNode function 
             if (command == "remove") {
-                removeNode(doc, selector, parentName, childOrAtt);
+                removeNode(doc, selector, parentName, childOrAtt, index, journal);
             }
 
             // Checks if there is a root and thus a tree to print
@@ -250,9 +433,9 @@ void userTree() {
                 } else {
                     // Checks for selector type and calls the appropriate output format.
                     if (selector.empty()) {
-                        printTree(doc, parentName);
+                        printTree(doc, parentName, context, index);
                     } else if (selector == "list") {
-                        treeWalker(doc, parentName);
+                        treeWalker(doc, parentName, context.getSink(), index);
                     } else {
                         cout << "Print format must be specified as 'xml' or 'list'." << endl;
                     }
@@ -261,28 +444,134 @@ void userTree() {
 
             //Checks if there is a root and thus a tree to export
             if (command == "export") {
-                if (!doc->getFirstChild()) {
+                if (selector == "zstd" && !CompressedFile::isSupported(ZSTD_COMPRESSION)) {
+                    cout << "zstd support was not built in. Use 'export gzip' instead." << endl;
+                } else if (!doc->getFirstChild()) {
                     cout << "There is no tree to export. Must add a root first. " << endl;
+                } else if (selector == "list") {
+                    exportList(doc, childOrAtt, parentName, context.getSink(), index);
+                } else if (selector == "background") {
+                    exportInBackground(doc, childOrAtt, exporter, context);
+                } else if (selector == "parallel") {
+                    exportParallel(doc, childOrAtt, contentOrVal, context);
+                } else if (selector == "gzip") {
+                    exportTree(doc, childOrAtt, context, GZIP_COMPRESSION);
+                } else if (selector == "zstd") {
+                    exportTree(doc, childOrAtt, context, ZSTD_COMPRESSION);
                 } else {
-                    exportTree(doc, selector);
+                    exportTree(doc, selector, context);
                 }
             }
 
             if (command == "rename") {
-                renameNode(doc, selector, parentName, childOrAtt, contentOrVal);
+                renameNode(doc, selector, parentName, childOrAtt, contentOrVal, index, journal);
+            }
+
+            // Calls the bulk forms of the editing commands.
+            if (command == "addall") {
+                addAll(doc, selector, parentName, childOrAtt, contentOrVal, index, journal);
+            }
+
+            if (command == "removeall") {
+                removeAll(doc, selector, parentName, childOrAtt, index, journal);
+            }
+
+            if (command == "renameall") {
+                renameAll(doc, selector, parentName, childOrAtt, contentOrVal, index, journal);
+            }
+            transaction.endCommand();
+
+            // A transaction is a single entry in the journal.
+            if (command == "begin") {
+                if (!transaction.isOpen()) {
+                    journal.beginEntry(inputString);
+                }
+                transaction.begin(index);
+            }
+
+            if (command == "commit") {
+                if (transaction.isOpen()) {
+                    journal.addInput(inputString);
+                    journal.endEntry();
+                }
+                transaction.commit(index);
+            }
+
+            // The old tree is released by the commands which replace it, so any
+            // background export must finish first.
+            if ((command == "load" || command == "compact") && exporter.isRunning()) {
+                cout << "Waiting for the background export to finish." << endl;
+                exporter.wait();
+            }
+
+            // Replaces the tree with the contents of an XML file.
+            if (command == "load") {
+                LoadOptions options;
+                if (childOrAtt.empty()) {
+                    cout << "Must specify the name of the XML file to load." << endl;
+                } else if (DocumentLoader::parseOptions(contentOrVal, options)) {
+                    loader.load(doc, childOrAtt, options, index);
+                }
+            }
+
+            // Replaces the tree with a copy of itself in fresh memory.
+            if (command == "compact") {
+                compactTree(doc, index);
+            }
+
+            // Nothing before a command which replaced the tree can be undone.
+            if (editing) {
+                if (doc != oldDoc) {
+                    journal.recordReplace();
+                }
+                journal.endEntry();
+            }
+
+            if (command == "undo") {
+                journal.undo(index);
+            }
+
+            if (command == "redo") {
+                journal.redo(index);
+            }
+
+            if (command == "history") {
+                journal.writeHistory(cout);
             }
 
             if (command == "help") {
                 showHelp();
             }
+
+            // Logs any change made to the tree.
+            session.record(doc, journal, index);
         }
+        view.unlock();
 
         //Clears all variables on every loop cycle to avoid 'carry-over' from long commands to 
         // shorter ones
         clearVars(parentName, childOrAtt, contentOrVal);
     }
 
-    // Closes the XML platform utilities and informs the user that the program is quitting
+    // Commits any open transaction so its messages are shown.
+    if (transaction.isOpen()) {
+        journal.addInput("commit");
+        journal.endEntry();
+        transaction.commit(index);
+    }
+
+    // Finishes any background export before the tree is released.
+    view.lock();
+    exporter.wait();
+    view.unlock();
+
+    // The session ended properly, so there is nothing to recover.
+    session.finish();
+
+    // Releases the output context and the parser, then closes the XML platform utilities and informs
+    // the user that the program is quitting
+    context.release();
+    loader.release();
     XMLPlatformUtils::Terminate();
     cout << "Quitting Program." << endl;
 }
@@ -294,8 +583,27 @@ void userTree() {
  * @return - Returns error code if the program does not end properly. 
  */
 int main(int argC, char* argV[]) {
+
+    // Reads the memory manager options.
+    bool defaultMemory = false;
+    bool hugePages = false;
+    for (int i = 1; i < argC; i++) {
+        string arg = argV[i];
+        if (arg == "--memory" && i + 1 < argC && (string(argV[i + 1]) == "default" || string(argV[i + 1]) == "arena")) {
+            defaultMemory = (string(argV[++i]) == "default");
+        } else if (arg == "--huge-pages") {
+            hugePages = true;
+        } else {
+            cerr << "Usage: " << argV[0] << " [--memory <default|arena>] [--huge-pages]" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The arena must outlive the call to 'XMLPlatformUtils::Terminate'.
+    ArenaMemoryManager arena(hugePages);
+
     //User tree function which is the program cycle
-    userTree();
+    userTree(defaultMemory ? NULL : &arena);
 
     return 0;
 }
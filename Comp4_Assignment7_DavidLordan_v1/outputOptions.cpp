@@ -19,13 +19,16 @@
  */
 
 
-/**Includes basic libraries and the Xerces 'LocalFileFormatTarget' class for the 
- export function*/
+/**Includes basic libraries and the output context used by the print and export functions*/
 #include <string.h>
 #include <stdlib.h>
+#include <stdio.h>
+#include <limits.h>
 
 #include "outputOptions.h"
-#include <xercesc/framework/LocalFileFormatTarget.hpp>
+#include "OutputContext.h"
+#include "ParallelExport.h"
+#include <chrono>
 
 /* Includes the boost regular expressions library*/
 #include <boost/regex.hpp>
@@ -34,53 +37,125 @@ XERCES_CPP_NAMESPACE_USE
         using namespace std;
 
 /**
- * Function to export the DOM structure to an external XML file. This implementation
- * is virtually identical to the 'print' function which user the serializer.
+ * Function to export the DOM structure to an external XML file. The tree is written
+ * by the shell's output context, which is reused for every export.
  * @param doc - The DOMDocument that is to be exported.
  * @param fileName - The XML file name specified by the user
+ * @param context - The output context used to write the file. 
+ * @param compression - The way the file is compressed, which adds to its name. Defaults to none.
  */
-void exportTree(DOMDocument* doc, string fileName) {
+void exportTree(DOMDocument* doc, string fileName, OutputContext &context, Compression compression) {
     //Ensures that a file name was entered by the user
     if (fileName.empty()) {
         cout << "No file name was given. Enter a file name for the tree." << endl;
         getline(cin, fileName);
         cin.ignore(-1);
     }
-    // Gets the doc's implementation so that it may be used to create the serializer
-    DOMImplementation * impl = doc->getImplementation();
-    // Creates a DOM serializer which is used to call the 'write' function. 
-    DOMLSSerializer *theSerializer = ((DOMImplementationLS*) impl)->createLSSerializer();
-
-    // Formats the serializer's output. 
-    DOMLSOutput *theOutputDesc = ((DOMImplementationLS*) impl)->createLSOutput();
 
     //Creates a file path in the 'dist' folder from the file name
-    fileName = "dist/" + fileName + ".xml";
-    const char* xfileName = fileName.c_str();
-    XMLCh * filePath = XMLString::transcode(xfileName);
+    fileName = "dist/" + fileName + ".xml" + CompressedFile::extension(compression);
+
+    // Sends the context's output to the file until it is closed. A compressed
+    // file is compressed on another thread while the tree is being written.
+    OutputSink &sink = context.getSink();
+    if (!sink.open(fileName, compression)) {
+        cout << "Could not create the file '" << fileName << "'." << endl;
+        return;
+    }
+    context.writeXML(doc, doc, true);
+    if (!sink.close()) {
+        cout << "Could not write the file '" << fileName << "'." << endl;
+        return;
+    }
+
+    // Informs the user that the tree has been saved
+    cout << "Exported the DOM tree to '" << fileName << "'. " << endl;
 
-    // Uses the file path to create a serializer output destination
-    XMLFormatTarget *myFormTarget = new LocalFileFormatTarget(XMLString::transcode(filePath));
-    theOutputDesc->setByteStream(myFormTarget);
+}
 
-    //Assigns the serializer's print parameters. Allows for the the DOM structure
-    // to be printed in an easy to read XML format. 
-    DOMConfiguration* serializerConfig = theSerializer->getDomConfig();
-    serializerConfig->setParameter(XMLUni::fgDOMWRTFormatPrettyPrint, true);
-    serializerConfig->setParameter(XMLUni::fgDOMXMLDeclaration, true);
+/**
+ * Function to export the DOM structure to an external XML file on a worker thread,
+ * so the shell can keep changing the tree while it is written. The file holds the
+ * tree as it was when this function was called. Documents which only the Xerces
+ * serializer can write, such as one read in another encoding than UTF-8, are
+ * exported with 'exportTree' instead.
+ * @param doc - The DOMDocument that is to be exported.
+ * @param fileName - The XML file name specified by the user
+ * @param exporter - The background export which writes the file. 
+ * @param context - The output context used if the tree cannot be written in the background. 
+ */
+void exportInBackground(DOMDocument* doc, string fileName, BackgroundExport &exporter, OutputContext &context) {
+    //Ensures that a file name was entered by the user
+    if (fileName.empty()) {
+        cout << "No file name was given. Enter a file name for the tree." << endl;
+        getline(cin, fileName);
+        cin.ignore(-1);
+    }
 
-    // Function to print the DOM structure.
-    theSerializer->write(doc, theOutputDesc);
+    if (!UTF8Writer::canWriteDocument(doc)) {
+        cout << "The tree is not written as UTF-8 XML 1.0, so it is exported on this thread." << endl;
+        exportTree(doc, fileName, context);
+        return;
+    }
 
-    // Frees the memory allocated by the serializer and output DOM. 
-    theOutputDesc->release();
-    theSerializer->release();
-    myFormTarget->flush();
-    delete myFormTarget;
+    //Creates a file path in the 'dist' folder from the file name
+    fileName = "dist/" + fileName + ".xml";
 
-    // Informs the user that the tree has been saved
-    cout << "Exported the DOM tree to '" << fileName << "'. " << endl;
+    // Informs the user that the tree is being saved, which is reported again once it is done.
+    if (exporter.start(doc, fileName)) {
+        cout << "Exporting the DOM tree to '" << fileName << "' in the background." << endl;
+    }
+}
+
+/**
+ * Function to export the DOM structure to an external XML file on several threads,
+ * each writing a share of the root's children. Trees which cannot be split this way
+ * are exported with 'exportTree' instead.
+ * @param doc - The DOMDocument that is to be exported.
+ * @param fileName - The XML file name specified by the user
+ * @param threadCount - The number of threads specified by the user, or empty for one per core.
+ * @param context - The output context used if the tree cannot be split. 
+ */
+void exportParallel(DOMDocument* doc, string fileName, string threadCount, OutputContext &context) {
+    //Ensures that a file name was entered by the user
+    if (fileName.empty()) {
+        cout << "No file name was given. Enter a file name for the tree." << endl;
+        getline(cin, fileName);
+        cin.ignore(-1);
+    }
 
+    // The number of threads must be a whole number of at least one, if given.
+    unsigned long threads = 0;
+    if (!threadCount.empty()) {
+        char* end;
+        threads = strtoul(threadCount.c_str(), &end, 10);
+        if (threadCount.find_first_not_of("0123456789") != string::npos || *end != '\0' || threads < 1) {
+            cout << "The number of threads must be a whole number of at least one." << endl;
+            return;
+        }
+    }
+
+    //Creates a file path in the 'dist' folder from the file name
+    string filePath = "dist/" + fileName + ".xml";
+
+    ParallelExport exporter(threads > UINT_MAX ? UINT_MAX : (unsigned int) threads);
+    chrono::steady_clock::time_point started = chrono::steady_clock::now();
+    ParallelResult result = exporter.write(doc, filePath);
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - started;
+
+    if (result == PARALLEL_UNSUPPORTED) {
+        // Trees with other nodes than elements and text, or with nothing below the
+        // root to split, are written on this thread.
+        cout << "The tree cannot be split between threads, so it is exported on one thread." << endl;
+        exportTree(doc, fileName, context);
+    } else if (result == PARALLEL_FAILED) {
+        cout << "Could not write the file '" << filePath << "'." << endl;
+    } else {
+        // Informs the user that the tree has been saved
+        cout << "Exported the DOM tree to '" << filePath << "' in " << exporter.getShards()
+                << " shards on " << exporter.getThreads() << " threads in " << elapsed.count()
+                << " seconds." << endl;
+    }
 }
 
 /**
@@ -103,12 +178,67 @@ void showHelp() {
             "belonging to that node). If renaming an attribute the user will be "
             "prompted for the new attribute value." << endl << endl;
 
+    cout << "'add' all {element|attribute} parent_nodes {child_node|attribute_name} {content|value}: "
+            "Adds an element, or sets an attribute, on every element matching the name or path." << endl << endl;
+
+    cout << "'remove' all element nodes, or 'remove' all attribute nodes attribute_name: Removes every "
+            "element matching the name or path, or the attribute from every matching element." << endl << endl;
+
+    cout << "'rename' all element nodes new_name, or 'rename' all attribute nodes attribute_name "
+            "new_attribute: Renames every element matching the name or path, or the attribute of "
+            "every matching element. Content and values are kept." << endl << endl;
+
+    cout << "'begin' and 'commit': Group editing commands. Each change is made as it is entered, "
+            "and the messages from every command are shown together on 'commit'." << endl << endl;
+
+    cout << "'undo' and 'redo': Undoes the last change to the tree, or redoes the last change undone. "
+            "A bulk command or a transaction is undone as a whole. Changes made before a 'load' "
+            "or 'compact' cannot be undone." << endl << endl;
+
+    cout << "'history': Lists the commands which made the current tree. Entering them again "
+            "builds the same tree." << endl << endl;
+
     cout << "'print' {list} {subtree-root}: Displays the current tree in an XML format or as a simple"
             " list. Enter an optional existing node name to display a subtree from that node."
             " Default format is XML." << endl << endl;
 
+    cout << "Wherever an existing node name is expected, a path may be given instead, such as "
+            "'/root/child/grandchild', '//child[2]' for each 'child' which is the second 'child' "
+            "of its parent, '(//child)[2]' for the second 'child' in the tree, or "
+            "'//child[@att=\"value\"]' for the first 'child' with that attribute value." << endl << endl;
+
     cout << "'export' {file_name}: Export the tree as an external XML file. " << endl << endl;
 
+    // Compressing with zstd is only offered if the program was built with it.
+    if (CompressedFile::isSupported(ZSTD_COMPRESSION)) {
+        cout << "'export' gzip|zstd {file_name}: Export the tree as an external XML file compressed "
+                "with gzip or zstd. The file name ends in '.xml.gz' or '.xml.zst'." << endl << endl;
+    } else {
+        cout << "'export' gzip {file_name}: Export the tree as an external XML file compressed "
+                "with gzip. The file name ends in '.xml.gz'." << endl << endl;
+    }
+
+    cout << "'export' list {file_name} {subtree-root}: Export the tree, or a subtree, as "
+            "an external text file in the same format as 'print list'." << endl << endl;
+
+    cout << "'export' background {file_name}: Export the tree as an external XML file while "
+            "other commands are entered. The file holds the tree as it was when the export "
+            "started, and a message is shown once it has been written. Trees holding comments "
+            "or other nodes besides elements and text must use 'export'." << endl << endl;
+
+    cout << "'export' parallel {file_name} {threads}: Export the tree as an external XML file, "
+            "splitting the root's children between several threads. Uses one thread per core "
+            "unless a smaller number is given, and never more threads than the root has "
+            "children. The file is the same as with 'export'." << endl << endl;
+
+    cout << "'load' file_name {validate} {namespaces} {keepspace} {newparser}: Replaces "
+            "the tree with the contents of an existing XML file. Validation and namespaces "
+            "are off unless asked for, the whitespace between elements is removed unless "
+            "'keepspace' is given, and the parser is reused unless 'newparser' is given." << endl << endl;
+
+    cout << "'compact': Copies the tree into fresh memory, giving back the memory kept for "
+            "removed nodes, and reports how much was reclaimed." << endl << endl;
+
     cout << "'quit': Ends the program." << endl << endl;
 }
 
@@ -116,56 +246,34 @@ void showHelp() {
  * Function to print the tree in an XML format. If an element is provided, the
  * subtree from that element will be printed.
  * @param doc - The document whos structure is to be printed
- * @param subRoot - The element whose subtree is to be printed, default is the root
+ * @param subRoot - The element or path whose subtree is to be printed, default is the root
+ * @param context - The output context to which the tree is written. 
+ * @param index - The lookup index used to find the subtree root.
  */
-void printTree(DOMDocument* doc, string subRoot) {
-
-    // Gets the doc's implementation so that it may be used to create the serializer
-    DOMImplementation * impl = doc->getImplementation();
-
-    // Creates a DOM serializer which is used to call the 'write' function. 
-    DOMLSSerializer *theSerializer = ((DOMImplementationLS*) impl)->createLSSerializer();
-
-    // Formats the serializer's output. 
-    DOMLSOutput *theOutputDesc = ((DOMImplementationLS*) impl)->createLSOutput();
-    XMLFormatTarget *myFormTarget = new StdOutFormatTarget();
-    theOutputDesc->setByteStream(myFormTarget);
+void printTree(DOMDocument* doc, string subRoot, OutputContext &context, NodeIndex &index) {
 
-    //Assigns the serializer's print parameters. Allows for the the DOM structure
-    // to be printed in an easy to read XML format. 
-    DOMConfiguration* serializerConfig = theSerializer->getDomConfig();
-    serializerConfig->setParameter(XMLUni::fgDOMWRTFormatPrettyPrint, true);
-    serializerConfig->setParameter(XMLUni::fgDOMXMLDeclaration, false);
+    // The node to be printed, either the whole document or the subtree root. 
+    DOMNode * node = doc;
 
     //Checks if the tree is to be printed from the root
-    if (subRoot.empty()) {
-        // Function to print the DOM structure.
-        theSerializer->write(doc, theOutputDesc);
-
-    } else {
+    if (!subRoot.empty()) {
 
         // Confirms that the subRoot is an existing element
-        const char* xInput = subRoot.c_str();
-        XMLCh* xSubRoot = XMLString::transcode(xInput);
-        DOMNodeList * nodeList = doc->getElementsByTagName(xSubRoot);
+        node = index.find(subRoot);
 
-        if (nodeList->getLength() != 0) {
-
-            // If the subRoot exists its subtree is printed
-            DOMNode * subTreeRootNode = nodeList->item(0);
-            theSerializer->write(subTreeRootNode, theOutputDesc);
-            cout << endl;
-
-        } else {
+        if (node == NULL) {
             //If the specified element does not exist, the user is informed
             cout << "No matching node named '" << subRoot << "' found." << endl;
+            return;
         }
     }
 
-    // Frees the memory allocated by the serializer and output DOM. 
-    theOutputDesc->release();
-    theSerializer->release();
-    delete myFormTarget;
+    context.writeXML(doc, node, false);
+    context.getSink().flush();
+
+    if (node != doc) {
+        cout << endl;
+    }
 }
 
 /**
@@ -173,28 +281,26 @@ void printTree(DOMDocument* doc, string subRoot) {
  * @param attributes - a DOM map which contains a list of attribute names and values. 
  * @param level - The level on which an attribute's parent is located. Used for output
  *                formatting. 
+ * @param sink - The buffered output to which the attributes are written.
  */
-void displayAttributes(DOMNamedNodeMap* attributes, int level) {
-
-    // Tag to hold attribute names and values which then sent to 'transcode'.
-    const XMLCh * tag = NULL;
+void displayAttributes(DOMNamedNodeMap* attributes, int level, OutputSink &sink) {
 
     // For loop which displays each attribute found on a particular element. 
     for (XMLSize_t j = 0; j < attributes->getLength(); j++) {
         DOMNode * nextAtt = attributes->item(j);
 
         DOMAttr* att = dynamic_cast<DOMAttr*> (nextAtt);
-        tag = att->getName();
 
         // Output formatting. 
-        for (int i = 0; i <= (level - 1); i++) {
-            cout << "   ";
-        }
+        sink.indent(level);
 
-        cout << "Attribute " << (j + 1) << ": ";
-        cout << XMLString::transcode(tag);
-        tag = att->getValue();
-        cout << " = " << XMLString::transcode(tag) << endl;
+        sink.write("Attribute ", 10);
+        sink.writeNumber(j + 1);
+        sink.write(": ", 2);
+        sink.write(att->getName());
+        sink.write(" = ", 3);
+        sink.write(att->getValue());
+        sink.write('\n');
 
     }
 }
@@ -206,9 +312,12 @@ void displayAttributes(DOMNamedNodeMap* attributes, int level) {
  * user may provide an element name whose subtree will be printed. By default the
  * entire tree is displayed
  * @param doc - The DOM document containing the DOM structure. 
- * @param subRoot - The element whose subtree is to be displayed
+ * @param subRoot - The element or path whose subtree is to be displayed
+ * @param sink - The buffered output to which the tree is written. 
+ * @param index - The lookup index used to find the subtree root.
+ * @return - False if no element matching 'subRoot' was found.
  */
-void treeWalker(DOMDocument* doc, string subRoot) {
+bool treeWalker(DOMDocument* doc, string subRoot, OutputSink &sink, NodeIndex &index) {
     // Boolean used to start the tree-walker
     bool valid = true;
     // Variable used to keep track of the current element's level in the tree. 
@@ -223,17 +332,11 @@ void treeWalker(DOMDocument* doc, string subRoot) {
         rootElem = doc->getDocumentElement();
     } else {
 
-        // Confirms that the element provided exists in the tree
-        const char* xInput = subRoot.c_str();
-        XMLCh* xSubRoot = XMLString::transcode(xInput);
-        DOMNodeList * nodeList = doc->getElementsByTagName(xSubRoot);
-
-        if (nodeList->getLength() != 0) {
-            // Assigns the rootElem variable to the provided element
-            DOMNode * subTreeRootNode = nodeList->item(0);
-            rootElem = dynamic_cast<DOMElement*> (subTreeRootNode);
+        // Confirms that the element provided exists in the tree, and assigns
+        // the rootElem variable to it
+        rootElem = index.find(subRoot);
 
-        } else {
+        if (rootElem == NULL) {
             // If no matching element is found, the user is informed and the 
             // tree-walker will not start
             cout << "No matching node named '" << subRoot << "' found." << endl;
@@ -243,14 +346,12 @@ void treeWalker(DOMDocument* doc, string subRoot) {
 
     //If the sub-tree has a valid root, the tree-walker will start
     if (valid) {
-        cout << endl;
+        sink.write('\n');
 
         //  Uses root element and uses it to create the tree walker object. The
         //  walker's filter is set to show all nodes. 
         DOMTreeWalker *walker = doc->createTreeWalker(rootElem, DOMNodeFilter::SHOW_ALL, NULL, true);
 
-        // Placeholder variable used to store tag names and content. Passed to transcode. 
-        const XMLCh * tag = NULL;
         //Grabs the walker root to begin traversing the tree. 
         DOMNode * node = walker->getRoot();
         // Placholder node for an element that is being analyzed.
@@ -268,9 +369,7 @@ void treeWalker(DOMDocument* doc, string subRoot) {
                     // are also displayed.
                 case DOMNode::ELEMENT_NODE:
 
-                    for (int i = 0; i < level; i++) {
-                        cout << "   ";
-                    }
+                    sink.indent(level);
 
                     // Checks if the current node is the root. If not, the node 
                     // is cast as a DOMElement
@@ -281,10 +380,10 @@ void treeWalker(DOMDocument* doc, string subRoot) {
                     }
 
                     // Prints the current element name
-                    tag = elemNode->getTagName();
-                    cout << XMLString::transcode(tag) << ": ";
-                    if (elemNode->getFirstChild()->getNodeType() != 3) {
-                        cout << endl;
+                    sink.write(elemNode->getTagName());
+                    sink.write(": ", 2);
+                    if (elemNode->getFirstChild() == NULL || elemNode->getFirstChild()->getNodeType() != 3) {
+                        sink.write('\n');
                     }
 
                     break;
@@ -293,20 +392,20 @@ void treeWalker(DOMDocument* doc, string subRoot) {
                     // content, its text is displayed. 
                 case DOMNode::TEXT_NODE:
 
-                    tag = node->getTextContent();
-                    cout << XMLString::transcode(tag) << endl;
+                    sink.write(node->getTextContent());
+                    sink.write('\n');
 
                     // After the content is displayed, checks if the content's parent
                     // has attributes. If so, they are displayed.
                     if (node->getParentNode()->hasAttributes()) {
                         DOMNamedNodeMap* attributes = node->getParentNode()->getAttributes();
-                        displayAttributes(attributes, level);
+                        displayAttributes(attributes, level, sink);
                     }
 
                     break;
 
                 default:
-                    cout << "ERROR!" << endl;
+                    sink.write("ERROR!\n", 7);
                     break;
             }
 
@@ -325,6 +424,50 @@ void treeWalker(DOMDocument* doc, string subRoot) {
 
             // When the above algorithm returns to the root, the loop ends. 
         } while (walker->getCurrentNode() != rootElem);
-        cout << endl;
+        sink.write('\n');
+
+        walker->release();
+    }
+
+    // Everything that was collected is written once the walk is complete. 
+    sink.flush();
+    return valid;
+}
+
+/**
+ * Function to export the DOM structure to an external text file, in the same
+ * list format as the 'print list' command. 
+ * @param doc - The DOMDocument that is to be exported.
+ * @param fileName - The file name specified by the user
+ * @param subRoot - The element or path whose subtree is to be exported, default is the root
+ * @param sink - The buffered output used to write the file. 
+ * @param index - The lookup index used to find the subtree root.
+ */
+void exportList(DOMDocument* doc, string fileName, string subRoot, OutputSink &sink, NodeIndex &index) {
+    //Ensures that a file name was entered by the user
+    if (fileName.empty()) {
+        cout << "No file name was given. Enter a file name for the tree." << endl;
+        getline(cin, fileName);
+        cin.ignore(-1);
+    }
+
+    //Creates a file path in the 'dist' folder from the file name
+    fileName = "dist/" + fileName + ".txt";
+
+    if (!sink.open(fileName)) {
+        cout << "Could not create the file '" << fileName << "'." << endl;
+        return;
+    }
+
+    bool valid = treeWalker(doc, subRoot, sink, index);
+    sink.close();
+
+    // Nothing is kept if the subtree root was not found. 
+    if (!valid) {
+        remove(fileName.c_str());
+        return;
     }
+
+    // Informs the user that the tree has been saved
+    cout << "Exported the DOM tree list to '" << fileName << "'. " << endl;
 }
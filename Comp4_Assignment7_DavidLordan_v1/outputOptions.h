@@ -31,26 +31,59 @@
 #include <string.h>
 #include <stdlib.h>
 
+#include "OutputSink.h"
+#include "OutputContext.h"
+#include "NodeIndex.h"
+#include "BackgroundExport.h"
+
 
 /* Uses the Xerces and std namespace.*/
 XERCES_CPP_NAMESPACE_USE
         using namespace std;
 
 /**
- * Function to export the DOM structure to an external XML file. This implementation
- * is virtually identical to the 'print' function which user the serializer.
+ * Function to export the DOM structure to an external XML file. The tree is written
+ * by the shell's output context, which is reused for every export.
+ * @param doc - The DOMDocument that is to be exported.
+ * @param fileName - The XML file name specified by the user
+ * @param context - The output context used to write the file. 
+ * @param compression - The way the file is compressed, which adds to its name. Defaults to none.
+ */
+void exportTree(DOMDocument* doc, string fileName, OutputContext &context, Compression compression = NO_COMPRESSION);
+
+/**
+ * Function to export the DOM structure to an external XML file on a worker thread,
+ * so the shell can keep changing the tree while it is written. The file holds the
+ * tree as it was when this function was called. Documents which only the Xerces
+ * serializer can write, such as one read in another encoding than UTF-8, are
+ * exported with 'exportTree' instead.
  * @param doc - The DOMDocument that is to be exported.
  * @param fileName - The XML file name specified by the user
+ * @param exporter - The background export which writes the file. 
+ * @param context - The output context used if the tree cannot be written in the background. 
  */
-void exportTree(DOMDocument* doc, string fileName);
+void exportInBackground(DOMDocument* doc, string fileName, BackgroundExport &exporter, OutputContext &context);
+
+/**
+ * Function to export the DOM structure to an external XML file on several threads,
+ * each writing a share of the root's children. Trees which cannot be split this way
+ * are exported with 'exportTree' instead.
+ * @param doc - The DOMDocument that is to be exported.
+ * @param fileName - The XML file name specified by the user
+ * @param threadCount - The number of threads specified by the user, or empty for one per core.
+ * @param context - The output context used if the tree cannot be split. 
+ */
+void exportParallel(DOMDocument* doc, string fileName, string threadCount, OutputContext &context);
 
 /**
  * Function to print the tree in an XML format. If an element is provided, the
  * subtree from that element will be printed.
  * @param doc - The document whos structure is to be printed
- * @param subRoot - The element whose subtree is to be printed, default is the root
+ * @param subRoot - The element or path whose subtree is to be printed, default is the root
+ * @param context - The output context to which the tree is written. 
+ * @param index - The lookup index used to find the subtree root.
  */
-void printTree(DOMDocument* doc, string parentName);
+void printTree(DOMDocument* doc, string subRoot, OutputContext &context, NodeIndex &index);
 
 /**
  * Function to display all of the basic commands, thier uses and syntax
@@ -64,9 +97,23 @@ void showHelp();
  * user may provide an element name whose subtree will be printed. By default the
  * entire tree is displayed
  * @param doc - The DOM document containing the DOM structure. 
- * @param subRoot - The element whose subtree is to be displayed
+ * @param subRoot - The element or path whose subtree is to be displayed
+ * @param sink - The buffered output to which the tree is written. 
+ * @param index - The lookup index used to find the subtree root.
+ * @return - False if no element matching 'subRoot' was found.
+ */
+bool treeWalker(DOMDocument* doc, string subRoot, OutputSink &sink, NodeIndex &index);
+
+/**
+ * Function to export the DOM structure to an external text file, in the same
+ * list format as the 'print list' command. 
+ * @param doc - The DOMDocument that is to be exported.
+ * @param fileName - The file name specified by the user
+ * @param subRoot - The element or path whose subtree is to be exported, default is the root
+ * @param sink - The buffered output used to write the file. 
+ * @param index - The lookup index used to find the subtree root.
  */
-void treeWalker(DOMDocument* doc, string subRoot);
+void exportList(DOMDocument* doc, string fileName, string subRoot, OutputSink &sink, NodeIndex &index);
 
 #endif	/* OUTPUTOPTIONS_H */
 
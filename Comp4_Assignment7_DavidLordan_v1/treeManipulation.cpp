@@ -22,7 +22,10 @@
  export function*/
 #include <string.h>
 #include <stdlib.h>
+#include <malloc.h>
+#include <chrono>
 #include "treeManipulation.h"
+#include "ArenaMemoryManager.h"
 
 /* Includes the boost regular expressions library*/
 #include <boost/regex.hpp>
@@ -47,18 +50,25 @@ XMLCh* X(string input) {
  * @param doc - The DOMDocument to which the root will be added.
  * @param rootName - The user's name for the root element. 
  * @param rootContent - Option content that the user may add to the root. 
+ * @param index - The lookup index, kept up to date.
+ * @param journal - The journal in which the change is recorded.
  */
-void addRoot(DOMDocument* &doc, string rootName, string rootContent) {
+void addRoot(DOMDocument* doc, string rootName, string rootContent, NodeIndex &index, Journal &journal) {
 
     //Checks if there is already a root.
     if (!doc->getFirstChild()) {
 
-        // Replaces the current doc with a new doc with a specified root. 
-        doc = doc->getImplementation()->createDocument(0, X(rootName), 0);
+        // Adds the root to the current doc, so that it is journaled like any other
+        // element and the nodes of a removed root are still released by the journal.
+        DOMElement* rootElem = doc->createElement(X(rootName));
+        doc->appendChild(rootElem);
 
         //Adds optional content.
         DOMText* txtNode = doc->createTextNode(X(rootContent));
-        doc->getFirstChild()->appendChild(txtNode);
+        rootElem->appendChild(txtNode);
+
+        index.addElement(rootElem);
+        journal.recordInsert(rootElem);
 
         //Informs the user that a  root has been created. 
         cout << "Created root '" << rootName << "'";
@@ -81,30 +91,50 @@ void addRoot(DOMDocument* &doc, string rootName, string rootContent) {
  * @param oldNameOrParent - The element to be renamed, or the parent of the attribute to be renamed. 
  * @param newNameOrAtt - The user provided new name of an element, or the name of the attribute to rename.
  * @param newContentOrNewAtt - Optional new content to be added, or the new name of the specified attribute.
+ * @param index - The lookup index used to find the element, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
  */
-void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, string newNameOrAtt, string newContentOrNewAtt) {
+void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, string newNameOrAtt, string newContentOrNewAtt, NodeIndex &index, Journal &journal) {
 
-    // Creates a list of nodes under the specified name.
-    DOMNodeList * nodeList = doc->getElementsByTagName(X(oldNameOrParent));
+    // Finds the first element with the specified name.
+    DOMElement * oldElem = index.find(oldNameOrParent);
 
     // Confirms that the specified node exists. 
-    if (nodeList->getLength() != 0) {
-        DOMNode * oldNode = nodeList->item(0);
+    if (oldElem != NULL) {
+        DOMNode * oldNode = oldElem;
 
         if (selector == "element") {
 
-            // Renames the node to the new name specified by the user. 
-            doc->renameNode(oldNode, 0, X(newNameOrAtt));
+            // Renames the node to the new name specified by the user. The element
+            // is filed under its new name in the index, and any elements inside it
+            // are taken out since its content is replaced below.
+            index.removeSubtree(oldNode);
+            XMLCh* oldName = XMLString::replicate(oldNode->getNodeName());
+            oldNode = doc->renameNode(oldNode, 0, X(newNameOrAtt));
+            journal.recordRename(oldNode, oldName);
+            XMLString::release(&oldName);
 
             // Checks if the user wants to add new content, if not, the old content is preserved.
+            XMLCh* xNewContentOrVal;
             if (newContentOrNewAtt.empty()) {
-                const XMLCh* xNewContentOrVal = oldNode->getTextContent();
-                oldNode->setTextContent(xNewContentOrVal);
+                xNewContentOrVal = XMLString::replicate(oldNode->getTextContent());
             } else {
-                // Updates the element content. 
-                oldNode->setTextContent(X(newContentOrNewAtt));
+                xNewContentOrVal = X(newContentOrNewAtt);
             }
 
+            // Takes out the old content, which is kept by the journal, and 
+            // updates the element content.
+            while (DOMNode * child = oldNode->getFirstChild()) {
+                journal.recordRemove(child);
+                oldNode->removeChild(child);
+            }
+            oldNode->setTextContent(xNewContentOrVal);
+            XMLString::release(&xNewContentOrVal);
+            if (oldNode->getFirstChild() != NULL) {
+                journal.recordInsert(oldNode->getFirstChild());
+            }
+            index.addElement(dynamic_cast<DOMElement*> (oldNode));
+
 
             // Informs the user of the updates. 
             cout << "Renamed the element '" << oldNameOrParent << "' to '" << newNameOrAtt << "'";
@@ -121,17 +151,26 @@ void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, stri
                 cout << "The element '" << oldNameOrParent << "' does not have any attributes." << endl;
             } else {
 
+                // The names are transcoded once for the lookup, the journal and the rename.
+                XMLCh* xOldAtt = X(newNameOrAtt);
+                XMLCh* xNewAtt = X(newContentOrNewAtt);
+
                 // Confirms that parent element has the specified attribute. 
                 DOMNamedNodeMap * attributes = oldNode->getAttributes();
-                if (DOMNode * attNode = attributes->getNamedItem(X(newNameOrAtt))) {
+                if (DOMNode * attNode = attributes->getNamedItem(xOldAtt)) {
 
                     // Renames the old attribute and prompts the user for the new attribute value. 
-                    doc->renameNode(attNode, 0, X(newContentOrNewAtt));
+                    journal.recordAttribute(oldElem, xOldAtt);
+                    journal.recordAttribute(oldElem, xNewAtt);
+                    doc->renameNode(attNode, 0, xNewAtt);
                     cout << "Please enter a value for the new attribute: " << endl;
                     string input;
                     getline(cin, input);
                     cin.ignore(-1);
-                    attNode->setTextContent(X(input));
+                    XMLCh* xInput = X(input);
+                    attNode->setTextContent(xInput);
+                    XMLString::release(&xInput);
+                    journal.addInput(input);
 
                     // Informs the user of the updates to the tree.
                     cout << "Attribute '" << newNameOrAtt << "' belonging to '" << oldNameOrParent
@@ -142,6 +181,8 @@ void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, stri
                     // Informs the user that the specified parent does not have a matching attribute.
                     cout << "The element '" << oldNameOrParent << "' does not have an attribute named '" << newNameOrAtt << "'. " << endl;
                 }
+                XMLString::release(&xOldAtt);
+                XMLString::release(&xNewAtt);
             }
         }
     } else {
@@ -157,16 +198,14 @@ void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, stri
  * @param parentName - The parent to which the new node will be attached. 
  * @param childOrAtt - The name of the new node. 
  * @param contentOrVal - The content or value of the new node. 
+ * @param index - The lookup index used to find the parent, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
  */
-void addNode(DOMDocument* &doc, string addType, string parentName, string childOrAtt, string contentOrVal) {
+void addNode(DOMDocument* &doc, string addType, string parentName, string childOrAtt, string contentOrVal, NodeIndex &index, Journal &journal) {
 
     //Confirms that the specified parent exists. 
-    DOMNodeList * nodeList = doc->getElementsByTagName(X(parentName));
-    if (nodeList->getLength() != 0) {
-        DOMNode * parentNode = nodeList->item(0);
-
-        // Casts the matching node as a DOMElement so that it may be more easily manipulated. 
-        DOMElement * parentElem = dynamic_cast<DOMElement*> (parentNode);
+    DOMElement * parentElem = index.find(parentName);
+    if (parentElem != NULL) {
 
 
         if (addType == "element") {
@@ -176,6 +215,8 @@ void addNode(DOMDocument* &doc, string addType, string parentName, string childO
 
             DOMText* txtNode = doc->createTextNode(X(contentOrVal));
             childElem->appendChild(txtNode);
+            index.addElement(childElem);
+            journal.recordInsert(childElem);
 
 
             // Informs the user of the updates to the tree.
@@ -189,7 +230,12 @@ void addNode(DOMDocument* &doc, string addType, string parentName, string childO
 
         } else if (addType == "attribute") {
             // Adds the new attribute to the specified parent. 
-            parentElem->setAttribute(X(childOrAtt), X(contentOrVal));
+            XMLCh* xName = X(childOrAtt);
+            XMLCh* xValue = X(contentOrVal);
+            journal.recordAttribute(parentElem, xName);
+            parentElem->setAttribute(xName, xValue);
+            XMLString::release(&xName);
+            XMLString::release(&xValue);
 
             // Informs the user of the updates to the tree.
             cout << "Added the attribute '" << childOrAtt << "' to parent '" << parentName << "'";
@@ -222,22 +268,25 @@ void addNode(DOMDocument* &doc, string addType, string parentName, string childO
  * @param removeType - A selector for whether or not a element or attribute is being removed. 
  * @param parentName - The parent of the node to be removed.
  * @param childOrAtt - The element or attribute name which is to be removed. 
+ * @param index - The lookup index used to find the nodes, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
  */
-void removeNode(DOMDocument * &doc, string removeType, string parentName, string childOrAtt) {
+void removeNode(DOMDocument * &doc, string removeType, string parentName, string childOrAtt, NodeIndex &index, Journal &journal) {
     //Checks if the user is attempting to remove the root. 
     if (parentName == "null") {
 
         if (removeType == "element") {
 
             //Gets the root node
-            DOMNode * node = doc->getFirstChild();
-            DOMElement * rootNode = dynamic_cast<DOMElement*> (node);
+            DOMElement * rootNode = doc->getDocumentElement();
 
             //Checks that the root node name matches the name given by the user.
-            if (XMLString::transcode(rootNode->getTagName()) == childOrAtt) {
+            if (rootNode != NULL && XMLString::transcode(rootNode->getTagName()) == childOrAtt) {
 
                 //Removes the root and informs the user.
+                journal.recordRemove(rootNode);
                 doc->removeChild(rootNode);
+                index.clear();
                 cout << "Removed root node '" << childOrAtt << "'. Tree is now empty." << endl;
             } else {
                 // If the specified name does not match the root name, the user is informed
@@ -253,21 +302,20 @@ void removeNode(DOMDocument * &doc, string removeType, string parentName, string
 
     } else {
         //Checks that the specified parent exists
-        DOMNodeList * nodeList = doc->getElementsByTagName(X(parentName));
+        DOMElement * parentElem = index.find(parentName);
 
-        if (nodeList->getLength() != 0) {
-            //Gets the parent node
-            DOMNode * parentNode = nodeList->item(0);
-            DOMElement * parentElem = dynamic_cast<DOMElement*> (parentNode);
+        if (parentElem != NULL) {
 
             if (removeType == "element") {
-                // Checks that the element to remove exists as a child of the parent. 
-                nodeList = parentElem->getElementsByTagName(X(childOrAtt));
-                if (nodeList->getLength() != 0) {
+                // Checks that the element to remove exists below the parent. 
+                DOMElement * childElem = index.findBelow(childOrAtt, parentElem);
+                if (childElem != NULL) {
 
-                    // Removes the specified node and informs the user.
-                    DOMNode * childNode = nodeList->item(0);
-                    parentElem->removeChild(childNode);
+                    // Removes the specified node and informs the user. The node
+                    // may be further down the tree than a direct child.
+                    index.removeSubtree(childElem);
+                    journal.recordRemove(childElem);
+                    childElem->getParentNode()->removeChild(childElem);
 
                     cout << "Child element '" << childOrAtt << "' belonging to '"
                             << parentName << "' has been removed." << endl;
@@ -281,11 +329,13 @@ void removeNode(DOMDocument * &doc, string removeType, string parentName, string
             } else if (removeType == "attribute") {
 
                 // Checks that the specified attribute exists and belongs to the specified parent
+                XMLCh* xName = X(childOrAtt);
                 DOMNamedNodeMap * nodeMap = parentElem->getAttributes();
-                if (nodeMap->getNamedItem(X(childOrAtt))) {
+                if (nodeMap->getNamedItem(xName)) {
 
                     // Removes the attribute and informs the user. 
-                    parentElem->removeAttribute(X(childOrAtt));
+                    journal.recordAttribute(parentElem, xName);
+                    parentElem->removeAttribute(xName);
 
                     cout << "The attribute '" << childOrAtt << "' belonging to parent '"
                             << parentName << "' has been removed." << endl;
@@ -294,6 +344,7 @@ void removeNode(DOMDocument * &doc, string removeType, string parentName, string
                     // If no matching attribute is found, the user is informed. 
                     cout << "The element '" << parentName << "' does not have an attribute named '" << childOrAtt << "' ." << endl;
                 }
+                XMLString::release(&xName);
 
             } else {
                 //addType not element or attribute
@@ -305,4 +356,240 @@ void removeNode(DOMDocument * &doc, string removeType, string parentName, string
             cout << "No matching node named '" << parentName << "' found. Please try again." << endl;
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * A function to add a new element or attribute to every element matching a
+ * name or path, finding them all with a single lookup.
+ * @param doc - The DOM document to which the new nodes will be added. 
+ * @param addType - A selector for specifying whether elements or attributes are to be added. 
+ * @param parentPath - The name of, or path to, the elements to which the new nodes are attached. 
+ * @param childOrAtt - The name of the new nodes. 
+ * @param contentOrVal - The content or value of the new nodes. 
+ * @param index - The lookup index used to find the parents, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
+ */
+void addAll(DOMDocument* &doc, string addType, string parentPath, string childOrAtt, string contentOrVal, NodeIndex &index, Journal &journal) {
+
+    if (childOrAtt.empty()) {
+        cout << "Must specify the name of the new " << addType << "." << endl;
+        return;
+    }
+
+    vector<DOMElement*> parents;
+    index.findAll(parentPath, parents);
+
+    if (parents.empty()) {
+        cout << "No matching node named '" << parentPath << "' found." << endl;
+        return;
+    }
+
+    // The names are only transcoded once for every parent.
+    XMLCh* xName = X(childOrAtt);
+    XMLCh* xValue = X(contentOrVal);
+
+    // The new elements are sorted into the index in one pass once they have all been added.
+    index.deferUpdates();
+
+    for (vector<DOMElement*>::iterator parent = parents.begin(); parent != parents.end(); ++parent) {
+        if (addType == "element") {
+            DOMElement* childElem = doc->createElement(xName);
+            childElem->appendChild(doc->createTextNode(xValue));
+            (*parent)->appendChild(childElem);
+            index.addElement(childElem);
+            journal.recordInsert(childElem);
+        } else {
+            journal.recordAttribute(*parent, xName);
+            (*parent)->setAttribute(xName, xValue);
+        }
+    }
+
+    index.applyUpdates();
+    XMLString::release(&xName);
+    XMLString::release(&xValue);
+
+    // Informs the user of the updates to the tree.
+    cout << "Added the " << addType << " '" << childOrAtt << "' to " << parents.size()
+            << " elements matching '" << parentPath << "'." << endl;
+}
+
+/**
+ * Function to remove every element matching a name or path, or an attribute
+ * from every matching element. 
+ * @param doc - The DOMDocument which is being manipulated.
+ * @param removeType - A selector for whether elements or attributes are being removed. 
+ * @param path - The name of, or path to, the elements to remove or whose attribute is removed.
+ * @param attName - The name of the attribute to remove. 
+ * @param index - The lookup index used to find the nodes, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
+ */
+void removeAll(DOMDocument* &doc, string removeType, string path, string attName, NodeIndex &index, Journal &journal) {
+
+    vector<DOMElement*> matches;
+    index.findAll(path, matches);
+
+    if (matches.empty()) {
+        cout << "No matching node named '" << path << "' found." << endl;
+        return;
+    }
+
+    size_t removed = 0;
+
+    if (removeType == "element") {
+        index.deferUpdates();
+
+        // Removed from last to first, so an element inside another match is
+        // removed from its own parent before the outer match is removed.
+        for (vector<DOMElement*>::reverse_iterator match = matches.rbegin(); match != matches.rend(); ++match) {
+
+            // The root can only be removed with the 'null' parent.
+            if (*match == doc->getDocumentElement()) {
+                cout << "The root is not removed. Use 'remove element null' to remove the whole tree." << endl;
+                continue;
+            }
+            index.removeSubtree(*match);
+            journal.recordRemove(*match);
+            (*match)->getParentNode()->removeChild(*match);
+            removed++;
+        }
+
+        index.applyUpdates();
+        cout << "Removed " << removed << " elements matching '" << path << "'." << endl;
+
+    } else {
+        XMLCh* xName = X(attName);
+
+        for (vector<DOMElement*>::iterator match = matches.begin(); match != matches.end(); ++match) {
+            if ((*match)->getAttributeNode(xName) != NULL) {
+                journal.recordAttribute(*match, xName);
+                (*match)->removeAttribute(xName);
+                removed++;
+            }
+        }
+
+        XMLString::release(&xName);
+        cout << "Removed the attribute '" << attName << "' from " << removed << " of the "
+                << matches.size() << " elements matching '" << path << "'." << endl;
+    }
+}
+
+/**
+ * A function to rename every element matching a name or path, or an attribute
+ * of every matching element. Unlike 'renameNode' the content and attribute
+ * values are kept as they are.
+ * @param doc - The DOMDocument which is to be manipulated. 
+ * @param selector - Whether elements or attributes are being renamed. 
+ * @param path - The name of, or path to, the elements to rename or whose attribute is renamed.
+ * @param newNameOrAtt - The new name of the elements, or the name of the attribute to rename.
+ * @param newAtt - The new name of the attribute.
+ * @param index - The lookup index used to find the elements, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
+ */
+void renameAll(DOMDocument* &doc, string selector, string path, string newNameOrAtt, string newAtt, NodeIndex &index, Journal &journal) {
+
+    string newName = (selector == "element") ? newNameOrAtt : newAtt;
+    if (newName.empty()) {
+        cout << "Must specify the new name of the " << selector << "." << endl;
+        return;
+    }
+
+    vector<DOMElement*> matches;
+    index.findAll(path, matches);
+
+    if (matches.empty()) {
+        cout << "No matching node named '" << path << "' found." << endl;
+        return;
+    }
+
+    XMLCh* xNewName = X(newName);
+    size_t renamed = 0;
+
+    if (selector == "element") {
+        // Each element is filed under its new name in the index in one pass
+        // once they have all been renamed.
+        index.deferUpdates();
+
+        for (vector<DOMElement*>::iterator match = matches.begin(); match != matches.end(); ++match) {
+            index.removeElement(*match);
+            XMLCh* oldName = XMLString::replicate((*match)->getTagName());
+            DOMNode* renamedNode = doc->renameNode(*match, 0, xNewName);
+            index.addElement(dynamic_cast<DOMElement*> (renamedNode));
+            journal.recordRename(renamedNode, oldName);
+            XMLString::release(&oldName);
+            renamed++;
+        }
+
+        index.applyUpdates();
+        cout << "Renamed " << renamed << " elements matching '" << path << "' to '" << newName << "'." << endl;
+
+    } else {
+        XMLCh* xOldName = X(newNameOrAtt);
+
+        // The value is copied to an attribute with the new name, which replaces
+        // any attribute already using that name.
+        for (vector<DOMElement*>::iterator match = matches.begin(); match != matches.end(); ++match) {
+            DOMAttr* attNode = (*match)->getAttributeNode(xOldName);
+            if (attNode != NULL) {
+                XMLCh* value = XMLString::replicate(attNode->getValue());
+                journal.recordAttribute(*match, xOldName);
+                journal.recordAttribute(*match, xNewName);
+                (*match)->removeAttribute(xOldName);
+                (*match)->setAttribute(xNewName, value);
+                XMLString::release(&value);
+                renamed++;
+            }
+        }
+
+        XMLString::release(&xOldName);
+        cout << "Renamed the attribute '" << newNameOrAtt << "' to '" << newName << "' on " << renamed
+                << " of the " << matches.size() << " elements matching '" << path << "'." << endl;
+    }
+
+    XMLString::release(&xNewName);
+}
+
+/**
+ * Helper function to find the number of bytes allocated and not yet freed, from
+ * the arena if Xerces is using it and from the global heap otherwise.
+ * @return - The number of bytes in use.
+ */
+static size_t memoryInUse() {
+    ArenaMemoryManager* arena = dynamic_cast<ArenaMemoryManager*> (XMLPlatformUtils::fgMemoryManager);
+    if (arena != NULL) {
+        return arena->bytesInUse();
+    }
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+/**
+ * A function to copy the tree into a new document and release the old one, giving
+ * back the memory Xerces keeps for removed nodes, and reports how much was reclaimed.
+ * @param doc - The DOMDocument which is replaced by its copy. Passed by reference.
+ * @param index - The lookup index, rebuilt for the new document.
+ */
+void compactTree(DOMDocument* &doc, NodeIndex &index) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    size_t before = memoryInUse();
+
+    // Every top level node is copied, so comments and processing instructions
+    // around the root are kept along with it.
+    DOMDocument* newDoc = doc->getImplementation()->createDocument();
+    newDoc->setXmlVersion(doc->getXmlVersion());
+    newDoc->setXmlStandalone(doc->getXmlStandalone());
+    for (DOMNode* child = doc->getFirstChild(); child != NULL; child = child->getNextSibling()) {
+        newDoc->appendChild(newDoc->importNode(child, true));
+    }
+
+    // Releasing the old document frees its nodes, along with those which were
+    // removed and any kept by the journal.
+    doc->release();
+    doc = newDoc;
+    index.build(doc);
+
+    size_t after = memoryInUse();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "Compacted the tree in " << elapsed.count() << " seconds, reclaiming "
+            << ((before > after ? before - after : 0) / 1024) << " KB. Changes made before "
+            "the compaction can no longer be undone." << endl;
+}
@@ -26,6 +26,8 @@
 #include <iostream>
 #include <string.h>
 #include <stdlib.h>
+#include "NodeIndex.h"
+#include "Journal.h"
 
 /* Uses the Xerces and std namespace.*/
 XERCES_CPP_NAMESPACE_USE
@@ -37,8 +39,10 @@ XERCES_CPP_NAMESPACE_USE
  * @param doc - The DOMDocument to which the root will be added.
  * @param rootName - The user's name for the root element. 
  * @param rootContent - Option content that the user may add to the root. 
+ * @param index - The lookup index, kept up to date.
+ * @param journal - The journal in which the change is recorded.
  */
-void addRoot(DOMDocument* &doc, string rootName, string rootContent);
+void addRoot(DOMDocument* doc, string rootName, string rootContent, NodeIndex &index, Journal &journal);
 
 /**
  * A function that allows the user to rename an existing element or attribute. 
@@ -47,8 +51,10 @@ void addRoot(DOMDocument* &doc, string rootName, string rootContent);
  * @param oldNameOrParent - The element to be renamed, or the parent of the attribute to be renamed. 
  * @param newNameOrAtt - The user provided new name of an element, or the name of the attribute to rename.
  * @param newContentOrNewAtt - Optional new content to be added, or the new name of the specified attribute.
+ * @param index - The lookup index used to find the element, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
  */
-void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, string newNameOrAtt, string newContentOrNewAtt);
+void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, string newNameOrAtt, string newContentOrNewAtt, NodeIndex &index, Journal &journal);
 
 /**
  * A function to create and add a new node to the DOM structure. 
@@ -57,8 +63,10 @@ void renameNode(DOMDocument* &doc, string selector, string oldNameOrParent, stri
  * @param parentName - The parent to which the new node will be attached. 
  * @param childOrAtt - The name of the new node. 
  * @param contentOrVal - The content or value of the new node. 
+ * @param index - The lookup index used to find the parent, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
  */
-void addNode(DOMDocument* &doc, string addType, string parentName, string childOrAtt, string contentOrVal);
+void addNode(DOMDocument* &doc, string addType, string parentName, string childOrAtt, string contentOrVal, NodeIndex &index, Journal &journal);
 
 /**
  * Function to remove a user specified element or attribute from the DOM structure. 
@@ -66,8 +74,57 @@ void addNode(DOMDocument* &doc, string addType, string parentName, string childO
  * @param removeType - A selector for whether or not a element or attribute is being removed. 
  * @param parentName - The parent of the node to be removed.
  * @param childOrAtt - The element or attribute name which is to be removed. 
+ * @param index - The lookup index used to find the nodes, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
  */
-void removeNode(DOMDocument * &doc, string removeType, string parentName, string childOrAtt);
+void removeNode(DOMDocument * &doc, string removeType, string parentName, string childOrAtt, NodeIndex &index, Journal &journal);
+
+/**
+ * A function to add a new element or attribute to every element matching a
+ * name or path, finding them all with a single lookup.
+ * @param doc - The DOM document to which the new nodes will be added. 
+ * @param addType - A selector for specifying whether elements or attributes are to be added. 
+ * @param parentPath - The name of, or path to, the elements to which the new nodes are attached. 
+ * @param childOrAtt - The name of the new nodes. 
+ * @param contentOrVal - The content or value of the new nodes. 
+ * @param index - The lookup index used to find the parents, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
+ */
+void addAll(DOMDocument* &doc, string addType, string parentPath, string childOrAtt, string contentOrVal, NodeIndex &index, Journal &journal);
+
+/**
+ * Function to remove every element matching a name or path, or an attribute
+ * from every matching element. 
+ * @param doc - The DOMDocument which is being manipulated.
+ * @param removeType - A selector for whether elements or attributes are being removed. 
+ * @param path - The name of, or path to, the elements to remove or whose attribute is removed.
+ * @param attName - The name of the attribute to remove. 
+ * @param index - The lookup index used to find the nodes, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
+ */
+void removeAll(DOMDocument* &doc, string removeType, string path, string attName, NodeIndex &index, Journal &journal);
+
+/**
+ * A function to rename every element matching a name or path, or an attribute
+ * of every matching element. Unlike 'renameNode' the content and attribute
+ * values are kept as they are.
+ * @param doc - The DOMDocument which is to be manipulated. 
+ * @param selector - Whether elements or attributes are being renamed. 
+ * @param path - The name of, or path to, the elements to rename or whose attribute is renamed.
+ * @param newNameOrAtt - The new name of the elements, or the name of the attribute to rename.
+ * @param newAtt - The new name of the attribute.
+ * @param index - The lookup index used to find the elements, kept up to date.
+ * @param journal - The journal in which the changes are recorded.
+ */
+void renameAll(DOMDocument* &doc, string selector, string path, string newNameOrAtt, string newAtt, NodeIndex &index, Journal &journal);
+
+/**
+ * A function to copy the tree into a new document and release the old one, giving
+ * back the memory Xerces keeps for removed nodes, and reports how much was reclaimed.
+ * @param doc - The DOMDocument which is replaced by its copy. Passed by reference.
+ * @param index - The lookup index, rebuilt for the new document.
+ */
+void compactTree(DOMDocument* &doc, NodeIndex &index);
 
 #endif	/* TREEMANIPULATION_H */
 